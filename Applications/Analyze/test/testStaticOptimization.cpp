@@ -25,6 +25,7 @@
 #include <OpenSim/Simulation/Model/Model.h>
 #include <OpenSim/Tools/AnalyzeTool.h>
 #include <OpenSim/Analyses/StaticOptimization.h>
+#include <OpenSim/Analyses/StaticOptimizationTarget.h>
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
 
 using namespace OpenSim;
@@ -37,6 +38,9 @@ using namespace std;
         Millard2012AccelerationMuscle
 */
 void testArm26(const string& muscleModelClassName, double atol, double ftol);
+void testArm26QuadraticProgram();
+void testArm26Parallel();
+void testArm26ConstraintMatrix();
 
 int main()
 {
@@ -64,6 +68,31 @@ int main()
 			failures.push_back("testArm26_"+muscleModelNames[i]);
 		}
 	}
+
+	try { // the quadratic program solver must agree with IPOPT
+		testArm26QuadraticProgram();
+	}
+	catch (const std::exception& e) {
+		cout << e.what() <<endl; 
+		failures.push_back("testArm26QuadraticProgram");
+	}
+
+	try { // solving the frames on several threads must agree with one
+		testArm26Parallel();
+	}
+	catch (const std::exception& e) {
+		cout << e.what() <<endl; 
+		failures.push_back("testArm26Parallel");
+	}
+
+	try { // the constraint matrix from the actuators' generalized forces
+		  // must agree with the one from perturbed accelerations
+		testArm26ConstraintMatrix();
+	}
+	catch (const std::exception& e) {
+		cout << e.what() <<endl; 
+		failures.push_back("testArm26ConstraintMatrix");
+	}
   
     if (!failures.empty()) {
         cout << "Done, with failure(s): " << failures << endl;
@@ -156,4 +185,147 @@ void testArm26(const string& muscleModelClassName, double actTol, double forceTo
  
 	cout << resultsDir << ": testArm26 with bounds passed" << endl;
 	cout << "=============================================================\n" << endl;
-}
\ No newline at end of file
+}
+
+void testArm26QuadraticProgram()
+{
+	Object::renameType( "Thelen2003Muscle", "Thelen2003Muscle");
+
+	cout << "==============================================" << endl;
+	cout << "       Quadratic program solver" << endl;
+	cout << "==============================================" << endl;
+
+	string resultsDir = "Results_QuadraticProgram";
+	AnalyzeTool analyze("arm26_Setup_StaticOptimization.xml");
+	analyze.setResultsDir(resultsDir);
+	StaticOptimization& so = dynamic_cast<StaticOptimization&>(
+		analyze.getAnalysisSet().get("StaticOptimization"));
+	so.setOptimizerAlgorithm("qp");
+	analyze.run();
+
+	// Compare with the IPOPT solution computed by testArm26() for the same
+	// muscle model.
+	Storage activations(resultsDir+"/arm26_StaticOptimization_activation.sto");
+	Storage ipoptActivations(
+		"Results_Thelen2003Muscle/arm26_StaticOptimization_activation.sto");
+	CHECK_STORAGE_AGAINST_STANDARD(activations, ipoptActivations, 
+		Array<double>(0.005, 6), __FILE__, __LINE__, 
+		"Arm26 activations with the quadratic program solver failed");
+
+	Storage forces(resultsDir+"/arm26_StaticOptimization_force.sto");
+	Storage ipoptForces(
+		"Results_Thelen2003Muscle/arm26_StaticOptimization_force.sto");
+	CHECK_STORAGE_AGAINST_STANDARD(forces, ipoptForces, 
+		Array<double>(0.5, 6), __FILE__, __LINE__, 
+		"Arm26 forces with the quadratic program solver failed");
+
+	cout << resultsDir << ": test Arm26 quadratic program passed" << endl;
+}
+
+void testArm26Parallel()
+{
+	Object::renameType( "Thelen2003Muscle", "Thelen2003Muscle");
+
+	cout << "==============================================" << endl;
+	cout << "       Frames solved in parallel" << endl;
+	cout << "==============================================" << endl;
+
+	string resultsDir = "Results_Parallel";
+	AnalyzeTool analyze("arm26_Setup_StaticOptimization.xml");
+	analyze.setResultsDir(resultsDir);
+	StaticOptimization& so = dynamic_cast<StaticOptimization&>(
+		analyze.getAnalysisSet().get("StaticOptimization"));
+	so.setNumThreads(4);
+	analyze.run();
+
+	// Compare with the sequential solution computed by testArm26(), to the
+	// tolerances that solution is held to against the standard.
+	Storage activations(resultsDir+"/arm26_StaticOptimization_activation.sto");
+	Storage sequentialActivations(
+		"Results_Thelen2003Muscle/arm26_StaticOptimization_activation.sto");
+	ASSERT(activations.getSize() == sequentialActivations.getSize(),
+		__FILE__, __LINE__, "Arm26 frames solved in parallel are missing");
+	CHECK_STORAGE_AGAINST_STANDARD(activations, sequentialActivations, 
+		Array<double>(0.005, 6), __FILE__, __LINE__, 
+		"Arm26 activations solved in parallel failed");
+
+	Storage forces(resultsDir+"/arm26_StaticOptimization_force.sto");
+	Storage sequentialForces(
+		"Results_Thelen2003Muscle/arm26_StaticOptimization_force.sto");
+	CHECK_STORAGE_AGAINST_STANDARD(forces, sequentialForces, 
+		Array<double>(0.5, 6), __FILE__, __LINE__, 
+		"Arm26 forces solved in parallel failed");
+
+	cout << resultsDir << ": test Arm26 parallel passed" << endl;
+}
+
+void testArm26ConstraintMatrix()
+{
+	Object::renameType( "Thelen2003Muscle", "Thelen2003Muscle");
+
+	cout << "==============================================" << endl;
+	cout << "       Constraint matrix" << endl;
+	cout << "==============================================" << endl;
+
+	Model model("arm26.osim");
+	SimTK::State& s = model.initSystem();
+	const Set<Actuator>& actuators = model.getActuators();
+	for(int i=0; i<actuators.getSize(); i++)
+		actuators[i].overrideForce(s,true);
+	int na = actuators.getSize();
+
+	// The constraints compare with the accelerations of the splined speeds.
+	// Those cancel between the columns of the matrix, so any values do.
+	const CoordinateSet& coords = model.getCoordinateSet();
+	int nc = coords.getSize();
+	Array<string> labels;
+	labels.append("time");
+	for(int j=0; j<nc; j++) labels.append(coords[j].getSpeedName());
+	Storage states;
+	states.setColumnLabels(labels);
+	Array<double> y(0.0, nc);
+	for(int i=0; i<20; i++) {
+		for(int j=0; j<nc; j++) y[j] = sin(0.1*i*(j+1));
+		states.append(0.1*i, y);
+	}
+	GCVSplineSet splines(5, &states);
+
+	for(int pose=0; pose<3; pose++) {
+		s.setTime(0.5*pose);
+		for(int j=0; j<nc; j++) {
+			const Coordinate& coord = coords[j];
+			double mid = 0.5*(coord.getRangeMin() + coord.getRangeMax());
+			double half = 0.5*(coord.getRangeMax() - coord.getRangeMin());
+			coord.setValue(s, mid + 0.8*half*sin(1.3*pose+j), false);
+			coord.setSpeedValue(s, cos(0.7*pose+j));
+		}
+		model.getMultibodySystem().realize(s, SimTK::Stage::Velocity);
+
+		StaticOptimizationTarget target(s, &model, na, nc, false);
+		target.setStatesStore(&states);
+		target.setStatesSplineSet(splines);
+		SimTK::Vector x(na, 0.0);
+
+		SimTK::Matrix analytic, perturbed;
+		target.setUseAnalyticConstraintMatrix(true);
+		target.prepareToOptimize(s, &x[0]);
+		target.constraintJacobian(x, true, analytic);
+		target.setUseAnalyticConstraintMatrix(false);
+		target.prepareToOptimize(s, &x[0]);
+		target.constraintJacobian(x, true, perturbed);
+
+		ASSERT(analytic.nrow()==perturbed.nrow() &&
+			analytic.ncol()==perturbed.ncol(), __FILE__, __LINE__,
+			"Constraint matrices differ in size");
+		for(int p=0; p<analytic.ncol(); p++) {
+			double scale = max(1.0, perturbed.col(p).normInf());
+			for(int c=0; c<analytic.nrow(); c++) {
+				ASSERT_EQUAL(perturbed(c,p), analytic(c,p), 1.0e-6*scale,
+					__FILE__, __LINE__, "Analytic constraint matrix of "
+					+ actuators[p].getName() + " failed");
+			}
+		}
+	}
+
+	cout << "Constraint matrix: test Arm26 passed" << endl;
+}
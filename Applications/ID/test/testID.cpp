@@ -47,6 +47,40 @@ int main()
 		Storage result2("Results/subject01_InverseDynamics.sto"), standard2("std_subject01_InverseDynamics.sto");
 		CHECK_STORAGE_AGAINST_STANDARD(result2, standard2, Array<double>(2.0, 23), __FILE__, __LINE__, "testGait failed");
 		cout << "testGait passed" << endl;
+
+		// Frames solved on several threads must match those solved in sequence
+		InverseDynamicsTool id3("subject01_Setup_InverseDynamics.xml");
+		id3.setNumThreads(4);
+		id3.setOutputGenForceFileName("subject01_InverseDynamics_threaded");
+		id3.run();
+		Storage result3("Results/subject01_InverseDynamics_threaded.sto");
+		CHECK_STORAGE_AGAINST_STANDARD(result3, result2, Array<double>(1e-8, 23), __FILE__, __LINE__, "testGait threaded failed");
+		cout << "testGait threaded passed" << endl;
+
+		// Body forces at the joints computed on several threads must match
+		// those computed in sequence, column by column
+		Array<string> allJoints("All", 1);
+		InverseDynamicsTool id4("subject01_Setup_InverseDynamics.xml");
+		id4.setNumThreads(1);
+		id4.setJointsForReportingBodyForces(allJoints);
+		id4.setOutputGenForceFileName("subject01_InverseDynamics_sequential");
+		id4.setOutputBodyForcesAtJointsFileName("subject01_BodyForces_sequential");
+		id4.run();
+		InverseDynamicsTool id5("subject01_Setup_InverseDynamics.xml");
+		id5.setNumThreads(4);
+		id5.setJointsForReportingBodyForces(allJoints);
+		id5.setOutputGenForceFileName("subject01_InverseDynamics_threaded");
+		id5.setOutputBodyForcesAtJointsFileName("subject01_BodyForces_threaded");
+		id5.run();
+		Storage bodyForces4("Results/subject01_BodyForces_sequential.sto");
+		Storage bodyForces5("Results/subject01_BodyForces_threaded.sto");
+		int nc = bodyForces4.getColumnLabels().getSize()-1;
+		ASSERT(nc > 0 && bodyForces5.getColumnLabels().getSize()-1 == nc,
+			__FILE__, __LINE__, "testGait body forces are missing columns");
+		ASSERT(bodyForces5.getSize() == bodyForces4.getSize(),
+			__FILE__, __LINE__, "testGait body forces are missing frames");
+		CHECK_STORAGE_AGAINST_STANDARD(bodyForces5, bodyForces4, Array<double>(1e-8, nc), __FILE__, __LINE__, "testGait threaded body forces failed");
+		cout << "testGait threaded body forces passed" << endl;
 	}
     catch (const Exception& e) {
         e.print(cerr);
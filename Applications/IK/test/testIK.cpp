@@ -28,11 +28,63 @@
 #include <OpenSim/Common/ScaleSet.h>
 #include <OpenSim/Simulation/Model/Model.h>
 #include <OpenSim/Tools/InverseKinematicsTool.h>
+#include <OpenSim/Tools/IKTaskSet.h>
+#include <OpenSim/Simulation/InverseKinematicsSolver.h>
+#include <OpenSim/Simulation/MarkersReference.h>
+#include <OpenSim/Simulation/CoordinateReference.h>
+#include <OpenSim/Common/Constant.h>
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
 
 using namespace OpenSim;
 using namespace std;
 
+// Least-squares tracking must be used for the gait model, whose only
+// constraints lock coordinates, and must give way to the Assembler when a
+// coordinate is held to its reference with an infinite weight.
+void testLeastSquaresTrackingIsUsed()
+{
+	Model model("subject01_simbody.osim");
+	SimTK::State& s = model.initSystem();
+
+	IKTaskSet tasks("gait2354_IK_Tasks_uniform.xml");
+	Set<MarkerWeight> markerWeights;
+	tasks.createMarkerWeightSet(markerWeights);
+	MarkersReference markersReference;
+	markersReference.setMarkerWeightSet(markerWeights);
+	markersReference.loadMarkersFile("subject01_synthetic_marker_data.trc");
+	double t0 = markersReference.getValidTimeRange()[0];
+	double dt = 1.0/markersReference.getSamplingFrequency();
+
+	SimTK::Array_<CoordinateReference> coordinateReferences;
+	InverseKinematicsSolver ikSolver(model, markersReference, coordinateReferences);
+	ikSolver.setAccuracy(1e-5);
+	ikSolver.setUseLeastSquaresTracking(true);
+	s.updTime() = t0;
+	ikSolver.assemble(s);
+	s.updTime() = t0 + dt;
+	ikSolver.track(s);
+	ASSERT(ikSolver.getTrackedByLeastSquares(), __FILE__, __LINE__,
+		"Least-squares tracking was not used for the gait model");
+	ASSERT(ikSolver.getNumLeastSquaresIterations() > 0, __FILE__, __LINE__,
+		"Least-squares tracking took no iterations");
+
+	const Coordinate& tilt = model.getCoordinateSet().get("pelvis_tilt");
+	Constant tiltValue(tilt.getValue(s));
+	CoordinateReference hardTilt("pelvis_tilt", tiltValue);
+	hardTilt.setWeight(SimTK::Infinity);
+	coordinateReferences.push_back(hardTilt);
+	InverseKinematicsSolver ikHard(model, markersReference, coordinateReferences);
+	ikHard.setAccuracy(1e-5);
+	ikHard.setUseLeastSquaresTracking(true);
+	s.updTime() = t0;
+	ikHard.assemble(s);
+	s.updTime() = t0 + dt;
+	ikHard.track(s);
+	ASSERT(!ikHard.getTrackedByLeastSquares(), __FILE__, __LINE__,
+		"Least-squares tracking was used with a hard coordinate goal");
+	cout << "testLeastSquaresTrackingIsUsed passed" << endl;
+}
+
 int main()
 {
 	try {
@@ -42,6 +94,41 @@ int main()
 		CHECK_STORAGE_AGAINST_STANDARD(result1, standard, Array<double>(0.2, 24), __FILE__, __LINE__, "testInverseKinematicsGait2354 failed");
 		cout << "testInverseKinematicsGait2354 passed" << endl;
 
+		// Tracking chunks of frames on several threads must reproduce the
+		// sequential solution within the accuracy of the solver, 1e-5 in the
+		// setup file; the angles are reported in degrees.
+		const double accuracy = 1e-5*SimTK_RADIAN_TO_DEGREE;
+		InverseKinematicsTool ikThreaded("subject01_Setup_InverseKinematics.xml");
+		ikThreaded.setNumThreads(4);
+		ikThreaded.setOutputMotionFileName("subject01_walk1_ik_threaded.mot");
+		ikThreaded.run();
+		Storage resultThreaded(ikThreaded.getOutputMotionFileName());
+		CHECK_STORAGE_AGAINST_STANDARD(resultThreaded, result1, Array<double>(accuracy, 24), __FILE__, __LINE__, "testInverseKinematicsGait2354 threaded failed");
+		cout << "testInverseKinematicsGait2354 threaded passed" << endl;
+
+		// Benchmark the dedicated least-squares tracking against the assembler;
+		// both must find the same solution
+		InverseKinematicsTool ikAssembler("subject01_Setup_InverseKinematics.xml");
+		ikAssembler.setOutputMotionFileName("subject01_walk1_ik_assembler.mot");
+		double start = SimTK::realTime();
+		ikAssembler.run();
+		double assemblerTime = SimTK::realTime() - start;
+
+		InverseKinematicsTool ikLeastSquares("subject01_Setup_InverseKinematics.xml");
+		ikLeastSquares.setUseLeastSquaresTracking(true);
+		ikLeastSquares.setOutputMotionFileName("subject01_walk1_ik_least_squares.mot");
+		start = SimTK::realTime();
+		ikLeastSquares.run();
+		double leastSquaresTime = SimTK::realTime() - start;
+
+		cout << "Gait2354 IK with assembler: " << assemblerTime << "s; with least-squares tracking: "
+			<< leastSquaresTime << "s" << endl;
+		Storage resultLeastSquares(ikLeastSquares.getOutputMotionFileName());
+		CHECK_STORAGE_AGAINST_STANDARD(resultLeastSquares, result1, Array<double>(0.06, 24), __FILE__, __LINE__, "testInverseKinematicsGait2354 least-squares tracking failed");
+		CHECK_STORAGE_AGAINST_STANDARD(resultLeastSquares, standard, Array<double>(0.2, 24), __FILE__, __LINE__, "testInverseKinematicsGait2354 least-squares tracking failed");
+		cout << "testInverseKinematicsGait2354 least-squares tracking passed" << endl;
+		testLeastSquaresTrackingIsUsed();
+
 		InverseKinematicsTool ik2("subject01_Setup_InverseKinematics_NoModel.xml");
 		Model mdl("subject01_simbody.osim");
 		mdl.initSystem();
@@ -33,6 +33,7 @@
 #include <OpenSim/Simulation/SimbodyEngine/Coordinate.h>
 #include <OpenSim/Simulation/Model/CoordinateSet.h>
 #include <OpenSim/Simulation/Model/ForceSet.h>
+#include <OpenSim/Simulation/MomentArmSolver.h>
 #include "MuscleAnalysis.h"
 
 using namespace OpenSim;
@@ -55,6 +56,7 @@ MuscleAnalysis::~MuscleAnalysis()
 {
 	// Individual storages where added to the Analysis' _storageList
 	// which takes ownerwhip of the Storage objects and deletes them.
+	delete _momentArmSolver;
 }
 //_____________________________________________________________________________
 /**
@@ -118,6 +120,8 @@ void MuscleAnalysis::setNull()
 	setupProperties();
 	constructDescription();
 
+	_momentArmSolver = NULL;
+
 	// STORAGE
 	_pennationAngleStore = NULL;
 	_lengthStore = NULL;
@@ -643,24 +647,33 @@ int MuscleAnalysis::record(const SimTK::State& s)
 	_musclePowerStore->append(tReal,muscPower.getSize(),&muscPower[0]);
 
 	if (_computeMoments){
+		// SOLVE FOR ALL THE MOMENT ARMS AT ONCE
+		if(_momentArmSolver==NULL || &_momentArmSolver->getModel()!=_model) {
+			delete _momentArmSolver;
+			_momentArmSolver = new MomentArmSolver(*_model);
+		}
+		int nq = _momentArmStorageArray.getSize();
+		SimTK::Array_<const Coordinate*> coordinates(nq);
+		for(int i=0; i<nq; i++)
+			coordinates[i] = _momentArmStorageArray[i]->q;
+		SimTK::Array_<const GeometryPath*> paths(nm);
+		for(int j=0; j<nm; j++)
+			paths[j] = &_muscleArray[j]->getGeometryPath();
+		SimTK::Matrix momentArms;
+		_momentArmSolver->solve(s, coordinates, paths, momentArms);
+
 		// LOOP OVER ACTIVE MOMENT ARM STORAGE OBJECTS
-		Coordinate *q = NULL;
 		Storage *maStore=NULL, *mStore=NULL;
-		int nq = _momentArmStorageArray.getSize();
 		Array<double> ma(0.0,nm),m(0.0,nm);
 
 		for(int i=0; i<nq; i++) {
 
-			q = _momentArmStorageArray[i]->q;
 			maStore = _momentArmStorageArray[i]->momentArmStore;
 			mStore = _momentArmStorageArray[i]->momentStore;
-	       
-			bool locked = q->getLocked(s);
 
-			_model->getMultibodySystem().realize(s, s.getSystemStage());
 			// LOOP OVER MUSCLES
 			for(int j=0; j<nm; j++) {
-				ma[j] = _muscleArray[j]->computeMomentArm(s,*q);
+				ma[j] = momentArms(j,i);
 				m[j] = ma[j] * force[j];
 			}
 			maStore->append(s.getTime(),nm,&ma[0]);
@@ -45,6 +45,7 @@
 
 namespace OpenSim { 
 
+class MomentArmSolver;
 
 //=============================================================================
 //=============================================================================
@@ -141,6 +142,10 @@ private:
 	/** Array of active muscles. */
 	ArrayPtrs<Muscle> _muscleArray;
 
+	/** Solver for the moment arms of all the active muscles about all the
+	active coordinates at once, kept to reuse its workspace. */
+	MomentArmSolver *_momentArmSolver;
+
 //=============================================================================
 // METHODS
 //=============================================================================
@@ -39,14 +39,126 @@
 #include <OpenSim/Simulation/Control/ControlSet.h>
 #include <SimTKmath.h>
 #include <SimTKlapack.h>
+#include "SimTKcommon/internal/ParallelExecutor.h"
 #include "StaticOptimization.h"
 #include "StaticOptimizationTarget.h"
 #include <OpenSim/Simulation/Model/ActivationFiberLengthMuscle.h>
+#include <memory>
 
 
 using namespace OpenSim;
 using namespace std;
 
+namespace {
+
+// Frames are not divided into chunks shorter than this; every chunk after
+// the first needs its own copy of the model.
+const int MIN_FRAMES_PER_CHUNK = 10;
+
+}
+
+namespace OpenSim {
+
+/** A contiguous range of the kept frames, with the copies of the model and
+the states splines, the target and the optimizer that solve it, and the
+results in time order. */
+struct StaticOptimizationChunk {
+	Model *model;
+	GCVSplineSet *statesSplineSet;
+	bool ownsModel;
+	StaticOptimizationTarget *target;
+	SimTK::Optimizer *optimizer;
+	SimTK::Vector parameters;
+	SimTK::Vector multipliers;
+	Storage activations;
+	Storage forces;
+	/** Frame solved, but not recorded, before the first frame so that the
+	first frame is warm started; -1 if there is none. */
+	int seedFrame;
+	int firstFrame;
+	int numFrames;
+	std::string error;
+
+	StaticOptimizationChunk() : model(NULL), statesSplineSet(NULL),
+		ownsModel(false), target(NULL), optimizer(NULL), seedFrame(-1),
+		firstFrame(0), numFrames(0) {}
+	~StaticOptimizationChunk() {
+		if(ownsModel) {
+			delete optimizer;
+			delete target;
+			delete statesSplineSet;
+			delete model;
+		}
+	}
+};
+
+/**
+ * Solves each chunk's frames in sequence, so each frame after a chunk's first
+ * starts from the solution of the frame before it. Chunks write only to
+ * their own model, splines and storages, and read the kept frames and the
+ * states storage of the analysis without changing them, so they can be
+ * executed on separate threads.
+ */
+class StaticOptimizationFramesTask : public SimTK::ParallelExecutor::Task {
+public:
+	StaticOptimizationFramesTask(StaticOptimization &aAnalysis,
+		vector< unique_ptr<StaticOptimizationChunk> > &aChunks) :
+		_analysis(aAnalysis), _chunks(aChunks) {}
+
+	void execute(int aChunk) {
+		StaticOptimizationChunk &chunk = *_chunks[aChunk];
+		try {
+			SimTK::State s(chunk.model->getWorkingState());
+			SimTK::Vector forces;
+			if(chunk.seedFrame>=0) solveFrame(chunk, chunk.seedFrame, s, forces);
+			for(int i=chunk.firstFrame; i<chunk.firstFrame+chunk.numFrames; i++) {
+				solveFrame(chunk, i, s, forces);
+				chunk.activations.append(s.getTime(), chunk.parameters, false);
+				chunk.forces.append(s.getTime(), forces, false);
+			}
+		}
+		catch(const std::exception &ex) {
+			chunk.error = ex.what();
+		}
+	}
+
+private:
+	void solveFrame(StaticOptimizationChunk &chunk, int aFrame,
+		SimTK::State &s, SimTK::Vector &rForces) {
+		s.setTime(_analysis._frameTimes[aFrame]);
+		s.setQ(_analysis._frameQs[aFrame]);
+		s.setU(_analysis._frameUs[aFrame]);
+		_analysis.solveFrame(*chunk.model, s, *chunk.statesSplineSet,
+			chunk.target, chunk.optimizer, chunk.parameters, chunk.multipliers,
+			rForces, false);
+	}
+
+	StaticOptimization &_analysis;
+	vector< unique_ptr<StaticOptimizationChunk> > &_chunks;
+};
+
+/**
+ * Hands the target and optimizer of the first chunk, which solving a frame
+ * may have replaced, back to the analysis that owns them, however the
+ * chunks are left.
+ */
+class FirstChunkSolverReturn {
+public:
+	FirstChunkSolverReturn(const StaticOptimizationChunk &aChunk,
+		StaticOptimizationTarget *&rTarget, SimTK::Optimizer *&rOptimizer) :
+		_chunk(aChunk), _target(rTarget), _optimizer(rOptimizer) {}
+	~FirstChunkSolverReturn() {
+		_target = _chunk.target;
+		_optimizer = _chunk.optimizer;
+	}
+private:
+	const StaticOptimizationChunk &_chunk;
+	StaticOptimizationTarget *&_target;
+	SimTK::Optimizer *&_optimizer;
+};
+
+}
+
 //=============================================================================
 // CONSTRUCTOR(S) AND DESTRUCTOR
 //=============================================================================
@@ -57,6 +169,7 @@ using namespace std;
 StaticOptimization::~StaticOptimization()
 {
 	deleteStorage();
+	deleteOptimizer();
 	delete _modelWorkingCopy;
 	if(_ownsForceSet) delete _forceSet;
 }
@@ -70,7 +183,11 @@ StaticOptimization::StaticOptimization(Model *aModel) :
 	_useMusclePhysiology(_useMusclePhysiologyProp.getValueBool()),
 	_convergenceCriterion(_convergenceCriterionProp.getValueDbl()),
 	_maximumIterations(_maximumIterationsProp.getValueInt()),
+	_optimizerAlgorithm(_optimizerAlgorithmProp.getValueStr()),
+	_numThreads(_numThreadsProp.getValueInt()),
 	_modelWorkingCopy(NULL),
+	_target(NULL),
+	_optimizer(NULL),
 	_numCoordinateActuators(0)
 {
 	setNull();
@@ -91,7 +208,11 @@ StaticOptimization::StaticOptimization(const StaticOptimization &aStaticOptimiza
 	_useMusclePhysiology(_useMusclePhysiologyProp.getValueBool()),
 	_convergenceCriterion(_convergenceCriterionProp.getValueDbl()),
 	_maximumIterations(_maximumIterationsProp.getValueInt()),
+	_optimizerAlgorithm(_optimizerAlgorithmProp.getValueStr()),
+	_numThreads(_numThreadsProp.getValueInt()),
 	_modelWorkingCopy(NULL),
+	_target(NULL),
+	_optimizer(NULL),
 	_numCoordinateActuators(aStaticOptimization._numCoordinateActuators)
 {
 	setNull();
@@ -117,12 +238,16 @@ operator=(const StaticOptimization &aStaticOptimization)
 	// BASE CLASS
 	Analysis::operator=(aStaticOptimization);
 
+	// The optimizer is bound to the model working copy; make a new one.
+	deleteOptimizer();
 	_modelWorkingCopy = aStaticOptimization._modelWorkingCopy;
 	_numCoordinateActuators = aStaticOptimization._numCoordinateActuators;
 	_useModelForceSet = aStaticOptimization._useModelForceSet;
 	_activationExponent=aStaticOptimization._activationExponent;
 	_convergenceCriterion=aStaticOptimization._convergenceCriterion;
 	_maximumIterations=aStaticOptimization._maximumIterations;
+	_optimizerAlgorithm=aStaticOptimization._optimizerAlgorithm;
+	_numThreads=aStaticOptimization._numThreads;
 
 	_useMusclePhysiology=aStaticOptimization._useMusclePhysiology;
 	return(*this);
@@ -148,6 +273,10 @@ void StaticOptimization::setNull()
 	_numCoordinateActuators = 0;
 	_convergenceCriterion = 1e-4;
 	_maximumIterations = 100;
+	_optimizerAlgorithm = "ipopt";
+	_numThreads = 1;
+	_numericalDerivativeStepSize = 0.0001;
+	_printLevel = 0;
 
 	setName("StaticOptimization");
 }
@@ -183,6 +312,18 @@ setupProperties()
 		"An integer for setting the maximum number of iterations the optimizer can use at each time.  ");
 	_maximumIterationsProp.setName("optimizer_max_iterations");
 	_propertySet.append(&_maximumIterationsProp);
+
+	_optimizerAlgorithmProp.setComment(
+		"Optimizer used at each time: ipopt, or qp to solve the quadratic problem directly when the "
+		"activation exponent is 2 (ipopt is used otherwise, or if qp fails).");
+	_optimizerAlgorithmProp.setName("optimizer_algorithm");
+	_propertySet.append(&_optimizerAlgorithmProp);
+
+	_numThreadsProp.setComment(
+		"Number of threads over which to divide the frames. Each thread solves a contiguous range of frames "
+		"with its own copy of the model. 1 solves each frame as it is recorded; 0 or less uses all processors.");
+	_numThreadsProp.setName("num_threads");
+	_propertySet.append(&_numThreadsProp);
 }
 
 //=============================================================================
@@ -244,6 +385,19 @@ deleteStorage()
 	delete _activationStorage; _activationStorage = NULL;
 	delete _forceStorage; _forceStorage = NULL;
 }
+//_____________________________________________________________________________
+/**
+ * Delete the optimizer and target kept between frames.
+ */
+void StaticOptimization::
+deleteOptimizer()
+{
+	// The optimizer refers to the target, so it goes first.
+	delete _optimizer;
+	_optimizer = NULL;
+	delete _target;
+	_target = NULL;
+}
 
 //=============================================================================
 // GET AND SET
@@ -308,68 +462,51 @@ setStorageCapacityIncrements(int aIncrement)
 //=============================================================================
 //_____________________________________________________________________________
 /**
- * Record the results.
+ * Solve static optimization for one frame with a working copy of the model.
+ * The target and optimizer are created on the first call, when rOptimizer
+ * is NULL, and kept so that later calls start from the previous solution;
+ * the optimizer is deleted again if the solve fails.
+ *
+ * @param aModel Working copy of the model used to solve the frame. Its
+ * controllers are disabled and the default activations of its muscles are
+ * set to the solution.
+ * @param s State holding the time, coordinates and speeds of the frame.
+ * @param aStatesSplineSet Splines of the states, copied into a new target.
+ * @param rTarget Target bound to aModel.
+ * @param rOptimizer Optimizer of rTarget.
+ * @param rParameters Activations: the initial guess on entry and the
+ * solution on return.
+ * @param rMultipliers Multipliers kept by the quadratic program solver.
+ * @param rForces Actuator forces of the solution.
+ * @param aPrintPerformance Whether to print the performance and constraint
+ * violation of the solution.
  */
-int StaticOptimization::
-record(const SimTK::State& s)
+void StaticOptimization::
+solveFrame(Model& aModel, const SimTK::State& s,
+	const GCVSplineSet& aStatesSplineSet,
+	StaticOptimizationTarget*& rTarget, SimTK::Optimizer*& rOptimizer,
+	SimTK::Vector& rParameters, SimTK::Vector& rMultipliers,
+	SimTK::Vector& rForces, bool aPrintPerformance)
 {
-	if(!_modelWorkingCopy) return -1;
-
 	// Set model to whatever defaults have been updated to from the last iteration
-    SimTK::State& sWorkingCopy = _modelWorkingCopy->updWorkingState();
+    SimTK::State& sWorkingCopy = aModel.updWorkingState();
 	sWorkingCopy.setTime(s.getTime());
-	_modelWorkingCopy->initStateWithoutRecreatingSystem(sWorkingCopy); 
+	aModel.initStateWithoutRecreatingSystem(sWorkingCopy); 
 
 	// update Q's and U's
 	sWorkingCopy.setQ(s.getQ());
 	sWorkingCopy.setU(s.getU());
 
-	_modelWorkingCopy->getMultibodySystem().realize(sWorkingCopy, SimTK::Stage::Velocity);
-	//_modelWorkingCopy->equilibrateMuscles(sWorkingCopy);
+	aModel.getMultibodySystem().realize(sWorkingCopy, SimTK::Stage::Velocity);
+	//aModel.equilibrateMuscles(sWorkingCopy);
 
-    const Set<Actuator>& fs = _modelWorkingCopy->getActuators();
+    const Set<Actuator>& fs = aModel.getActuators();
 
 	int na = fs.getSize();
 	int nacc = _accelerationIndices.getSize();
 
-	// IPOPT
-	_numericalDerivativeStepSize = 0.0001;
-	_optimizerAlgorithm = "ipopt";
-	_printLevel = 0;
-	//_optimizationConvergenceTolerance = 1e-004;
-	//_maxIterations = 2000;
-
 	// Optimization target
-	_modelWorkingCopy->setAllControllersEnabled(false);
-	StaticOptimizationTarget target(sWorkingCopy,_modelWorkingCopy,na,nacc,_useMusclePhysiology);
-	target.setStatesStore(_statesStore);
-	target.setStatesSplineSet(_statesSplineSet);
-	target.setActivationExponent(_activationExponent);
-	target.setDX(_numericalDerivativeStepSize);
-
-	// Pick optimizer algorithm
-	SimTK::OptimizerAlgorithm algorithm = SimTK::InteriorPoint;
-	//SimTK::OptimizerAlgorithm algorithm = SimTK::CFSQP;
-
-	// Optimizer
-	SimTK::Optimizer *optimizer = new SimTK::Optimizer(target, algorithm);
-
-	// Optimizer options
-	//cout<<"\nSetting optimizer print level to "<<_printLevel<<".\n";
-	optimizer->setDiagnosticsLevel(_printLevel);
-	//cout<<"Setting optimizer convergence criterion to "<<_convergenceCriterion<<".\n";
-	optimizer->setConvergenceTolerance(_convergenceCriterion);
-	//cout<<"Setting optimizer maximum iterations to "<<_maximumIterations<<".\n";
-	optimizer->setMaxIterations(_maximumIterations);
-	optimizer->useNumericalGradient(false);
-	optimizer->useNumericalJacobian(false);
-	if(algorithm == SimTK::InteriorPoint) {
-		// Some IPOPT-specific settings
-		optimizer->setLimitedMemoryHistory(500); // works well for our small systems
-		optimizer->setAdvancedBoolOption("warm_start",true);
-		optimizer->setAdvancedRealOption("obj_scaling_factor",1);
-		optimizer->setAdvancedRealOption("nlp_scaling_max_gradient",1);
-	}
+	aModel.setAllControllersEnabled(false);
 
 	// Parameter bounds
 	SimTK::Vector lowerBounds(na), upperBounds(na);
@@ -379,14 +516,53 @@ record(const SimTK::State& s)
 	    upperBounds(j) = act.getMaxControl();
         j++;
 	}
-	
-	target.setParameterLimits(lowerBounds, upperBounds);
 
-	_parameters = 0; // Set initial guess to zeros
+	// The target and optimizer persist from frame to frame; the target is
+	// re-bound to each frame's state below by prepareToOptimize(), and the
+	// optimizer, with IPOPT's warm start, begins from the previous solution
+	// and the multipliers it kept from the previous solve.
+	if(rOptimizer==NULL) {
+		delete rTarget;
+		rTarget = new StaticOptimizationTarget(sWorkingCopy,&aModel,na,nacc,_useMusclePhysiology);
+		rTarget->setStatesStore(_statesStore);
+		rTarget->setStatesSplineSet(aStatesSplineSet);
+		rTarget->setActivationExponent(_activationExponent);
+		rTarget->setDX(_numericalDerivativeStepSize);
+		rTarget->setParameterLimits(lowerBounds, upperBounds);
+
+		// Pick optimizer algorithm
+		SimTK::OptimizerAlgorithm algorithm = SimTK::InteriorPoint;
+		//SimTK::OptimizerAlgorithm algorithm = SimTK::CFSQP;
+
+		// Optimizer
+		rOptimizer = new SimTK::Optimizer(*rTarget, algorithm);
+
+		// Optimizer options
+		//cout<<"\nSetting optimizer print level to "<<_printLevel<<".\n";
+		rOptimizer->setDiagnosticsLevel(_printLevel);
+		//cout<<"Setting optimizer convergence criterion to "<<_convergenceCriterion<<".\n";
+		rOptimizer->setConvergenceTolerance(_convergenceCriterion);
+		//cout<<"Setting optimizer maximum iterations to "<<_maximumIterations<<".\n";
+		rOptimizer->setMaxIterations(_maximumIterations);
+		rOptimizer->useNumericalGradient(false);
+		rOptimizer->useNumericalJacobian(false);
+		if(algorithm == SimTK::InteriorPoint) {
+			// Some IPOPT-specific settings
+			rOptimizer->setLimitedMemoryHistory(500); // works well for our small systems
+			rOptimizer->setAdvancedBoolOption("warm_start",true);
+			rOptimizer->setAdvancedRealOption("obj_scaling_factor",1);
+			rOptimizer->setAdvancedRealOption("nlp_scaling_max_gradient",1);
+		}
+
+		rParameters = 0; // Set initial guess to zeros
+		rMultipliers.resize(0);
+	}
+	StaticOptimizationTarget& target = *rTarget;
+	bool useQP = (_optimizerAlgorithm=="qp" && _activationExponent==2.0);
 
 	// Static optimization
-	_modelWorkingCopy->getMultibodySystem().realize(sWorkingCopy,SimTK::Stage::Velocity);
-	target.prepareToOptimize(sWorkingCopy, &_parameters[0]);
+	aModel.getMultibodySystem().realize(sWorkingCopy,SimTK::Stage::Velocity);
+	target.prepareToOptimize(sWorkingCopy, &rParameters[0]);
 
 	//LARGE_INTEGER start;
 	//LARGE_INTEGER stop;
@@ -397,9 +573,17 @@ record(const SimTK::State& s)
 
 	try {
 		target.setCurrentState( &sWorkingCopy );
-		optimizer->optimize(_parameters);
+		if(!useQP || target.optimizeQuadratic(rParameters,rMultipliers,
+				_maximumIterations,1.0e-8)<0) {
+			rMultipliers.resize(0);
+			rOptimizer->optimize(rParameters);
+		}
 	}
 	catch (const SimTK::Exception::Base& ex) {
+		// Don't start the next frame from a failed solve.
+		delete rOptimizer;
+		rOptimizer = NULL;
+
 		cout << ex.getMessage() << endl;
 		cout << "OPTIMIZATION FAILED..." << endl;
 		cout << endl;
@@ -410,11 +594,11 @@ record(const SimTK::State& s)
 		bool weakModel = false;
 		string msgWeak = "The model appears too weak for static optimization.\nTry increasing the strength and/or range of the following force(s):\n";
 		for(int a=0;a<na;a++) {
-			Actuator* act = dynamic_cast<Actuator*>(&_forceSet->get(a));
+			Actuator* act = dynamic_cast<Actuator*>(&fs.get(a));
             if( act ) {
-			    Muscle*  mus = dynamic_cast<Muscle*>(&_forceSet->get(a));
+			    Muscle*  mus = dynamic_cast<Muscle*>(&fs.get(a));
  			    if(mus==NULL) {
-			    	if(_parameters(a) < (lowerBounds(a)+tolBounds)) {
+			    	if(rParameters(a) < (lowerBounds(a)+tolBounds)) {
 			    		msgWeak += "   ";
 			    		msgWeak += act->getName();
 			    		msgWeak += " approaching lower bound of ";
@@ -423,7 +607,7 @@ record(const SimTK::State& s)
 			    		msgWeak += oLower.str();
 			    		msgWeak += "\n";
 			    		weakModel = true;
-			    	} else if(_parameters(a) > (upperBounds(a)-tolBounds)) {
+			    	} else if(rParameters(a) > (upperBounds(a)-tolBounds)) {
 			    		msgWeak += "   ";
 			    		msgWeak += act->getName();
 			    		msgWeak += " approaching upper bound of ";
@@ -434,7 +618,7 @@ record(const SimTK::State& s)
 			    		weakModel = true;
 			    	} 
 			    } else {
-			    	if(_parameters(a) > (upperBounds(a)-tolBounds)) {
+			    	if(rParameters(a) > (upperBounds(a)-tolBounds)) {
 			    		msgWeak += "   ";
 			    		msgWeak += mus->getName();
 			    		msgWeak += " approaching upper bound of ";
@@ -454,8 +638,8 @@ record(const SimTK::State& s)
 			bool incompleteModel = false;
 			string msgIncomplete = "The model appears unsuitable for static optimization.\nTry appending the model with additional force(s) or locking joint(s) to reduce the following acceleration constraint violation(s):\n";
 			SimTK::Vector constraints;
-			target.constraintFunc(_parameters,true,constraints);
-			const CoordinateSet& coordSet = _modelWorkingCopy->getCoordinateSet();
+			target.constraintFunc(rParameters,true,constraints);
+			const CoordinateSet& coordSet = aModel.getCoordinateSet();
 			for(int acc=0;acc<nacc;acc++) {
 				if(fabs(constraints(acc)) > tolConstraints) {
 					const Coordinate& coord = coordSet.get(_accelerationIndices[acc]);
@@ -477,26 +661,40 @@ record(const SimTK::State& s)
 	//double duration = (double)(stop.QuadPart-start.QuadPart)/(double)frequency.QuadPart;
 	//cout << "optimizer time = " << (duration*1.0e3) << " milliseconds" << endl;
 
-	target.printPerformance(sWorkingCopy, &_parameters[0]);
+	if(aPrintPerformance)
+		target.printPerformance(sWorkingCopy, &rParameters[0]);
 
 	//update defaults for use in the next step
 
-	const Set<Actuator>& actuators = _modelWorkingCopy->getActuators();
+	const Set<Actuator>& actuators = aModel.getActuators();
 	for(int k=0; k < actuators.getSize(); ++k){
 		ActivationFiberLengthMuscle *mus = dynamic_cast<ActivationFiberLengthMuscle*>(&actuators[k]);
 		if(mus){
-			mus->setDefaultActivation(_parameters[k]);
+			mus->setDefaultActivation(rParameters[k]);
 			// Don't send up red flags when the def
 			mus->setObjectIsUpToDateWithProperties();
 		}
 	}
 
-	_activationStorage->append(sWorkingCopy.getTime(),na,&_parameters[0]);
+	rForces.resize(na);
+	target.getActuation(const_cast<SimTK::State&>(sWorkingCopy), rParameters,rForces);
+}
+//_____________________________________________________________________________
+/**
+ * Record the results.
+ */
+int StaticOptimization::
+record(const SimTK::State& s)
+{
+	if(!_modelWorkingCopy) return -1;
 
-	SimTK::Vector forces(na);
-	target.getActuation(const_cast<SimTK::State&>(sWorkingCopy), _parameters,forces);
+	SimTK::Vector forces;
+	solveFrame(*_modelWorkingCopy, s, _statesSplineSet, _target, _optimizer,
+		_parameters, _qpMultipliers, forces, true);
 
-	_forceStorage->append(sWorkingCopy.getTime(),na,&forces[0]);
+	int na = forces.size();
+	_activationStorage->append(s.getTime(),na,&_parameters[0]);
+	_forceStorage->append(s.getTime(),na,&forces[0]);
 
 	return 0;
 }
@@ -517,6 +715,10 @@ begin(SimTK::State& s )
 	if(!proceed()) return(0);
 
 	// Make a working copy of the model
+	deleteOptimizer();
+	_frameTimes.clear();
+	_frameQs.clear();
+	_frameUs.clear();
 	delete _modelWorkingCopy;
 	_modelWorkingCopy = _model->clone();
 	_modelWorkingCopy->initSystem();
@@ -632,7 +834,8 @@ step(const SimTK::State& s, int stepNumber )
 {
 	if(!proceed(stepNumber)) return(0);
 
-	record(s);
+	if(_numThreads!=1) keepFrame(s);
+	else record(s);
 
 	return(0);
 }
@@ -650,10 +853,112 @@ end( SimTK::State& s )
 {
 	if(!proceed()) return(0);
 
-	record(s);
+	if(_numThreads!=1) {
+		keepFrame(s);
+		recordFramesInParallel();
+	}
+	else record(s);
 
 	return(0);
 }
+//_____________________________________________________________________________
+/**
+ * Keep the time, coordinates and speeds of a frame to be solved by
+ * recordFramesInParallel().
+ */
+void StaticOptimization::
+keepFrame(const SimTK::State& s)
+{
+	if(!_modelWorkingCopy) return;
+	_frameTimes.push_back(s.getTime());
+	_frameQs.push_back(s.getQ());
+	_frameUs.push_back(s.getU());
+}
+//_____________________________________________________________________________
+/**
+ * Solve the frames kept by keepFrame() and append the results to the
+ * activation and force storages in time order.
+ *
+ * The frames are divided into contiguous chunks, one per thread. The first
+ * chunk uses the model working copy and continues from the solution of the
+ * frame recorded by begin(); each other chunk has its own copies of the
+ * model and of the states splines, and first solves the last frame of the
+ * chunk before it, without recording it, so that its own first frame is
+ * warm started like every other frame. Within a chunk each frame starts from
+ * the solution of the frame before it. The states storage is shared, and
+ * only read. Each chunk records its results in its own storages, which are
+ * appended to the analysis storages one after another once all the chunks
+ * are done.
+ */
+void StaticOptimization::
+recordFramesInParallel()
+{
+	int nf = _frameTimes.size();
+	if(nf==0) return;
+
+	int numThreads = _numThreads>0 ? _numThreads :
+		SimTK::ParallelExecutor::getNumProcessors();
+	int numChunks = max(1, min(numThreads, nf/MIN_FRAMES_PER_CHUNK));
+	int na = _parameters.size();
+
+	vector< unique_ptr<StaticOptimizationChunk> > chunks(numChunks);
+	for(int k=0; k<numChunks; k++) {
+		chunks[k].reset(new StaticOptimizationChunk());
+		StaticOptimizationChunk *chunk = chunks[k].get();
+		chunk->firstFrame = (k*nf)/numChunks;
+		chunk->numFrames = ((k+1)*nf)/numChunks - chunk->firstFrame;
+		chunk->activations.setColumnLabels(getColumnLabels());
+		chunk->forces.setColumnLabels(getColumnLabels());
+		if(k==0) {
+			chunk->model = _modelWorkingCopy;
+			chunk->statesSplineSet = &_statesSplineSet;
+			chunk->target = _target;
+			chunk->optimizer = _optimizer;
+			chunk->parameters = _parameters;
+			chunk->multipliers = _qpMultipliers;
+			continue;
+		}
+		// Copies are made here, in sequence, with the force overrides set
+		// by begin() on the model working copy.
+		chunk->model = _modelWorkingCopy->clone();
+		chunk->statesSplineSet = new GCVSplineSet(_statesSplineSet);
+		chunk->ownsModel = true;
+		chunk->seedFrame = chunk->firstFrame-1;
+		SimTK::State& sChunk = chunk->model->initSystem();
+		const Set<Actuator>& actuators = chunk->model->getActuators();
+		for(int i=0; i<actuators.getSize(); i++)
+			actuators[i].overrideForce(sChunk,true);
+		chunk->parameters.resize(na);
+		chunk->parameters = 0;
+	}
+
+	// The first chunk solves with the analysis's own target and optimizer.
+	FirstChunkSolverReturn firstSolverReturn(*chunks[0], _target, _optimizer);
+	StaticOptimizationFramesTask task(*this, chunks);
+	SimTK::ParallelExecutor executor(numChunks);
+	executor.execute(task, numChunks);
+
+	_parameters = chunks[0]->parameters;
+	_qpMultipliers = chunks[0]->multipliers;
+
+	string error;
+	for(int k=0; k<numChunks; k++) {
+		StaticOptimizationChunk &chunk = *chunks[k];
+		if(error.empty()) error = chunk.error;
+		for(int i=0; i<chunk.activations.getSize(); i++) {
+			_activationStorage->append(*chunk.activations.getStateVector(i));
+			_forceStorage->append(*chunk.forces.getStateVector(i));
+		}
+	}
+	_frameTimes.clear();
+	_frameQs.clear();
+	_frameUs.clear();
+	if(!error.empty())
+		throw Exception("StaticOptimization: "+error, __FILE__, __LINE__);
+
+	cout << "StaticOptimization solved " << nf << " frames in " << numChunks
+		<< " chunk(s)." << endl;
+}
 
 
 //=============================================================================
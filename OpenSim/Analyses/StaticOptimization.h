@@ -31,6 +31,7 @@
 #include <OpenSim/Common/PropertyBool.h>
 #include <OpenSim/Common/PropertyDbl.h>
 #include <OpenSim/Common/PropertyInt.h>
+#include <OpenSim/Common/PropertyStr.h>
 #include <OpenSim/Simulation/Model/Analysis.h>
 #include <OpenSim/Common/GCVSplineSet.h>
 #include <SimTKcommon.h>
@@ -40,10 +41,16 @@
 //=============================================================================
 /**
  */
+namespace SimTK {
+class Optimizer;
+}
+
 namespace OpenSim { 
 
 class Model;
 class ForceSet;
+class StaticOptimizationTarget;
+class StaticOptimizationFramesTask;
 
 /**
  * This class implements static optimization to compute Muscle Forces and 
@@ -53,6 +60,7 @@ class ForceSet;
  */
 class OSIMANALYSES_API StaticOptimization : public Analysis {
 OpenSim_DECLARE_CONCRETE_OBJECT(StaticOptimization, Analysis);
+friend class StaticOptimizationFramesTask;
 
 //=============================================================================
 // DATA
@@ -76,6 +84,13 @@ protected:
 	PropertyInt _maximumIterationsProp;
 	int &_maximumIterations;
 
+	PropertyStr _optimizerAlgorithmProp;
+	std::string &_optimizerAlgorithm;
+
+	/** Number of threads over which to divide the frames. */
+	PropertyInt _numThreadsProp;
+	int &_numThreads;
+
 	Storage *_activationStorage;
 	Storage *_forceStorage;
 	GCVSplineSet _statesSplineSet;
@@ -88,13 +103,27 @@ protected:
 	ForceSet* _forceSet;
 
 	double _numericalDerivativeStepSize;
-	std::string _optimizerAlgorithm;
 	int _printLevel;
 	//double _optimizationConvergenceTolerance;
 	//int _maxIterations;
 
 	Model *_modelWorkingCopy;
 
+	/** Target and optimizer kept from frame to frame, so that each solve
+	starts from the solution (and multipliers) of the previous frame.  They
+	are created by the first record() after begin(). */
+	StaticOptimizationTarget *_target;
+	SimTK::Optimizer *_optimizer;
+	/** Constraint multipliers of the previous quadratic program solution. */
+	SimTK::Vector _qpMultipliers;
+
+	/** Time, coordinates and speeds of the frames after the first, kept by
+	step() and end() to be solved in parallel at the end when more than one
+	thread is used. */
+	SimTK::Array_<double> _frameTimes;
+	SimTK::Array_<SimTK::Vector> _frameQs;
+	SimTK::Array_<SimTK::Vector> _frameUs;
+
 //=============================================================================
 // METHODS
 //=============================================================================
@@ -116,6 +145,14 @@ private:
 	void constructColumnLabels();
 	void allocateStorage();
 	void deleteStorage();
+	void deleteOptimizer();
+	void solveFrame(Model& aModel, const SimTK::State& s,
+		const GCVSplineSet& aStatesSplineSet,
+		StaticOptimizationTarget*& rTarget, SimTK::Optimizer*& rOptimizer,
+		SimTK::Vector& rParameters, SimTK::Vector& rMultipliers,
+		SimTK::Vector& rForces, bool aPrintPerformance);
+	void keepFrame(const SimTK::State& s);
+	void recordFramesInParallel();
 
 public:
 	//--------------------------------------------------------------------------
@@ -137,6 +174,16 @@ public:
 	double getConvergenceCriterion() { return _convergenceCriterion; }
 	void setMaxIterations( const int maxIt) { _maximumIterations = maxIt; }
 	int getMaxIterations() {return _maximumIterations; }
+	/** Set the algorithm: "ipopt", or "qp" to solve each frame with the
+	built-in quadratic program solver when the activation exponent is 2
+	(IPOPT is used for other exponents, and whenever the solver fails). */
+	void setOptimizerAlgorithm(const std::string& algorithm) { _optimizerAlgorithm = algorithm; }
+	const std::string& getOptimizerAlgorithm() const { return _optimizerAlgorithm; }
+	/** Set the number of threads over which the frames are divided: 1 solves
+	each frame when it is recorded, 0 or less uses one thread per processor.
+	With more than one thread the frames are solved together in end(). */
+	void setNumThreads(int aNumThreads) { _numThreads = aNumThreads; }
+	int getNumThreads() const { return _numThreads; }
 	//--------------------------------------------------------------------------
 	// ANALYSIS
 	//--------------------------------------------------------------------------
@@ -35,6 +35,8 @@
 #include <OpenSim/Simulation/Model/ActivationFiberLengthMuscle.h>
 #include <OpenSim/Simulation/Model/ForceSet.h>
 #include <OpenSim/Simulation/SimbodyEngine/Coordinate.h>
+#include <OpenSim/Actuators/CoordinateActuator.h>
+#include <OpenSim/Actuators/McKibbenActuator.h>
 #include "StaticOptimizationTarget.h"
 #include <iostream>
 
@@ -72,6 +74,7 @@ StaticOptimizationTarget(const SimTK::State& s, Model *aModel,int aNP,int aNC, b
 	_recipOptForceSquared.setSize(aNP);
 	_optimalForce.setSize(aNP);
 	_useMusclePhysiology=useMusclePhysiology;
+	_useAnalyticConstraintMatrix = true;
 
 	setModel(*aModel);
 	setNumParams(aNP);
@@ -136,11 +139,55 @@ prepareToOptimize(SimTK::State& s, double *x)
 	pVector = 0;
 	computeConstraintVector(s, pVector,_constraintVector);
 
-	for(int p=0; p<np; p++) {
-		pVector[p] = 1;
-		computeConstraintVector(s, pVector, cVector);
-		for(int c=0; c<nc; c++) _constraintMatrix(c,p) = (cVector[c] - _constraintVector[c]);
-		pVector[p] = 0;
+	// The accelerations are linear in the actuator forces, so column p is
+	// the change in the constraints due to actuator p alone at its optimal
+	// force.  Without kinematic constraints that change is -M^-1*f, where f
+	// are the generalized forces of the actuator (from its path or its
+	// coordinate), which is far cheaper than realizing the accelerations
+	// of the whole model once per actuator.  Other actuators, and models
+	// with constraints, still perturb the accelerations, as do all
+	// actuators if setUseAnalyticConstraintMatrix(false) was called.
+	const SimTK::SimbodyMatterSubsystem& matter = _model->getMatterSubsystem();
+	bool unconstrained = s.getNMultipliers()==0;
+	SimTK::Vector_<SimTK::SpatialVec> bodyForces(matter.getNumBodies());
+	Vector mobilityForces(s.getNU()), generalizedForces(s.getNU()), udot(s.getNU());
+
+	const ForceSet& fSet = _model->getForceSet();
+	for(int i=0, p=0; i<fSet.getSize(); i++) {
+		Actuator* act = dynamic_cast<Actuator*>(&fSet.get(i));
+		if(!act) continue;
+
+		// Actuators that apply their (override) force as a tension along
+		// their path or to a coordinate. A McKibbenActuator computes its own
+		// force along the path and ignores the override.
+		const PathActuator* pathAct = dynamic_cast<const PathActuator*>(act);
+		if(dynamic_cast<const McKibbenActuator*>(act)) pathAct = NULL;
+		const CoordinateActuator* coordAct = dynamic_cast<CoordinateActuator*>(act);
+		const Coordinate* coord = coordAct ? coordAct->getCoordinate() : NULL;
+
+		if(_useAnalyticConstraintMatrix && unconstrained && (pathAct || coord)) {
+			bodyForces = SimTK::SpatialVec(SimTK::Vec3(0), SimTK::Vec3(0));
+			mobilityForces = 0;
+			if(pathAct) {
+				pathAct->getGeometryPath().addInEquivalentForces(s,
+					_optimalForce[p], bodyForces, mobilityForces);
+			} else {
+				matter.addInMobilityForce(s,
+					SimTK::MobilizedBodyIndex(coord->getBodyIndex()),
+					SimTK::MobilizerUIndex(coord->getMobilizerQIndex()),
+					_optimalForce[p], mobilityForces);
+			}
+			matter.multiplyBySystemJacobianTranspose(s, bodyForces, generalizedForces);
+			generalizedForces += mobilityForces;
+			matter.multiplyByMInv(s, generalizedForces, udot);
+			for(int c=0; c<nc; c++) _constraintMatrix(c,p) = -udot[_accelerationIndices[c]];
+		} else {
+			pVector[p] = 1;
+			computeConstraintVector(s, pVector, cVector);
+			for(int c=0; c<nc; c++) _constraintMatrix(c,p) = (cVector[c] - _constraintVector[c]);
+			pVector[p] = 0;
+		}
+		p++;
 	}
 #endif
 
@@ -646,6 +693,118 @@ constraintJacobian(const SimTK::Vector &parameters, const bool new_parameters, S
 
 	return 0;
 }
+//=============================================================================
+// QUADRATIC PROGRAM
+//=============================================================================
+//______________________________________________________________________________
+/**
+ * Solve the static optimization problem directly when the activation
+ * exponent is 2: minimize the sum of squared parameters subject to the
+ * linear acceleration constraints A*x + c = 0 and the parameter limits.
+ *
+ * Because the Hessian of the objective is a multiple of the identity, for
+ * given constraint multipliers lambda the parameters minimizing the
+ * Lagrangian within the limits are simply ~A*lambda clamped to the limits.
+ * The dual problem over lambda is therefore a small, concave, piecewise
+ * quadratic problem with one unknown per constraint.  It is solved by
+ * Newton's method, where each step is taken over the parameters that are
+ * not at a limit (the active set changes as the clamping changes), with a
+ * backtracking line search on the dual objective.  With the correct active
+ * set a single step solves the problem exactly, so only a few steps of
+ * cost O(nc^2*np) are needed.
+ *
+ * Requires the linear constraint matrix computed by prepareToOptimize().
+ *
+ * @param x Parameters; on return, the solution.
+ * @param lambda Constraint multipliers; used as the starting point, and on
+ * return, the multipliers of the solution.
+ * @param aMaxIterations Maximum number of Newton steps.
+ * @param aTolerance Tolerance on the constraint violation, relative to the
+ * size of the constant constraint term.
+ * @return Number of Newton steps taken, or -1 if no solution was found (the
+ * constraints may not be satisfiable within the limits).
+ */
+int StaticOptimizationTarget::
+optimizeQuadratic(Vector &x, Vector &lambda, int aMaxIterations,
+	double aTolerance) const
+{
+#ifdef USE_LINEAR_CONSTRAINT_MATRIX
+	int np = getNumParameters();
+	int nc = getNumConstraints();
+	double *lower=NULL, *upper=NULL;
+	if(getHasLimits()) getParameterLimits(&lower,&upper);
+	if(x.size()!=np) x.resize(np);
+	if(lambda.size()!=nc) {
+		lambda.resize(nc);
+		lambda = 0;
+	}
+
+	double tol = aTolerance*(1.0 + SimTK::max(SimTK::abs(_constraintVector)));
+	Vector residual(nc), trialX(np), trialLambda(nc), trialResidual(nc);
+	Vector step(nc);
+	Matrix hessian(nc,nc);
+	double dual = computeQuadraticDual(lambda,lower,upper,x,residual);
+
+	for(int iter=0; iter<aMaxIterations; iter++) {
+		if(SimTK::max(SimTK::abs(residual)) <= tol) return(iter);
+
+		// NEWTON STEP over the parameters not at a limit
+		hessian = 0;
+		Vector z = ~_constraintMatrix*lambda;
+		for(int p=0; p<np; p++) {
+			if(lower!=NULL && (z[p]<=lower[p] || z[p]>=upper[p])) continue;
+			for(int i=0; i<nc; i++) {
+				double aip = _constraintMatrix(i,p);
+				if(aip==0.0) continue;
+				for(int j=0; j<nc; j++) hessian(i,j) += aip*_constraintMatrix(j,p);
+			}
+		}
+		SimTK::FactorQTZ qtz(hessian);
+		qtz.solve(residual,step);
+
+		// BACKTRACK on the dual objective
+		double slope = ~residual*step;
+		if(!(slope>0.0)) return(-1);
+		double t = 1.0;
+		for(;;) {
+			trialLambda = lambda + t*step;
+			double trialDual = computeQuadraticDual(trialLambda,lower,upper,
+				trialX,trialResidual);
+			if(trialDual >= dual + 1.0e-4*t*slope) {
+				lambda = trialLambda;
+				x = trialX;
+				residual = trialResidual;
+				dual = trialDual;
+				break;
+			}
+			t *= 0.5;
+			if(t < 1.0e-10) return(-1);
+		}
+	}
+	return(SimTK::max(SimTK::abs(residual)) <= tol ? aMaxIterations : -1);
+#else
+	return(-1);
+#endif
+}
+//______________________________________________________________________________
+/**
+ * Evaluate the dual objective of the quadratic program for multipliers
+ * lambda, along with the parameters that minimize the Lagrangian within the
+ * limits and the resulting constraint violation.
+ */
+double StaticOptimizationTarget::
+computeQuadraticDual(const Vector &lambda, const double *lower,
+	const double *upper, Vector &x, Vector &residual) const
+{
+	x = ~_constraintMatrix*lambda;
+	if(lower!=NULL) {
+		for(int p=0; p<x.size(); p++)
+			x[p] = SimTK::clamp(lower[p],x[p],upper[p]);
+	}
+	residual = -(_constraintMatrix*x + _constraintVector);
+	return(0.5*(~x*x) + ~lambda*residual);
+}
+
 //=============================================================================
 // ACCELERATION
 //=============================================================================
@@ -670,8 +829,8 @@ computeAcceleration(SimTK::State& s, const SimTK::Vector &parameters,SimTK::Vect
          Actuator *act = dynamic_cast<Actuator*>(&fs.get(i));
 		 if( act ) {
              act->setOverrideForce(s,parameters[j]*_optimalForce[j]);
+             j++;
 		 }
-         j++;
     }
 
 	_model->getMultibodySystem().realize(s,SimTK::Stage::Acceleration);
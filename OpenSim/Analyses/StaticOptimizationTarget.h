@@ -65,6 +65,9 @@ private:
 	
 	SimTK::Matrix _constraintMatrix;
 	SimTK::Vector _constraintVector;
+	/** Whether columns of the constraint matrix are computed from the
+	generalized forces of the actuators where possible. */
+	bool _useAnalyticConstraintMatrix;
 
 	const Storage *_statesStore;
 	GCVSplineSet _statesSplineSet;
@@ -97,6 +100,12 @@ public:
 	double getActivationExponent() const { return _activationExponent; }
 	void setCurrentState( const SimTK::State* state) { _currentState = state; }
 	const SimTK::State* getCurrentState() const { return _currentState; }
+	/** Compute the columns of the constraint matrix for actuators acting
+	along a path or on a coordinate from their generalized forces (the
+	default), or, if false, by perturbing the accelerations of the model as
+	for every other actuator. */
+	void setUseAnalyticConstraintMatrix(bool aTrueFalse) { _useAnalyticConstraintMatrix = aTrueFalse; }
+	bool getUseAnalyticConstraintMatrix() const { return _useAnalyticConstraintMatrix; }
 
 	// UTILITY
 	void validatePerturbationSize(double &aSize);
@@ -114,6 +123,9 @@ public:
 
 	bool prepareToOptimize(SimTK::State& s, double *x);
 
+	int optimizeQuadratic(SimTK::Vector &x, SimTK::Vector &lambda,
+		int aMaxIterations, double aTolerance) const;
+
 	//--------------------------------------------------------------------------
 	// REQUIRED OPTIMIZATION TARGET METHODS
 	//--------------------------------------------------------------------------
@@ -125,6 +137,9 @@ public:
 private:
 	void computeConstraintVector(SimTK::State& s, const SimTK::Vector &x, SimTK::Vector &c) const;
 	void computeAcceleration(SimTK::State& s, const SimTK::Vector &aF,SimTK::Vector &rAccel) const;
+	double computeQuadraticDual(const SimTK::Vector &lambda,
+		const double *lower, const double *upper,
+		SimTK::Vector &x, SimTK::Vector &residual) const;
 	void cumulativeTime(double &aTime, double aIncrement);
 };
 
@@ -29,7 +29,14 @@
 
 
 #include "osimCommonDLL.h"
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
 #include "Exception.h"
 
 
@@ -53,11 +60,18 @@
  * assignment operator (=), equality operator (==), less than
  * operator (<), and the output operator (<<).
  *
+ * Lookups by name in arrays of Objects go through a hash from names to
+ * indices once the array holds a handful of elements. The hash is built on
+ * the first lookup and rebuilt after the array is changed or any Object is
+ * renamed, so the results are always those of a linear search.
+ *
  * @version 1.0
  * @author Frank C. Anderson
  */
 namespace OpenSim { 
 
+class Object;
+
 template<class T> class ArrayPtrs
 {
 //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -79,6 +93,32 @@ protected:
 	/** Array of pointers to objects of type T. */
 	T **_array;
 
+#ifndef SWIG
+private:
+	/** Smallest array for which lookups by name are hashed. */
+	enum { NAME_INDEX_MIN_SIZE = 8 };
+	/** Indices of the elements by name, with the name version of each
+	element (see Object::getNameVersion()) when the index was built. Only
+	the count of renames of all Objects up to which the versions were
+	checked is updated afterwards, so threads looking up names can share
+	an index. */
+	struct NameIndex {
+		explicit NameIndex(unsigned int aNameChangeCount) :
+			nameChangeCount(aNameChangeCount) {}
+		/** Count of renames (see Object::getNameChangeCount()) at which the
+		names of the elements were last known to match the index. */
+		mutable std::atomic<unsigned int> nameChangeCount;
+		/** Name version of each element. */
+		std::vector<unsigned int> nameVersions;
+		/** First element with each name. */
+		std::unordered_map<std::string,int> first;
+		/** All elements, in order, of names that are repeated. */
+		std::unordered_map<std::string,std::vector<int> > repeated;
+	};
+	/** Name index, built by the first lookup by name after a change. */
+	mutable std::shared_ptr<const NameIndex> _nameIndex;
+#endif
+
 //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 // METHODS
 //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -158,6 +198,7 @@ public:
  */
 void clearAndDestroy()
 {
+	invalidateNameIndex();
 	if(_array==NULL) return;
 	
 	int i;
@@ -193,6 +234,7 @@ ArrayPtrs<T>& operator=(const ArrayPtrs<T> &aArray)
 {
 	// DELETE OLD ARRAY
 	if(_memoryOwner) clearAndDestroy();
+	invalidateNameIndex();
 
 	// COPY MEMBER VARIABLES
 	_size = aArray._size;
@@ -516,6 +558,7 @@ bool setSize(int aSize)
 	if(aSize>_size) return(false);
 	if(aSize<0) aSize = 0;
 	if(aSize<_size) {
+		invalidateNameIndex();
 		int i;
 		for(i=(_size-1);i>=aSize;i--) {
 			if(_array[i]!=NULL) {
@@ -590,6 +633,24 @@ int getIndex(const std::string &aName,int aStartIndex=0) const
 	if(aStartIndex<0) aStartIndex=0;
 	if(aStartIndex>=getSize()) aStartIndex=0;
 
+#ifndef SWIG
+	// HASHED LOOKUP
+	std::shared_ptr<const NameIndex> index = getNameIndex();
+	if(index) {
+		typename std::unordered_map<std::string,int>::const_iterator
+			it = index->first.find(aName);
+		if(it==index->first.end()) return(-1);
+		if(aStartIndex<=it->second) return(it->second);
+		typename std::unordered_map<std::string,std::vector<int> >::
+			const_iterator rit = index->repeated.find(aName);
+		if(rit==index->repeated.end()) return(it->second);
+		const std::vector<int> &indices = rit->second;
+		std::vector<int>::const_iterator at =
+			std::lower_bound(indices.begin(),indices.end(),aStartIndex);
+		return((at==indices.end()) ? indices.front() : *at);
+	}
+#endif
+
 	// SEARCH STARTING FROM aStartIndex
 	int i;
 	for(i=aStartIndex;i<getSize();i++) {
@@ -604,6 +665,101 @@ int getIndex(const std::string &aName,int aStartIndex=0) const
 	return(-1);
 }
 
+#ifndef SWIG
+private:
+//_____________________________________________________________________________
+/**
+ * Get the current name index, building it if the array changed or one of
+ * its elements was renamed since it was last built. Renames of Objects that
+ * are not in the array cost one pass over the name versions of the
+ * elements, not a rebuild.
+ *
+ * @return The name index, or NULL if names are not hashed for this array.
+ */
+std::shared_ptr<const NameIndex> getNameIndex() const
+{
+	unsigned int count;
+	if(_size<NAME_INDEX_MIN_SIZE) return(std::shared_ptr<const NameIndex>());
+	typename std::is_base_of<Object,T>::type isObject;
+	if(!getNameChangeCount<T>(count,isObject)) {
+		return(std::shared_ptr<const NameIndex>());
+	}
+
+	std::shared_ptr<const NameIndex> index = std::atomic_load(&_nameIndex);
+	if(index) {
+		if(index->nameChangeCount.load()==count) return(index);
+		// An Object was renamed; the index holds unless it was one of ours.
+		// The count is read before the versions, so a rename made while
+		// checking is caught by the next lookup.
+		int i;
+		for(i=0;i<_size;i++) {
+			if(getNameVersion(_array[i],isObject)!=index->nameVersions[i])
+				break;
+		}
+		if(i==_size) {
+			index->nameChangeCount.store(count);
+			return(index);
+		}
+	}
+
+	// BUILD
+	std::shared_ptr<NameIndex> built(new NameIndex(count));
+	built->nameVersions.resize(_size);
+	for(int i=0;i<_size;i++) {
+		built->nameVersions[i] = getNameVersion(_array[i],isObject);
+		const std::string &name = _array[i]->getName();
+		std::pair<typename std::unordered_map<std::string,int>::iterator,bool>
+			result = built->first.insert(std::make_pair(name,i));
+		if(!result.second) {
+			std::vector<int> &indices = built->repeated[name];
+			if(indices.empty()) indices.push_back(result.first->second);
+			indices.push_back(i);
+		}
+	}
+	index = built;
+	std::atomic_store(&_nameIndex,index);
+	return(index);
+}
+//_____________________________________________________________________________
+/**
+ * Count of renames of Objects; names of other types are not hashed.
+ */
+template <class U>
+static bool getNameChangeCount(unsigned int &rCount,std::true_type)
+{
+	rCount = U::getNameChangeCount();
+	return(true);
+}
+template <class U>
+static bool getNameChangeCount(unsigned int &rCount,std::false_type)
+{
+	return(false);
+}
+//_____________________________________________________________________________
+/**
+ * Name version of an element (see Object::getNameVersion()).
+ */
+template <class U>
+static unsigned int getNameVersion(const U *aObject,std::true_type)
+{
+	return(aObject->getNameVersion());
+}
+template <class U>
+static unsigned int getNameVersion(const U *aObject,std::false_type)
+{
+	return(0);
+}
+//_____________________________________________________________________________
+/**
+ * Discard the name index after a change to the array.
+ */
+void invalidateNameIndex()
+{
+	std::atomic_store(&_nameIndex,std::shared_ptr<const NameIndex>());
+}
+public:
+#endif
+
 //-----------------------------------------------------------------------------
 // APPEND
 //-----------------------------------------------------------------------------
@@ -632,6 +788,7 @@ bool append(T *aObject)
 	}
 
 	// SET
+	invalidateNameIndex();
 	_array[_size] = aObject;
 	_size++;
 
@@ -706,6 +863,7 @@ bool insert(int aIndex,T *aObject)
 	}
 
 	// SHIFT ARRAY
+	invalidateNameIndex();
 	int i;
 	for(i=_size;i>aIndex;i--) {
 		_array[i] = _array[i-1];
@@ -745,6 +903,7 @@ bool remove(int aIndex)
 	}
 
 	// DELETE CURRENT OBJECT
+	invalidateNameIndex();
 	if(getMemoryOwner()&&(_array[aIndex]!=NULL)) delete _array[aIndex];
 
 	// SHIFT ARRAY
@@ -808,6 +967,7 @@ bool set(int aIndex,T *aObject)
 	}
 
 	// SET
+	invalidateNameIndex();
 	if(getMemoryOwner() && (_array[aIndex]!=NULL)) delete _array[aIndex];
 	_array[aIndex] = aObject;
 
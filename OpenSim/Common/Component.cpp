@@ -693,6 +693,80 @@ void Component::
 	}
 }
 
+// Resolve the locations in Y of a list of named state variables.
+Component::StateVariableLayout Component::
+	getStateVariableLayout(const SimTK::State& state,
+						   const Array<std::string>& names) const
+{
+	if(state.getSystemStage() < SimTK::Stage::Model){
+		throw Exception("Component::getStateVariableLayout: ERR- state must "
+			"be realized to Stage::Model.",__FILE__,__LINE__);
+	}
+
+	StateVariableLayout layout;
+	layout._topologyVersion = state.getSystemTopologyStageVersion();
+	layout._ny = state.getNY();
+	layout._yIndices.resize(names.getSize());
+	for(int i=0; i<names.getSize(); ++i){
+		const StateVariable* rsv = findStateVariable(names[i]);
+		if(!rsv){
+			std::stringstream msg;
+			msg << "Component::getStateVariableLayout: ERR- state named '"
+				<< names[i] << "' not found in " << getName() << " of type "
+				<< getConcreteClassName() << ".\n";
+			throw Exception(msg.str(),__FILE__,__LINE__);
+		}
+		SimTK::SystemYIndex yix = rsv->calcSystemYIndex(state);
+		if(!yix.isValid()){
+			throw Exception("Component::getStateVariableLayout: ERR- state '"
+				+ names[i] + "' is not held in the state's Y vector.",
+				__FILE__,__LINE__);
+		}
+		layout._yIndices[i] = yix;
+	}
+	return layout;
+}
+
+// Check that a layout was resolved for the system of this state.
+static void checkLayout(const SimTK::State& state,
+						SimTK::StageVersion version, int ny)
+{
+	if(state.getSystemTopologyStageVersion()!=version || state.getNY()!=ny){
+		throw Exception("Component: ERR- StateVariableLayout was resolved for "
+			"a different system. Call getStateVariableLayout() again.",
+			__FILE__,__LINE__);
+	}
+}
+
+// Gather the values of the state variables of a layout.
+void Component::
+	getStateVariableValues(const SimTK::State& state,
+		const StateVariableLayout& layout, SimTK::Vector& values) const
+{
+	checkLayout(state, layout._topologyVersion, layout._ny);
+	int n = layout.getSize();
+	values.resize(n);
+	const SimTK::Vector& y = state.getY();
+	for(int i=0; i<n; ++i){
+		values[i] = y[layout._yIndices[i]];
+	}
+}
+
+// Scatter values into the state variables of a layout.
+void Component::
+	setStateVariableValues(SimTK::State& state,
+		const StateVariableLayout& layout, const SimTK::Vector& values) const
+{
+	checkLayout(state, layout._topologyVersion, layout._ny);
+	int n = layout.getSize();
+	SimTK_ASSERT(values.size() >= n,
+		"Component::setStateVariableValues() fewer values than state variables in layout.");
+	SimTK::Vector& y = state.updY();
+	for(int i=0; i<n; ++i){
+		y[layout._yIndices[i]] = values[i];
+	}
+}
+
 // Set the derivative of a state variable computed by this Component by name.
 void Component::
 	setStateVariableDerivative(const State& state, 
@@ -855,7 +929,7 @@ getCacheVariableIndex(const std::string& name) const
     std::map<std::string, CacheInfo>::const_iterator it;
     it = _namedCacheVariableInfo.find(name);
 
-    return it->second.index;
+    return *it->second.index;
 }
 
 Array<std::string> Component::
@@ -941,7 +1015,7 @@ void Component::realizeTopology(SimTK::State& s) const
         for (it = (mutableThis->_namedCacheVariableInfo).begin(); 
              it != _namedCacheVariableInfo.end(); ++it){
             CacheInfo& ci = it->second;
-            ci.index = subSys.allocateLazyCacheEntry
+            *ci.index = subSys.allocateLazyCacheEntry
                (s, ci.dependsOnStage, ci.prototype->clone());
         }
     }
@@ -1027,6 +1101,16 @@ void Component::AddedStateVariable::setValue(SimTK::State& state, double value)
     throw Exception(msg.str(),__FILE__,__LINE__);
 }
 
+SimTK::SystemYIndex Component::AddedStateVariable::
+	calcSystemYIndex(const SimTK::State& state) const
+{
+	ZIndex zix(getVarIndex());
+	if(!getSubsysIndex().isValid() || !zix.isValid())
+		return SimTK::SystemYIndex();
+	return SimTK::SystemYIndex(state.getZStart()
+		+ state.getZStart(getSubsysIndex()) + zix);
+}
+
 double Component::AddedStateVariable::
 	getDerivative(const SimTK::State& state) const
 {
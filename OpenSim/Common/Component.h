@@ -514,6 +514,63 @@ public:
      */
 	void setStateVariableValues(SimTK::State& state, const SimTK::Vector& values);
 
+	/**
+	 * The locations in the State's Y vector of an ordered list of state
+	 * variables. A layout is resolved once by getStateVariableLayout(), after
+	 * which whole rows of values (e.g., the rows of a states Storage) are
+	 * moved into or out of a State by indexing, without looking up any names.
+	 * A layout stays valid until the system is recreated (e.g., by
+	 * Model::initSystem()); using it after that throws an Exception.
+	 */
+	class StateVariableLayout {
+	public:
+		StateVariableLayout() : _topologyVersion(-1), _ny(-1) {}
+		/** Number of state variables in the layout. */
+		int getSize() const { return (int)_yIndices.size(); }
+		/** Index in Y of the i-th state variable of the layout. */
+		int getSystemYIndex(int i) const { return _yIndices[i]; }
+	private:
+		friend class Component;
+		SimTK::Array_<int> _yIndices;
+		SimTK::StageVersion _topologyVersion;
+		int _ny;
+	};
+
+	/**
+	 * Resolve the locations in Y of the named state variables. Names are
+	 * interpreted as by getStateVariable(), and an Exception is thrown if one
+	 * cannot be found.
+	 *
+	 * @param state  a State realized to at least Stage::Model
+	 * @param names  the names of the state variables, in the order in which
+	 *               their values will be set or retrieved
+	 */
+	StateVariableLayout getStateVariableLayout(const SimTK::State& state,
+		const Array<std::string>& names) const;
+
+	/**
+	 * Get the values of the state variables of a layout.
+	 *
+	 * @param state   the State from which to get the values
+	 * @param layout  resolved by getStateVariableLayout()
+	 * @param values  resized to layout.getSize() and filled in layout order
+	 */
+	void getStateVariableValues(const SimTK::State& state,
+		const StateVariableLayout& layout, SimTK::Vector& values) const;
+
+	/**
+	 * Set the values of the state variables of a layout. The values are
+	 * written into Y as they are: unlike setStateVariable(), this does not
+	 * clamp or hold locked coordinates and does not enforce constraints, so
+	 * follow it with Model::assemble() when the values come from data.
+	 *
+	 * @param state   the State in which to set the values
+	 * @param layout  resolved by getStateVariableLayout()
+	 * @param values  at least layout.getSize() values in layout order
+	 */
+	void setStateVariableValues(SimTK::State& state,
+		const StateVariableLayout& layout, const SimTK::Vector& values) const;
+
 	/**
      * Get the value of a state variable derivative computed by this Component.
      *
@@ -541,6 +598,89 @@ public:
      */
     void setDiscreteVariable(SimTK::State& state, const std::string& name, double value) const;
 
+#ifndef SWIG
+    /**
+     * A typed handle to a cache variable of a Component, returned by
+     * addCacheVariable(). The accessors of Component that take a handle
+     * instead of a name (getCacheVariable(), updCacheVariable(),
+     * setCacheVariable(), isCacheVariableValid(), markCacheVariableValid()
+     * and markCacheVariableInvalid()) go straight to the cache entry in the
+     * State, skipping the lookup by name. A component that reads its cache
+     * variables during every realization keeps the handles as members and
+     * assigns them in addToSystem().
+     *
+     * The handle shares the CacheEntryIndex that the component fills in when
+     * the system is realized to Topology, so it stays valid however often
+     * the system is recreated, until addToSystem() adds the cache variable
+     * anew. A handle must only be used with the component that created it.
+     */
+    template <class T>
+    class CacheVariableHandle {
+    public:
+        CacheVariableHandle() {}
+        /** Whether the cache entry has been allocated in the system. */
+        bool isValid() const { return _index && _index->isValid(); }
+    private:
+        friend class Component;
+        explicit CacheVariableHandle(
+            const std::shared_ptr<SimTK::CacheEntryIndex>& index)
+        :   _index(index) {}
+        std::shared_ptr<const SimTK::CacheEntryIndex> _index;
+    };
+
+    /** @name Cache variable access by handle
+    These are equivalent to the accessors by name that follow, but go directly
+    to the cache entry identified by a CacheVariableHandle. **/
+    /**@{**/
+    template<typename T> const T&
+    getCacheVariable(const SimTK::State& state,
+                     const CacheVariableHandle<T>& handle) const
+    {
+        return static_cast<const SimTK::Value<T>&>(
+            getDefaultSubsystem().getCacheEntry(state, 
+                getCacheEntryIndex(handle))).get();
+    }
+    template<typename T> T&
+    updCacheVariable(const SimTK::State& state,
+                     const CacheVariableHandle<T>& handle) const
+    {
+        return static_cast<SimTK::Value<T>&>(
+            getDefaultSubsystem().updCacheEntry(state, 
+                getCacheEntryIndex(handle))).upd();
+    }
+    template<typename T> void
+    setCacheVariable(const SimTK::State& state,
+                     const CacheVariableHandle<T>& handle, const T& value) const
+    {
+        SimTK::CacheEntryIndex ceIndex = getCacheEntryIndex(handle);
+        static_cast<SimTK::Value<T>&>(
+            getDefaultSubsystem().updCacheEntry(state, ceIndex)).upd() = value;
+        getDefaultSubsystem().markCacheValueRealized(state, ceIndex);
+    }
+    template<typename T> bool
+    isCacheVariableValid(const SimTK::State& state,
+                         const CacheVariableHandle<T>& handle) const
+    {
+        return getDefaultSubsystem().isCacheValueRealized(state, 
+            getCacheEntryIndex(handle));
+    }
+    template<typename T> void
+    markCacheVariableValid(const SimTK::State& state,
+                           const CacheVariableHandle<T>& handle) const
+    {
+        getDefaultSubsystem().markCacheValueRealized(state, 
+            getCacheEntryIndex(handle));
+    }
+    template<typename T> void
+    markCacheVariableInvalid(const SimTK::State& state,
+                             const CacheVariableHandle<T>& handle) const
+    {
+        getDefaultSubsystem().markCacheValueNotRealized(state, 
+            getCacheEntryIndex(handle));
+    }
+    /**@}**/
+#endif
+
     /**
      * Get the value of a cache variable allocated by this Component by name.
      *
@@ -555,7 +695,7 @@ public:
         it = _namedCacheVariableInfo.find(name);
 
         if(it != _namedCacheVariableInfo.end()) {
-            SimTK::CacheEntryIndex ceIndex = it->second.index;
+            SimTK::CacheEntryIndex ceIndex = *it->second.index;
             return SimTK::Value<T>::downcast(
                 getDefaultSubsystem().getCacheEntry(state, ceIndex)).get();
         } else {
@@ -583,7 +723,7 @@ public:
         it = _namedCacheVariableInfo.find(name);
 
         if(it != _namedCacheVariableInfo.end()) {
-            SimTK::CacheEntryIndex ceIndex = it->second.index;
+            SimTK::CacheEntryIndex ceIndex = *it->second.index;
             return SimTK::Value<T>::downcast(
                 getDefaultSubsystem().updCacheEntry(state, ceIndex)).upd();
         }
@@ -613,7 +753,7 @@ public:
         it = _namedCacheVariableInfo.find(name);
 
         if(it != _namedCacheVariableInfo.end()) {
-            SimTK::CacheEntryIndex ceIndex = it->second.index;
+            SimTK::CacheEntryIndex ceIndex = *it->second.index;
             getDefaultSubsystem().markCacheValueRealized(state, ceIndex);
         }
         else{
@@ -648,7 +788,7 @@ public:
         it = _namedCacheVariableInfo.find(name);
 
         if(it != _namedCacheVariableInfo.end()) {
-            SimTK::CacheEntryIndex ceIndex = it->second.index;
+            SimTK::CacheEntryIndex ceIndex = *it->second.index;
             getDefaultSubsystem().markCacheValueNotRealized(state, ceIndex);
         }
         else{
@@ -676,7 +816,7 @@ public:
         it = _namedCacheVariableInfo.find(name);
 
         if(it != _namedCacheVariableInfo.end()) {
-            SimTK::CacheEntryIndex ceIndex = it->second.index;
+            SimTK::CacheEntryIndex ceIndex = *it->second.index;
             return getDefaultSubsystem().isCacheValueRealized(state, ceIndex);
         }
         else{
@@ -705,7 +845,7 @@ public:
         it = _namedCacheVariableInfo.find(name);
 
         if(it != _namedCacheVariableInfo.end()) {
-            SimTK::CacheEntryIndex ceIndex = it->second.index;
+            SimTK::CacheEntryIndex ceIndex = *it->second.index;
             SimTK::Value<T>::downcast(
                 getDefaultSubsystem().updCacheEntry( state, ceIndex)).upd() 
                 = value;
@@ -1198,16 +1338,19 @@ template <class T> friend class ComponentMeasure;
     @param[in]      dependsOnStage		
         This is the highest computational stage on which this cache entry's
         value computation depends. State changes at this level or lower will
-        invalidate the cache entry. **/ 
-    template <class T> void 
+        invalidate the cache entry. 
+    @returns a handle for fast access to the cache entry 
+        (see CacheVariableHandle). **/ 
+    template <class T> CacheVariableHandle<T> 
     addCacheVariable(const std::string&     cacheVariableName,
                      const T&               variablePrototype, 
                      SimTK::Stage           dependsOnStage) const
     {
         // Note, cache index is invalid until the actual allocation occurs 
         // during realizeTopology.
-        _namedCacheVariableInfo[cacheVariableName] = 
-            CacheInfo(new SimTK::Value<T>(variablePrototype), dependsOnStage);
+        CacheInfo& ci = _namedCacheVariableInfo[cacheVariableName];
+        ci = CacheInfo(new SimTK::Value<T>(variablePrototype), dependsOnStage);
+        return CacheVariableHandle<T>(ci.index);
     }
 
 	
@@ -1244,6 +1387,24 @@ template <class T> friend class ComponentMeasure;
     const SimTK::CacheEntryIndex 
     getCacheVariableIndex(const std::string& name) const;
 
+#ifndef SWIG
+    /** Get the index of the cache entry referred to by a handle. Throws if
+        the cache entry has not been allocated. */
+    template <class T> SimTK::CacheEntryIndex
+    getCacheEntryIndex(const CacheVariableHandle<T>& handle) const
+    {
+        if(!handle.isValid()) {
+            std::stringstream msg;
+            msg << "Component::getCacheEntryIndex: ERR- cache variable "
+                << "handle is not allocated.\n "
+                << "for component '"<< getName() << "' of type " 
+                << getConcreteClassName();
+            throw Exception(msg.str(),__FILE__,__LINE__);
+        }
+        return *handle._index;
+    }
+#endif
+
     // End of System Creation and Access Methods.
 
     /** Utility method to find a component in the list of sub components of this
@@ -1387,6 +1548,10 @@ protected:
 		// The derivative a state should be a cache entry and thus does not
 		// change the state
 		virtual void setDerivative(const SimTK::State& state, double deriv) const = 0;
+		// Where the value is held in the state's Y vector, if it is held there
+		// directly. Available once the state has been realized to Model.
+		virtual SimTK::SystemYIndex calcSystemYIndex(const SimTK::State& state) const
+		{	return SimTK::SystemYIndex(); }
 
 	private:
 		std::string name;
@@ -1475,6 +1640,7 @@ private:
 
 		double getDerivative(const SimTK::State& state) const override;
 		void setDerivative(const SimTK::State& state, double deriv) const override;
+		SimTK::SystemYIndex calcSystemYIndex(const SimTK::State& state) const override;
 
 		private: // DATA
 		// Changes in state variables trigger recalculation of appropriate cache 
@@ -1524,15 +1690,27 @@ private:
 
     // Structure to hold related info about cache variables 
     struct CacheInfo {
-        CacheInfo() {}
+        CacheInfo() : index(new SimTK::CacheEntryIndex()) {}
         CacheInfo(SimTK::AbstractValue* proto,
                   SimTK::Stage          dependsOn)
-        :   prototype(proto), dependsOnStage(dependsOn) {}
+        :   prototype(proto), dependsOnStage(dependsOn),
+            index(new SimTK::CacheEntryIndex()) {}
+        // A copy gets its own index so that allocating the cache entry of a
+        // copied component does not move the handles of the original.
+        CacheInfo(const CacheInfo& ci)
+        :   prototype(ci.prototype), dependsOnStage(ci.dependsOnStage),
+            index(new SimTK::CacheEntryIndex(*ci.index)) {}
+        CacheInfo& operator=(const CacheInfo& ci) {
+            prototype = ci.prototype;
+            dependsOnStage = ci.dependsOnStage;
+            *index = *ci.index;
+            return *this;
+        }
         // Model
         SimTK::ClonePtr<SimTK::AbstractValue>   prototype;
         SimTK::Stage                            dependsOnStage;
-        // System
-        SimTK::CacheEntryIndex                  index;
+        // System; shared with the CacheVariableHandles of this entry
+        std::shared_ptr<SimTK::CacheEntryIndex> index;
     };
 
     // Map names of modeling options for the Component to their underlying
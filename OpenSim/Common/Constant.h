@@ -90,6 +90,15 @@ public:
 	{
 		return _value;
 	}
+	using Function::calcDerivative;
+    virtual double calcValue(double xUnused) const
+	{
+		return _value;
+	}
+    virtual double calcDerivative(double xUnused, int derivOrder) const
+	{
+		return derivOrder==0 ? _value : 0.0;
+	}
 	const double getValue() const { return _value; }
     SimTK::Function* createSimTKFunction() const;
 //=============================================================================
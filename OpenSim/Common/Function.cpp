@@ -50,8 +50,7 @@ using SimTK::Vector;
  */
 Function::~Function()
 {
-    if (_function != NULL)
-        delete _function;
+    delete _function.load();
 }
 //_____________________________________________________________________________
 /**
@@ -160,37 +159,121 @@ evaluateTotalSecondDerivative(double aX,double aDxdt,double aD2xdt2)
 	return evaluate(1,aX) * aD2xdt2 + evaluate(2,aX) * aDxdt * aDxdt;
 }
 */
+const SimTK::Function& Function::getSimTKFunction() const
+{
+    SimTK::Function* function = _function.load(std::memory_order_acquire);
+    if (function == NULL) {
+        // Threads that get here together each create one; the first to
+        // store it wins and the others throw theirs away.
+        SimTK::Function* created = createSimTKFunction();
+        if (_function.compare_exchange_strong(function, created,
+                                              std::memory_order_acq_rel))
+            function = created;
+        else
+            delete created;
+    }
+    return *function;
+}
+
 double Function::calcValue(const Vector& x) const
 {
-    if (_function == NULL)
-        _function = createSimTKFunction();
-    return _function->calcValue(x);
+    return getSimTKFunction().calcValue(x);
 }
 
 double Function::calcDerivative(const std::vector<int>& derivComponents, const Vector& x) const
 {
-    if (_function == NULL)
-        _function = createSimTKFunction();
-    return _function->calcDerivative(derivComponents, x);
+    return getSimTKFunction().calcDerivative(derivComponents, x);
+}
+
+double Function::calcValue(double x) const
+{
+    return calcValue(Vector(1, x));
+}
+
+double Function::calcDerivative(double x, int derivOrder) const
+{
+    if (derivOrder == 0)
+        return calcValue(x);
+    return calcDerivative(std::vector<int>(derivOrder, 0), Vector(1, x));
 }
 
 int Function::getArgumentSize() const
 {
-    if (_function == NULL)
-        _function = createSimTKFunction();
-    return _function->getArgumentSize();
+    return getSimTKFunction().getArgumentSize();
 }
 
 int Function::getMaxDerivativeOrder() const
 {
-    if (_function == NULL)
-        _function = createSimTKFunction();
-    return _function->getMaxDerivativeOrder();
+    return getSimTKFunction().getMaxDerivativeOrder();
+}
+
+namespace {
+
+// Number of functions whose interval hints each thread remembers.
+const int NumIntervalHints = 64;
+
+struct IntervalHints {
+    const Function* owner[NumIntervalHints];
+    int interval[NumIntervalHints];
+};
+
+// Zero initialized: no owners, every interval 0.
+thread_local IntervalHints threadIntervalHints;
+
+} // namespace
+
+int& Function::getIntervalHint() const
+{
+    const size_t address = reinterpret_cast<size_t>(this);
+    const int slot = (int)(((address >> 4) ^ (address >> 10)) % NumIntervalHints);
+    IntervalHints& hints = threadIntervalHints;
+    if (hints.owner[slot] != this) {
+        hints.owner[slot] = this;
+        hints.interval[slot] = 0;
+    }
+    return hints.interval[slot];
+}
+
+int Function::findInterval(int n, const double *x, double aX, int& hint)
+{
+    int lo = hint;
+    if (lo < 0) lo = 0;
+    if (lo > n-2) lo = n-2;
+    int hi, step = 1;
+
+    // Hunt, in steps that double, for an interval that brackets aX.
+    if (aX >= x[lo]) {
+        hi = lo+1;
+        while (aX > x[hi]) {
+            lo = hi;
+            hi = lo + step;
+            step *= 2;
+            if (hi >= n-1) { hi = n-1; break; }
+        }
+    } else {
+        hi = lo;
+        lo = hi-1;
+        while (aX < x[lo]) {
+            hi = lo;
+            lo = hi - step;
+            step *= 2;
+            if (lo <= 0) { lo = 0; break; }
+        }
+    }
+
+    // Bisect the bracket down to a single interval.
+    while (hi-lo > 1) {
+        int k = (lo+hi)/2;
+        if (aX < x[k])
+            hi = k;
+        else
+            lo = k;
+    }
+    hint = lo;
+    return lo;
 }
 
 void Function::resetFunction()
 {
-    if (_function != NULL)
-        delete _function;
-    _function = NULL;
+    delete _function.exchange(NULL);
 }
@@ -37,6 +37,7 @@
 #include "PropertyDbl.h"
 #include "Property.h"
 #include "SimTKmath.h"
+#include <atomic>
 
 
 //=============================================================================
@@ -64,8 +65,10 @@ OpenSim_DECLARE_ABSTRACT_OBJECT(Function, Object);
 // DATA
 //=============================================================================
 protected:
-    // The SimTK::Function object implementing this function.
-    mutable SimTK::Function* _function;
+    // The SimTK::Function object implementing this function, created on
+    // first use. Atomic so that a const Function can be evaluated from
+    // several threads.
+    mutable std::atomic<SimTK::Function*> _function;
 
 //=============================================================================
 // METHODS
@@ -119,6 +122,25 @@ public:
      * @param x                the Vector of input arguments.  Its size must equal the value returned by getArgumentSize().
      */
     virtual double calcDerivative(const std::vector<int>& derivComponents, const SimTK::Vector& x) const;
+    /**
+     * Calculate the value of a function of one variable at a particular point.
+     * Callers need not construct an argument Vector, so functions that
+     * implement this natively (the splines, Constant, LinearFunction,
+     * PolynomialFunction, StepFunction, Sine) are evaluated without
+     * allocating any memory.  The default implementation calls
+     * calcValue(const SimTK::Vector&).
+     *
+     * @param x     the value of the independent variable.
+     */
+    virtual double calcValue(double x) const;
+    /**
+     * Calculate a derivative of a function of one variable at a particular
+     * point.  See calcValue(double).
+     *
+     * @param x           the value of the independent variable.
+     * @param derivOrder  the order of the derivative; 0 gives the value.
+     */
+    virtual double calcDerivative(double x, int derivOrder) const;
     /**
      * Get the number of components expected in the input vector.
      */
@@ -139,6 +161,33 @@ protected:
 	 * the internal SimTK::Function object used to evaluate it.
      */
     void resetFunction();
+    /**
+     * Get the internal SimTK::Function, creating it if necessary.
+     */
+    const SimTK::Function& getSimTKFunction() const;
+    /**
+     * Find the interval k of an increasing sequence of abscissae such that
+     * x[k] <= aX <= x[k+1], given that x[0] <= aX <= x[n-1] and n >= 2.
+     * The search hunts outward from the interval of a previous call, so
+     * evaluating a function at slowly increasing (or decreasing) values
+     * costs O(1) on average rather than a full binary search.
+     *
+     * @param n      the number of abscissae.
+     * @param x      the abscissae.
+     * @param aX     the value to locate.
+     * @param hint   the interval found by a previous call, e.g. from
+     *               getIntervalHint(); it is set to the interval found.
+     *               Any value is a valid place to start a search.
+     */
+    static int findInterval(int n, const double *x, double aX, int& hint);
+    /**
+     * The interval hint of this function on the calling thread.  Each
+     * thread keeps its own hints, so threads evaluating the same function
+     * in different ranges of its abscissae each start from where they last
+     * were.  Hints live in a small per-thread table keyed by the function;
+     * a function that finds its slot taken starts from interval 0.
+     */
+    int& getIntervalHint() const;
 
 //=============================================================================
 };	// END class Function
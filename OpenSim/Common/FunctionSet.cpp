@@ -113,17 +113,7 @@ setNull()
 double FunctionSet::
 evaluate(int aIndex,int aDerivOrder,double aX) const
 {
-	Function& func = get(aIndex);
-
-	SimTK::Vector arg = SimTK::Vector(1, aX);
-	if (aDerivOrder==0)
-		return (func.calcValue(arg));
-
-	std::vector<int> derivComponents;
-	for(int i=0; i<aDerivOrder; i++)
-		derivComponents.push_back(0);
-
-	return( func.calcDerivative(derivComponents, arg) );
+	return( get(aIndex).calcDerivative(aX,aDerivOrder) );
 }
 
 //_____________________________________________________________________________
@@ -146,16 +136,35 @@ evaluate(Array<double> &rValues,int aDerivOrder,double aX) const
 	rValues.setSize(size);
 
 	int i;
-	for(i=0;i<size;i++) {
-		Function& func = get(i);
-		if (aDerivOrder==0)
-			rValues[i] = func.calcValue(SimTK::Vector(1,aX));
-		else {
-			std::vector<int> derivComponents;
-			for(int j=0; j<aDerivOrder; j++)
-				derivComponents.push_back(0);
-			rValues[i] = func.calcDerivative(derivComponents, SimTK::Vector(1,aX));
-
+	for(i=0;i<size;i++)
+		rValues[i] = get(i).calcDerivative(aX,aDerivOrder);
+}
+//_____________________________________________________________________________
+/**
+ * Evaluate all the functions in the set, for several derivative orders, at
+ * each of an array of values of the independent variable.
+ *
+ * The results are written row by row: for each x, one row per derivative
+ * order (in the order given), each row holding the values of all functions
+ * in the set.  That is, the value of function f for derivative order
+ * aDerivOrders[d] at aX[i] is rValues[(i*aNumDerivs + d)*getSize() + f].
+ *
+ * @param aNumX Number of values of the independent variable.
+ * @param aX Values of the independent variable.
+ * @param aNumDerivs Number of derivative orders.
+ * @param aDerivOrders Derivative orders to evaluate (0 for the value).
+ * @param rValues Results; must hold aNumX*aNumDerivs*getSize() values.
+ */
+void FunctionSet::
+evaluate(int aNumX,const double *aX,int aNumDerivs,
+	const int *aDerivOrders,double *rValues) const
+{
+	int size = getSize();
+	for(int i=0;i<aNumX;i++) {
+		for(int d=0;d<aNumDerivs;d++) {
+			double *row = &rValues[(i*aNumDerivs + d)*size];
+			for(int f=0;f<size;f++)
+				row[f] = evaluate(f,aDerivOrders[d],aX[i]);
 		}
 	}
 }
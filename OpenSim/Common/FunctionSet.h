@@ -78,6 +78,9 @@ public:
 	virtual void
 		evaluate(Array<double> &rValues,int aDerivOrder,
 		double aX=0.0) const;
+	virtual void
+		evaluate(int aNumX,const double *aX,int aNumDerivs,
+		const int *aDerivOrders,double *rValues) const;
 
 //=============================================================================
 };	// END class FunctionSet
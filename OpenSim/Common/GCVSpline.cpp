@@ -71,8 +71,7 @@ GCVSpline() :
 	_x(_propX.getValueDblArray()),
 	_weights(_propWeights.getValueDblArray()),
 	_coefficients(_propCoefficients.getValueDblArray()),
-	_y(_propY.getValueDblArray()),
-	_workDeriv(1)
+	_y(_propY.getValueDblArray())
 {
 	setNull();
 }
@@ -102,8 +101,7 @@ GCVSpline(int aDegree,int aN,const double *aX,const double *aF,
 	_x(_propX.getValueDblArray()),
 	_weights(_propWeights.getValueDblArray()),
 	_coefficients(_propCoefficients.getValueDblArray()),
-	_y(_propY.getValueDblArray()),
-    _workDeriv(1)
+	_y(_propY.getValueDblArray())
 
 {
 	setNull();
@@ -146,6 +144,7 @@ GCVSpline(int aDegree,int aN,const double *aX,const double *aF,
 
 	// FIT THE SPLINE
 	_errorVariance = aErrorVariance;
+	updateCoefficients();
 }
 //_____________________________________________________________________________
 /**
@@ -162,8 +161,7 @@ GCVSpline(const GCVSpline &aSpline) :
 	_x(_propX.getValueDblArray()),
 	_weights(_propWeights.getValueDblArray()),
 	_coefficients(_propCoefficients.getValueDblArray()),
-	_y(_propY.getValueDblArray()),
-    _workDeriv(1)
+	_y(_propY.getValueDblArray())
 
 {
 	setEqual(aSpline);
@@ -275,6 +273,7 @@ void GCVSpline::updateFromXMLNode(SimTK::Xml::Element& aNode, int versionNumber)
 	// Coefficients may not have been specified in the XML file.
 	if (_coefficients.getSize() < _x.getSize())
 		_coefficients.setSize(_x.getSize());
+	updateCoefficients();
 }	
 
 //_____________________________________________________________________________
@@ -402,6 +401,8 @@ setDegree(int aDegree)
 		printf("\tSetting degree = 7 (heptic spline.)\n");
 		_halfOrder = 4;
 	}
+
+	updateCoefficients();
 }
 //_____________________________________________________________________________
 /**
@@ -549,7 +550,7 @@ setX(int aIndex, double aValue)
 {
 	if (aIndex >= 0 && aIndex < _x.getSize()) {
 		_x[aIndex] = aValue;
-        resetFunction();
+        updateCoefficients();
 	} else {
 		throw Exception("GCVSpline::setX(): index out of bounds.");
 	}
@@ -560,7 +561,7 @@ setY(int aIndex, double aValue)
 {
 	if (aIndex >= 0 && aIndex < _y.getSize()) {
 		_y[aIndex] = aValue;
-        resetFunction();
+        updateCoefficients();
 	} else {
 		throw Exception("GCVSpline::setY(): index out of bounds.");
 	}
@@ -607,7 +608,7 @@ deletePoint(int aIndex)
 	   _y.remove(aIndex);
 	   _weights.remove(aIndex);
 	   _coefficients.remove(aIndex);
-       resetFunction();
+       updateCoefficients();
        return true;
    }
 
@@ -636,7 +637,7 @@ deletePoints(const Array<int>& indices)
 
 		if (pointsDeleted) {
             // Recalculate the coefficients
-            resetFunction();
+            updateCoefficients();
 		}
 	}
 
@@ -662,7 +663,7 @@ addPoint(double aX, double aY)
 	}
 
 	// Recalculate the coefficients
-    resetFunction();
+    updateCoefficients();
 
 	return i;
 }
@@ -681,9 +682,107 @@ SimTK::Function* GCVSpline::createSimTKFunction() const {
     else
         spline = new SimTK::Spline(SimTK::SplineFitter<double>::fitFromErrorVariance(degree, x, y, _errorVariance).getSpline());
 
-	 int sz = _coefficients.getSize();
-    for (int i = 0; i < sz; ++i)
-        _coefficients[i] = spline->getControlPointValues()[i];
 	return spline;
 }
+//_____________________________________________________________________________
+/**
+ * Fit the spline to the current data, store its coefficients and make the
+ * fitted spline the function that is evaluated. This is done whenever the
+ * data change, so that evaluating a const spline, from any number of
+ * threads, only reads the coefficients. If the data cannot be fit, the
+ * function is left to be created, and the error reported, on first use.
+ */
+void GCVSpline::
+updateCoefficients()
+{
+	resetFunction();
+	if(_halfOrder<=0 || _x.getSize()<=0) return;
+
+	SimTK::Spline *spline;
+	try {
+		spline = (SimTK::Spline*)createSimTKFunction();
+	} catch(const std::exception&) {
+		return;
+	}
+	const Vector &values = spline->getControlPointValues();
+	_coefficients.setSize(_x.getSize());
+	int sz = _coefficients.getSize();
+	for(int i=0;i<sz && i<values.size();i++) _coefficients[i] = values[i];
+	_function.store(spline);
+}
 
+//_____________________________________________________________________________
+/**
+ * Make sure the spline has been fit to its current data. The fit is made
+ * whenever the data change, so this only fits again a spline whose data
+ * could not be fit then, and throws the error of that fit if it fails
+ * again. Once it returns, getCoefficients() holds the fitted coefficients.
+ */
+void GCVSpline::
+ensureFitted() const
+{
+	getSimTKFunction();
+}
+
+//_____________________________________________________________________________
+/**
+ * Evaluate the spline.
+ *
+ * @param x Vector holding the value of the independent variable.
+ * @return Value of the spline.
+ */
+double GCVSpline::
+calcValue(const Vector& x) const
+{
+	return calcDerivative(x[0],0);
+}
+//_____________________________________________________________________________
+/**
+ * Evaluate a derivative of the spline.
+ *
+ * @param derivComponents One entry (0) for each order of the derivative.
+ * @param x Vector holding the value of the independent variable.
+ * @return Value of the derivative.
+ */
+double GCVSpline::
+calcDerivative(const std::vector<int>& derivComponents,const Vector& x) const
+{
+	return calcDerivative(x[0],(int)derivComponents.size());
+}
+//_____________________________________________________________________________
+/**
+ * Evaluate the spline at a value of the independent variable.
+ *
+ * @param x Value of the independent variable.
+ * @return Value of the spline.
+ */
+double GCVSpline::
+calcValue(double x) const
+{
+	return calcDerivative(x,0);
+}
+//_____________________________________________________________________________
+/**
+ * Evaluate a derivative of the spline directly from its coefficients,
+ * without building an argument Vector.
+ *
+ * @param x Value of the independent variable.
+ * @param derivOrder Order of the derivative; 0 gives the value.
+ * @return Value of the derivative.
+ */
+double GCVSpline::
+calcDerivative(double x,int derivOrder) const
+{
+	int n = _x.getSize();
+	if(n<=0 || _coefficients.getSize()<n) return(SimTK::NaN);
+
+	ensureFitted();
+
+	// The half order is at most 4, so the workspace of 2*m fits on the stack.
+	// splder() searches for the knot interval starting from this thread's
+	// hint, first trying that interval and the one after it.
+	double work[8];
+	return splder(derivOrder,_halfOrder,n,x,
+		const_cast<double*>(_x.get()),const_cast<double*>(_coefficients.get()),
+		&getIntervalHint(),work);
+}
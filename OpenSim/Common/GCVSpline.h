@@ -113,8 +113,6 @@ protected:
 	constructor and are stored here so that the function can be scaled
 	later on. */
 	Array<double> &_y;
-	/** A workspace used when calculating derivatives of the spline. */
-	mutable std::vector<int> _workDeriv;
 
 //=============================================================================
 // METHODS
@@ -134,6 +132,7 @@ private:
 	void setNull();
 	void setupProperties();
 	void setEqual(const GCVSpline &aSpline);
+	void updateCoefficients();
 	virtual void init(Function* aFunction);
 
 	//--------------------------------------------------------------------------
@@ -167,10 +166,16 @@ public:
 	virtual bool deletePoints(const Array<int>& indices);
 	virtual int addPoint(double aX, double aY);
 	SimTK::Function* createSimTKFunction() const;
+	void ensureFitted() const;
 
 	//--------------------------------------------------------------------------
 	// EVALUATION
 	//--------------------------------------------------------------------------
+	double calcValue(const SimTK::Vector& x) const;
+	double calcDerivative(const std::vector<int>& derivComponents,
+		const SimTK::Vector& x) const;
+	double calcValue(double x) const;
+	double calcDerivative(double x,int derivOrder) const;
 
 //=============================================================================
 };	// END class GCVSpline
@@ -28,6 +28,8 @@
 
 // INCLUDES
 #include "GCVSplineSet.h"
+#include "gcvspl.h"
+#include <vector>
 
 
 //=============================================================================
@@ -95,9 +97,8 @@ GCVSplineSet(int aDegree,const Storage *aStore,double aErrorVariance)
 	setName(aStore->getName());
 
 	// CAPACITY
-	StateVector *vec = aStore->getStateVector(0);
-	if(vec==NULL) return;
-	ensureCapacity(2*vec->getSize());
+	if(aStore->getSize()<=0) return;
+	ensureCapacity(2*aStore->getSmallestNumberOfStates());
 
 	// CONSTRUCT
 	construct(aDegree,aStore,aErrorVariance);
@@ -145,8 +146,20 @@ construct(int aDegree,const Storage *aStore,double aErrorVariance)
 	for(int i=0;nData>0;i++) {
 
 		// GET TIMES AND DATA
-		nTime = aStore->getTimeColumn(times,i);
-		nData = aStore->getDataColumn(i,data);
+		// Column-major storages hand their contiguous columns to the
+		// spline directly.
+		const double *x,*y;
+		if(aStore->isColumnMajor()) {
+			if(i>=aStore->getSmallestNumberOfStates()) break;
+			x = aStore->getTimeView().data();
+			y = aStore->getColumnView(i).data();
+			nTime = nData = aStore->getSize();
+		} else {
+			nTime = aStore->getTimeColumn(times,i);
+			nData = aStore->getDataColumn(i,data);
+			x = times;
+			y = data;
+		}
 
 		// CHECK
 		if(nTime!=nData) {
@@ -167,7 +180,7 @@ construct(int aDegree,const Storage *aStore,double aErrorVariance)
 
 		// CONSTRUCT SPLINE
 		//printf("%s\t",name);
-		spline = new GCVSpline(aDegree,nData,times,data,name,aErrorVariance);
+		spline = new GCVSpline(aDegree,nData,x,y,name,aErrorVariance);
 		SimTK::Function* fp = spline->createSimTKFunction();
 		delete fp;  
 
@@ -327,3 +340,103 @@ double GCVSplineSet::getMaxX() const
 
 	return max;
 }
+
+
+//=============================================================================
+// EVALUATION
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Evaluate all the functions in the set, for several derivative orders, at
+ * each of an array of values of the independent variable.  See
+ * FunctionSet::evaluate() for the layout of the results.
+ *
+ * Splines that share the knot sequence and order of the first spline with
+ * data in the set (as all do when fit to the columns of one Storage) are
+ * evaluated together: a spline value is linear in the coefficients of the
+ * 2*m knots around x, so the interval of each x is found once and the
+ * weights of those coefficients are computed once per x and derivative
+ * order.  Each value is then a short sum over rows of a coefficient table
+ * that is contiguous across the splines, which the compiler can vectorize.
+ * Any other functions in the set are evaluated one at a time.
+ */
+void GCVSplineSet::
+evaluate(int aNumX,const double *aX,int aNumDerivs,
+	const int *aDerivOrders,double *rValues) const
+{
+	int size = getSize();
+	if(size<=0) return;
+
+	// SPLINES EVALUATED TOGETHER
+	const GCVSpline *first = NULL;
+	for(int f=0;f<size && first==NULL;f++) {
+		first = dynamic_cast<const GCVSpline*>(&get(f));
+		if(first!=NULL && first->getSize()<=0) first = NULL;
+	}
+	std::vector<int> batch, others;
+	for(int f=0;f<size;f++) {
+		const GCVSpline *spline = dynamic_cast<const GCVSpline*>(&get(f));
+		bool sameKnots = spline!=NULL && spline->getSize()>0 &&
+			spline->getHalfOrder()==first->getHalfOrder() &&
+			spline->getSize()==first->getSize();
+		for(int k=0;sameKnots && k<first->getSize();k++)
+			sameKnots = spline->getX()[k]==first->getX()[k];
+		if(sameKnots) batch.push_back(f);
+		else others.push_back(f);
+	}
+
+	// FUNCTIONS EVALUATED ONE AT A TIME
+	for(unsigned int j=0;j<others.size();j++) {
+		int f = others[j];
+		for(int i=0;i<aNumX;i++)
+			for(int d=0;d<aNumDerivs;d++)
+				rValues[(i*aNumDerivs + d)*size + f] =
+					FunctionSet::evaluate(f,aDerivOrders[d],aX[i]);
+	}
+	int nb = (int)batch.size();
+	if(nb==0) return;
+
+	// COEFFICIENT TABLE: one row per knot, one column per spline.
+	// A spline whose data could not be fit reports the error here.
+	int n = first->getSize();
+	int m = first->getHalfOrder();
+	std::vector<double> table(n*nb);
+	for(int b=0;b<nb;b++) {
+		const GCVSpline *spline = (const GCVSpline*)&get(batch[b]);
+		spline->ensureFitted();
+		const Array<double> &c = spline->getCoefficients();
+		for(int k=0;k<n;k++) table[k*nb + b] = c[k];
+	}
+
+	// WEIGHTS OF THE 2*m COEFFICIENTS AROUND EACH x
+	double *x = const_cast<double*>(first->getXValues());
+	std::vector<double> unit(n,0.0), work(2*m), weights(2*m), row(nb);
+	int l = 0;
+	for(int i=0;i<aNumX;i++) {
+		double t = aX[i];
+		search(n,x,t,&l);
+		for(int d=0;d<aNumDerivs;d++) {
+			for(int k=0;k<2*m;k++) {
+				int ck = l - m + k;
+				weights[k] = 0.0;
+				if(ck<0 || ck>=n) continue;
+				unit[ck] = 1.0;
+				weights[k] = splder(aDerivOrders[d],m,n,t,x,&unit[0],&l,&work[0]);
+				unit[ck] = 0.0;
+			}
+
+			for(int b=0;b<nb;b++) row[b] = 0.0;
+			for(int k=0;k<2*m;k++) {
+				int ck = l - m + k;
+				if(ck<0 || ck>=n || weights[k]==0.0) continue;
+				const double w = weights[k];
+				const double *coefficients = &table[ck*nb];
+				double *r = &row[0];
+				for(int b=0;b<nb;b++) r[b] += w*coefficients[b];
+			}
+
+			double *values = &rValues[(i*aNumDerivs + d)*size];
+			for(int b=0;b<nb;b++) values[batch[b]] = row[b];
+		}
+	}
+}
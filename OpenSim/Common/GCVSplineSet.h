@@ -84,6 +84,14 @@ public:
 	//--------------------------------------------------------------------------
 	Storage* constructStorage(int aDerivOrder,double aDX=-1);
 
+	//--------------------------------------------------------------------------
+	// EVALUATION
+	//--------------------------------------------------------------------------
+	using FunctionSet::evaluate;
+	virtual void
+		evaluate(int aNumX,const double *aX,int aNumDerivs,
+		const int *aDerivOrders,double *rValues) const;
+
 //=============================================================================
 };	// END class GCVSplineSet
 
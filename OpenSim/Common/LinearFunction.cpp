@@ -169,6 +169,18 @@ LinearFunction& LinearFunction::operator=(const LinearFunction &aLinearFunction)
 //=============================================================================
 // UTILITY
 //=============================================================================
+double LinearFunction::calcValue(double x) const
+{
+	return _coefficients[0]*x + _coefficients[1];
+}
+
+double LinearFunction::calcDerivative(double x, int derivOrder) const
+{
+	if (derivOrder == 0)
+		return calcValue(x);
+	return derivOrder==1 ? _coefficients[0] : 0.0;
+}
+
 SimTK::Function* LinearFunction::createSimTKFunction() const 
 {
 	SimTK::Vector coeffs(_coefficients.getSize(), &_coefficients[0]);
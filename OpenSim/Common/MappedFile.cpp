@@ -0,0 +1,104 @@
+/* -------------------------------------------------------------------------- *
+ *                          OpenSim:  MappedFile.cpp                          *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2012 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDES
+#include "MappedFile.h"
+#include "Exception.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace OpenSim;
+using namespace std;
+
+//=============================================================================
+// CONSTRUCTOR(S) AND DESTRUCTOR
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Map a file into memory for reading.
+ */
+MappedFile::MappedFile(const string &aFileName) :
+	_data(0),
+	_size(0)
+{
+#ifdef _WIN32
+	_mapHandle = 0;
+	_fileHandle = CreateFileA(aFileName.c_str(),GENERIC_READ,FILE_SHARE_READ,
+		0,OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL,0);
+	if(_fileHandle==INVALID_HANDLE_VALUE)
+		throw Exception("MappedFile: ERROR- failed to open file "+aFileName,
+			__FILE__,__LINE__);
+	LARGE_INTEGER size;
+	GetFileSizeEx((HANDLE)_fileHandle,&size);
+	_size = (size_t)size.QuadPart;
+	if(_size>0) {
+		_mapHandle = CreateFileMapping((HANDLE)_fileHandle,0,PAGE_READONLY,0,0,0);
+		if(_mapHandle)
+			_data = (const char*)MapViewOfFile((HANDLE)_mapHandle,FILE_MAP_READ,0,0,0);
+		if(!_data) {
+			if(_mapHandle) CloseHandle((HANDLE)_mapHandle);
+			CloseHandle((HANDLE)_fileHandle);
+			throw Exception("MappedFile: ERROR- failed to map file "+aFileName,
+				__FILE__,__LINE__);
+		}
+	}
+#else
+	int fd = open(aFileName.c_str(),O_RDONLY);
+	if(fd<0)
+		throw Exception("MappedFile: ERROR- failed to open file "+aFileName,
+			__FILE__,__LINE__);
+	struct stat info;
+	if(fstat(fd,&info)==0) _size = (size_t)info.st_size;
+	if(_size>0) {
+		void *data = mmap(0,_size,PROT_READ,MAP_PRIVATE,fd,0);
+		if(data==MAP_FAILED) {
+			close(fd);
+			throw Exception("MappedFile: ERROR- failed to map file "+aFileName,
+				__FILE__,__LINE__);
+		}
+		_data = (const char*)data;
+	}
+	// The mapping stays valid after the descriptor is closed.
+	close(fd);
+#endif
+}
+//_____________________________________________________________________________
+/**
+ * Destructor. Unmaps the file.
+ */
+MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+	if(_data) UnmapViewOfFile(_data);
+	if(_mapHandle) CloseHandle((HANDLE)_mapHandle);
+	CloseHandle((HANDLE)_fileHandle);
+#else
+	if(_data) munmap((void*)_data,_size);
+#endif
+}
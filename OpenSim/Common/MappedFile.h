@@ -0,0 +1,76 @@
+#ifndef _MappedFile_h_
+#define _MappedFile_h_
+/* -------------------------------------------------------------------------- *
+ *                          OpenSim:  MappedFile.h                            *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2012 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimCommonDLL.h"
+#include <string>
+#include <cstddef>
+
+namespace OpenSim {
+
+//=============================================================================
+//=============================================================================
+/**
+ * A read-only memory mapping of a whole file. Pages are read from disk by
+ * the operating system as they are first touched, so only the parts of the
+ * file that are accessed cost any I/O. The mapping is released when the
+ * object is destroyed.
+ */
+class OSIMCOMMON_API MappedFile
+{
+//=============================================================================
+// DATA
+//=============================================================================
+private:
+	/** Start of the mapped file, or 0 for an empty file. */
+	const char *_data;
+	/** Size of the file in bytes. */
+	size_t _size;
+#ifdef _WIN32
+	void *_fileHandle;
+	void *_mapHandle;
+#endif
+
+//=============================================================================
+// METHODS
+//=============================================================================
+public:
+	explicit MappedFile(const std::string &aFileName);
+	~MappedFile();
+
+	const char* getData() const { return _data; }
+	size_t getSize() const { return _size; }
+
+private:
+	// Not copyable; the object owns the mapping.
+	MappedFile(const MappedFile&);
+	MappedFile& operator=(const MappedFile&);
+
+//=============================================================================
+};	// END of class MappedFile
+
+}; //namespace
+//=============================================================================
+//=============================================================================
+
+#endif //__MappedFile_h__
@@ -28,9 +28,14 @@
 #include <fstream>
 #include <math.h>
 #include <float.h>
+#include <sstream>
+#include <vector>
 #include "MarkerData.h"
 #include "SimmIO.h"
 #include "SimmMacros.h"
+#include "TextDataParser.h"
+#include "StorageBinaryFile.h"
+#include "TimeIndex.h"
 #include "SimTKcommon.h"
 
 //=============================================================================
@@ -40,6 +45,17 @@ using namespace std;
 using namespace OpenSim;
 using SimTK::Vec3;
 
+namespace {
+	/** Times of the frames of a MarkerData, for TimeIndex. */
+	class FrameTimes {
+	public:
+		explicit FrameTimes(const ArrayPtrs<MarkerFrame> &aFrames) : _frames(aFrames) {}
+		double operator[](int aIndex) const { return _frames[aIndex]->getFrameTime(); }
+	private:
+		const ArrayPtrs<MarkerFrame> &_frames;
+	};
+}
+
 //=============================================================================
 // CONSTRUCTOR(S) AND DESTRUCTOR
 //=============================================================================
@@ -79,7 +95,9 @@ MarkerData::MarkerData(const string& aFileName) :
    int dot = (int)aFileName.find_last_of(".");
    suffix.assign(aFileName, dot+1, 3);
    SimTK::String sExtension(suffix);
-   if (sExtension.toLower() == "trc") 
+   if (StorageBinaryFile::isBinaryFile(aFileName))
+      readStoFile(aFileName);
+   else if (sExtension.toLower() == "trc") 
       readTRCFile(aFileName, *this);
    else if (sExtension.toLower() == "sto")
        readStoFile(aFileName);
@@ -131,8 +149,12 @@ void MarkerData::readTRCFile(const string& aFileName, MarkerData& aSMD)
 
    readTRCFileHeader(in, aFileName, aSMD);
 
-   /* read frame data */
-   while (getline(in, line))
+   /* read frame data, converting the rows in parallel from a memory map of
+    * the file if they form a plain tab-delimited table.
+    */
+   bool mapped = TextDataParser::getEnabled() &&
+      readTRCDataFromMap(aFileName, in.tellg(), aSMD);
+   while (!mapped && getline(in, line))
    {
       /* skip over any blank lines */
       if (findFirstNonWhiteSpace(line) == -1)
@@ -252,6 +274,50 @@ void MarkerData::readTRCFile(const string& aFileName, MarkerData& aSMD)
    in.close();
 }
 
+//_____________________________________________________________________________
+/**
+ * Read the frames of a TRC file through a TextDataParser. Empty fields are
+ * missing coordinates (NaN), as are markers missing at the end of a row, so
+ * every frame holds all of the markers.
+ *
+ * @param aFileName name of TRC file.
+ * @param aOffset offset of the first frame in the file.
+ * @param aSMD MarkerData object to hold the file contents
+ * @return false if the frames could not be read this way, in which case no
+ * frames were added.
+ */
+bool MarkerData::readTRCDataFromMap(const string& aFileName, streamoff aOffset, MarkerData& aSMD)
+{
+	int numFrames = aSMD._numFrames;
+	if (aOffset < 0 || numFrames <= 0)
+		return false;
+
+	// Columns are the frame number, the time, and three per marker.
+	int nc = 2 + 3*aSMD._numMarkers;
+	vector<double> block((size_t)nc*numFrames);
+	int nRead = -1;
+	try {
+		TextDataParser parser(aFileName);
+		nRead = parser.parseRows((size_t)aOffset, numFrames, nc, &block[0], numFrames, true);
+	} catch (const Exception&) {
+		nRead = -1;
+	}
+	if (nRead < 0)
+		return false;
+
+	for (int r = 0; r < nRead; r++) {
+		double frameNum = block[r];
+		MarkerFrame *frame = new MarkerFrame(aSMD._numMarkers,
+			SimTK::isNaN(frameNum) ? r+1 : (int)frameNum, block[numFrames+r], aSMD._units);
+		for (int m = 0; m < aSMD._numMarkers; m++) {
+			const double *x = &block[(size_t)(2+3*m)*numFrames + r];
+			frame->addMarker(Vec3(x[0], x[numFrames], x[2*numFrames]));
+		}
+		aSMD._frames.append(frame);
+	}
+	return true;
+}
+
 //_____________________________________________________________________________
 /**
  * Read TRC header.
@@ -496,7 +562,9 @@ void MarkerData::readStoFile(const string& aFileName)
 
     for (iter = markerIndices.begin(); iter != markerIndices.end(); iter++) {
         SimTK::String markerNameWithSuffix = iter->second;
-        size_t dotIndex = markerNameWithSuffix.toLower().find_last_of(".x");
+        // toLower() works in place; keep the case of the name itself.
+        SimTK::String lowerCaseName = markerNameWithSuffix;
+        size_t dotIndex = lowerCaseName.toLower().find_last_of(".x");
         SimTK::String candidateMarkerName = markerNameWithSuffix.substr(0, dotIndex-1);
         _markerNames.append(candidateMarkerName);
     }
@@ -511,6 +579,16 @@ void MarkerData::readStoFile(const string& aFileName)
 	_originalNumFrames = _numFrames;
 	_fileName = aFileName;
 	_units = Units(Units::Meters);
+	// Files written by printBinary() carry the units and rates.
+	if (store.getUnits().getType() != Units::UnknownUnits)
+		_units = store.getUnits();
+	string rate;
+	store.getValueForKey("DataRate", rate);
+	if (!rate.empty())
+		_dataRate = _originalDataRate = atof(rate.c_str());
+	store.getValueForKey("CameraRate", rate);
+	if (!rate.empty())
+		_cameraRate = atof(rate.c_str());
 
     double time;
     int sz = store.getSize();
@@ -570,33 +648,26 @@ void MarkerData::buildMarkerMap(const Storage& storageToReadFrom, std::map<int,
  */
 void MarkerData::findFrameRange(double aStartTime, double aEndTime, int& rStartFrame, int& rEndFrame) const
 {
-	int i;
-
-	rStartFrame = 0;
-	rEndFrame = _numFrames - 1;
-
 	if (aStartTime > aEndTime)
 	{
 		throw Exception("MarkerData: findFrameRange start time is past end time.");
 	}
 
-	for (i = _numFrames - 1; i >= 0 ; i--)
-	{
-		if (_frames[i]->getFrameTime() <= aStartTime)
-		{
-			rStartFrame = i;
-			break;
-		}
-	}
-
-	for (i = rStartFrame; i < _numFrames; i++)
-	{
-		if (_frames[i]->getFrameTime() >= aEndTime - SimTK::Zero)
-		{
-			rEndFrame = i;
-			break;
-		}
-	}
+	// The start frame is the last frame at or before aStartTime, the end
+	// frame the first one at or after aEndTime (but not before the start
+	// frame). TimeIndex finds both in O(1) for data recorded at a fixed
+	// rate, so this can be called every frame of IK.
+	FrameTimes times(_frames);
+	rStartFrame = TimeIndex::findLastAtOrBefore(times, _numFrames, aStartTime);
+	if (rStartFrame < 0)
+		rStartFrame = 0;
+
+	rEndFrame = TimeIndex::findFirstAtOrAfter(times, _numFrames,
+		aEndTime - SimTK::Zero, rStartFrame);
+	if (rEndFrame < rStartFrame)
+		rEndFrame = rStartFrame;
+	if (rEndFrame >= _numFrames)
+		rEndFrame = _numFrames - 1;
 }
 //_____________________________________________________________________________
 /**
@@ -808,6 +879,55 @@ void MarkerData::makeRdStorage(Storage& rStorage)
 	delete [] row;
 }
 
+//_____________________________________________________________________________
+/**
+ * Write the marker data in the binary storage format (see
+ * StorageBinaryFile). The coordinates of each marker are stored in columns
+ * labeled <name>.x, <name>.y and <name>.z, along with the units and the data
+ * and camera rates, so the file can be loaded again with MarkerData(aFileName).
+ *
+ * @param aFileName name of the file to write.
+ * @return false if the file could not be written.
+ */
+bool MarkerData::printBinary(const string& aFileName) const
+{
+	Storage storage(_numFrames);
+	storage.setColumnMajor(true);
+	storage.setName(_fileName);
+	storage.setUnits(_units);
+	ostringstream rate;
+	rate.precision(17);
+	rate << _dataRate;
+	storage.addKeyValuePair("DataRate", rate.str());
+	rate.str("");
+	rate << _cameraRate;
+	storage.addKeyValuePair("CameraRate", rate.str());
+
+	Array<string> columnLabels;
+	columnLabels.append("time");
+	for (int i = 0; i < _numMarkers; i++)
+	{
+		columnLabels.append(_markerNames[i] + ".x");
+		columnLabels.append(_markerNames[i] + ".y");
+		columnLabels.append(_markerNames[i] + ".z");
+	}
+	storage.setColumnLabels(columnLabels);
+
+	vector<double> row(3*_numMarkers + 1);
+	for (int i = 0; i < _numFrames; i++)
+	{
+		for (int j = 0; j < _numMarkers; j++)
+		{
+			SimTK::Vec3 marker = _frames[i]->getMarker(j);
+			for (int k = 0; k < 3; k++)
+				row[3*j + k] = marker[k];
+		}
+		storage.append(_frames[i]->getFrameTime(), 3*_numMarkers, &row[0]);
+	}
+
+	return storage.printBinary(aFileName);
+}
+
 //_____________________________________________________________________________
 /**
  * Convert all marker coordinates to the specified units.
@@ -79,6 +79,7 @@ public:
 	void averageFrames(double aThreshold = -1.0, double aStartTime = -SimTK::Infinity, double aEndTime = SimTK::Infinity);
 	const std::string& getFileName() const { return _fileName; }
 	void makeRdStorage(Storage& rStorage);
+	bool printBinary(const std::string& aFileName) const;
 	const MarkerFrame& getFrame(int aIndex) const;
 	int getMarkerIndex(const std::string& aName) const;
 	const Units& getUnits() const { return _units; }
@@ -94,6 +95,7 @@ public:
 private:
 	void readTRCFile(const std::string& aFileName, MarkerData& aSMD);
 	void readTRCFileHeader(std::ifstream &in, const std::string& aFileName, MarkerData& aSMD);
+	bool readTRCDataFromMap(const std::string& aFileName, std::streamoff aOffset, MarkerData& aSMD);
 	void readTRBFile(const std::string& aFileName, MarkerData& aSMD);
     void readStoFile(const std::string& aFileName);
     void buildMarkerMap(const Storage& storageToReadFrom, std::map<int, std::string>& markerNames);
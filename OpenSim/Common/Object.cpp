@@ -45,6 +45,7 @@
 #include <vector>
 #include <map>
 #include <algorithm>
+#include <atomic>
 
 using namespace OpenSim;
 using namespace std;
@@ -63,6 +64,9 @@ bool                        Object::_serializeAllDefaults=false;
 const string                Object::DEFAULT_NAME(ObjectDEFAULT_NAME);
 int                         Object::_debugLevel = 0;
 
+// Changes to the name of any Object, see getNameChangeCount().
+static std::atomic<unsigned int> nameChangeCount(0);
+
 //=============================================================================
 // CONSTRUCTOR(S)
 //=============================================================================
@@ -178,6 +182,9 @@ Object::Object(const Object &aObject)
 {
 	setNull();
 
+	// A copy is named when created rather than renamed.
+	_name = aObject._name;
+
 	// Use copy assignment operator to copy simple data members and the
     // property table; XML document is not copied and the new object is
     // marked "inlined", meaning it is not associated with an XML document.
@@ -205,6 +212,7 @@ Object& Object::
 operator=(const Object& source)
 {
     if (&source != this) {
+	    if(_name != source._name) { ++_nameVersion; ++nameChangeCount; }
 	    _name           = source._name;
         _description    = source._description;
         _authors        = source._authors;
@@ -233,6 +241,7 @@ setNull()
     _objectIsUpToDate = false;
 
 	_name           = "";
+	_nameVersion    = 0;
     _description    = "";
 	_authors        = "";
 	_references     = "";
@@ -327,9 +336,19 @@ operator<(const Object& other) const
 void Object::
 setName(const string &aName)
 {
+	if(_name != aName) { ++_nameVersion; ++nameChangeCount; }
 	_name = aName;
 }
 //_____________________________________________________________________________
+/**
+ * Get the number of times the name of any Object has been changed.
+ */
+unsigned int Object::
+getNameChangeCount()
+{
+	return(nameChangeCount.load());
+}
+//_____________________________________________________________________________
 /**
  * Get the name of this object.
  */
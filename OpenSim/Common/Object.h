@@ -276,6 +276,14 @@ public:
 	void setName(const std::string& name);
 	/** Get the name of this Object. */
 	const std::string& getName() const;
+	/** Number of times the name of any Object has been changed. Copying an
+	Object is not counted. Containers that index Objects by name compare
+	this count to know when to check getNameVersion() of their own
+	elements. */
+	static unsigned int getNameChangeCount();
+	/** Number of times the name of this Object has been changed. A copy
+	starts at zero. */
+	unsigned int getNameVersion() const { return _nameVersion; }
 	/** Set description, a one-liner summary. */
 	void setDescription(const std::string& description);
 	/** Get description, a one-liner summary. */
@@ -839,6 +847,8 @@ private:
 
 	// The name of this object.
 	std::string     _name;
+	// Number of changes to _name, see getNameVersion().
+	unsigned int    _nameVersion;
 	// A short description of the object.
 	std::string     _description;
 
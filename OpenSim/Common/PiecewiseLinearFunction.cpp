@@ -427,9 +427,13 @@ void PiecewiseLinearFunction::calcCoefficients()
 }
 
 double PiecewiseLinearFunction::calcValue(const Vector& x) const
+{
+    return calcValue(x[0]);
+}
+
+double PiecewiseLinearFunction::calcValue(double aX) const
 {
     int n = _x.getSize();
-    double aX = x[0];
 
     if (aX < _x[0])
         return _y[0] + (aX - _x[0]) * _b[0];
@@ -445,19 +449,9 @@ double PiecewiseLinearFunction::calcValue(const Vector& x) const
     else if (EQUAL_WITHIN_ERROR(aX,_x[n-1]))
         return _y[n-1];
 
-    // Do a binary search to find which two points the abscissa is between.
-    int k, i = 0;
-    int j = n;
-    while (1)
-    {
-        k = (i+j)/2;
-        if (aX < _x[k])
-            j = k;
-        else if (aX > _x[k+1])
-            i = k;
-        else
-            break;
-    }
+    // Find which two points the abscissa is between, starting from the
+    // interval of the previous evaluation.
+    int k = findInterval(n, _x.get(), aX, getIntervalHint());
 
     return _y[k] + (aX - _x[k]) * _b[k];
 }
@@ -466,11 +460,17 @@ double PiecewiseLinearFunction::calcDerivative(const std::vector<int>& derivComp
 {
     if (derivComponents.size() == 0)
         return SimTK::NaN;
-    if (derivComponents.size() > 1)
+    return calcDerivative(x[0], (int)derivComponents.size());
+}
+
+double PiecewiseLinearFunction::calcDerivative(double aX, int aDerivOrder) const
+{
+    if (aDerivOrder == 0)
+        return calcValue(aX);
+    if (aDerivOrder > 1)
         return 0.0;
 
     int n = _x.getSize();
-    double aX = x[0];
 
     if (aX < _x[0]) {
         return _b[0];
@@ -488,19 +488,9 @@ double PiecewiseLinearFunction::calcDerivative(const std::vector<int>& derivComp
         return _b[n-1];
     }
 
-    // Do a binary search to find which two points the abscissa is between.
-    int k, i = 0;
-    int j = n;
-    while (1)
-    {
-        k = (i+j)/2;
-        if (aX < _x[k])
-            j = k;
-        else if (aX > _x[k+1])
-            i = k;
-        else
-            break;
-    }
+    // Find which two points the abscissa is between, starting from the
+    // interval of the previous evaluation.
+    int k = findInterval(n, _x.get(), aX, getIntervalHint());
 
     return _b[k];
 }
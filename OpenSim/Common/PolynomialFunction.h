@@ -105,6 +105,30 @@ public:
 		return new SimTK::Function::Polynomial(get_coefficients());
 	}
 
+	using Function::calcValue;
+	using Function::calcDerivative;
+	/** Evaluate the polynomial at x by Horner's rule. */
+	virtual double calcValue(double x) const
+	{
+		return calcDerivative(x, 0);
+	}
+	/** Evaluate a derivative of the polynomial at x by Horner's rule
+	 *  applied to the coefficients of the derivative. */
+	virtual double calcDerivative(double x, int derivOrder) const
+	{
+		const SimTK::Vector& coefficients = get_coefficients();
+		int order = coefficients.size()-1;
+		double value = 0.0;
+		for (int i = 0; i <= order-derivOrder; ++i) {
+			int power = order-i;
+			double factor = 1.0;
+			for (int k = 0; k < derivOrder; ++k)
+				factor *= power-k;
+			value = value*x + factor*coefficients[i];
+		}
+		return value;
+	}
+
 private:
 	/**
 	* Construct the serializiable property member variables and
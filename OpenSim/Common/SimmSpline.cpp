@@ -512,6 +512,11 @@ int SimmSpline::addPoint(double aX, double aY)
 }
 
 double SimmSpline::calcValue(const Vector& x) const
+{
+	return calcValue(x[0]);
+}
+
+double SimmSpline::calcValue(double aX) const
 {
 	// NOT A NUMBER
 	if(!_y.getSize()) return(SimTK::NaN);
@@ -519,11 +524,10 @@ double SimmSpline::calcValue(const Vector& x) const
 	if(!_c.getSize()) return(SimTK::NaN);
 	if(!_d.getSize()) return(SimTK::NaN);
 
-    int i, j, k;
+    int k;
     double dx;
 
 	int n = _x.getSize();
-    double aX = x[0];
 
    /* Check if the abscissa is out of range of the function. If it is,
     * then use the slope of the function at the appropriate end point to
@@ -549,30 +553,10 @@ double SimmSpline::calcValue(const Vector& x) const
    else if (EQUAL_WITHIN_ERROR(aX,_x[n-1]))
        return _y[n-1];
 
-	if (n < 3)
-	{
-		/* If there are only 2 function points, then set k to zero
-		 * (you've already checked to see if the abscissa is out of
-		 * range or equal to one of the endpoints).
-		 */
-		k = 0;
-	}
-	else
-	{
-		/* Do a binary search to find which two points the abscissa is between. */
-		i = 0;
-		j = n;
-		while (1)
-		{
-			k = (i+j)/2;
-			if (aX < _x[k])
-				j = k;
-			else if (aX > _x[k+1])
-				i = k;
-			else
-				break;
-		}
-	}
+	/* Find which two points the abscissa is between, starting from the
+	 * interval of the previous evaluation.
+	 */
+	k = findInterval(n, _x.get(), aX, getIntervalHint());
 
    dx = aX - _x[k];
    return _y[k] + dx*(_b[k] + dx*(_c[k] + dx*_d[k]));
@@ -580,18 +564,24 @@ double SimmSpline::calcValue(const Vector& x) const
 
 double SimmSpline::calcDerivative(const std::vector<int>& derivComponents, const Vector& x) const
 {
+	return calcDerivative(x[0], (int)derivComponents.size());
+}
+
+double SimmSpline::calcDerivative(double aX, int aDerivOrder) const
+{
+	if (aDerivOrder == 0)
+		return calcValue(aX);
+
 	// NOT A NUMBER
 	if(!_y.getSize()) return(SimTK::NaN);
 	if(!_b.getSize()) return(SimTK::NaN);
 	if(!_c.getSize()) return(SimTK::NaN);
 	if(!_d.getSize()) return(SimTK::NaN);
 
-    int i, j, k;
+    int k;
     double dx;
 
 	int n = _x.getSize();
-    double aX = x[0];
-    int aDerivOrder = (int)derivComponents.size();
     if (aDerivOrder < 1 || aDerivOrder > 2)
 		throw Exception("SimmSpline::calcDerivative(): derivative order must be 1 or 2.");
 
@@ -639,30 +629,10 @@ double SimmSpline::calcDerivative(const std::vector<int>& derivComponents, const
          return 2.0*_c[n-1];
    }
 
-	if (n < 3)
-	{
-		/* If there are only 2 function points, then set k to zero
-		 * (you've already checked to see if the abscissa is out of
-		 * range or equal to one of the endpoints).
-		 */
-		k = 0;
-	}
-	else
-	{
-		/* Do a binary search to find which two points the abscissa is between. */
-		i = 0;
-		j = n;
-		while (1)
-		{
-			k = (i+j)/2;
-			if (aX < _x[k])
-				j = k;
-			else if (aX > _x[k+1])
-				i = k;
-			else
-				break;
-		}
-	}
+	/* Find which two points the abscissa is between, starting from the
+	 * interval of the previous evaluation.
+	 */
+	k = findInterval(n, _x.get(), aX, getIntervalHint());
 
    dx = aX - _x[k];
 
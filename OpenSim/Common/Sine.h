@@ -118,14 +118,22 @@ public:
 	//--------------------------------------------------------------------------
     virtual double calcValue(const SimTK::Vector& x) const
 	{
-		return _amplitude*sin(_omega*x[0] + _phase);
+		return calcValue(x[0]);
 	}
 	
 	double calcDerivative(const std::vector<int>& derivComponents, const SimTK::Vector& x) const
 	{
-		int n = (int)derivComponents.size();
+		return calcDerivative(x[0], (int)derivComponents.size());
+	}
 
-		return _amplitude*pow(_omega,n)*sin(_omega*x[0] + _phase + n*SimTK::Pi/2);
+    virtual double calcValue(double x) const
+	{
+		return _amplitude*sin(_omega*x + _phase);
+	}
+
+	double calcDerivative(double x, int n) const
+	{
+		return _amplitude*pow(_omega,n)*sin(_omega*x + _phase + n*SimTK::Pi/2);
 	}
 
 	SimTK::Function* createSimTKFunction() const {
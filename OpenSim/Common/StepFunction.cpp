@@ -179,6 +179,33 @@ StepFunction& StepFunction::operator=(const StepFunction &aStepFunction)
 //=============================================================================
 // UTILITY
 //=============================================================================
+// These match SimTK::Function::Step, which smooths the transition with
+// SimTK::stepUp().
+double StepFunction::calcValue(double x) const
+{
+	const double t = (x - _startTime) / (_endTime - _startTime);
+	if (t <= 0) return _startValue;
+	if (t >= 1) return _endValue;
+	return _startValue + (_endValue - _startValue)*SimTK::stepUp(t);
+}
+
+double StepFunction::calcDerivative(double x, int derivOrder) const
+{
+	if (derivOrder == 0)
+		return calcValue(x);
+
+	const double oneOverRange = 1.0 / (_endTime - _startTime);
+	const double t = (x - _startTime) * oneOverRange;
+	if (t <= 0 || t >= 1) return 0.0;
+	const double yRange = _endValue - _startValue;
+	switch (derivOrder) {
+		case 1: return yRange*SimTK::dstepUp(t)*oneOverRange;
+		case 2: return yRange*SimTK::d2stepUp(t)*oneOverRange*oneOverRange;
+		case 3: return yRange*SimTK::d3stepUp(t)*oneOverRange*oneOverRange*oneOverRange;
+		default: return 0.0;
+	}
+}
+
 SimTK::Function* StepFunction::createSimTKFunction() const 
 {
 	return new SimTK::Function::Step(_startValue, _endValue, _startTime, _endTime);
@@ -125,6 +125,10 @@ public:
 	//--------------------------------------------------------------------------
 	// EVALUATION
 	//--------------------------------------------------------------------------
+	using Function::calcValue;
+	using Function::calcDerivative;
+    virtual double calcValue(double x) const;
+    virtual double calcDerivative(double x, int derivOrder) const;
     virtual SimTK::Function* createSimTKFunction() const;
 
 //=============================================================================
@@ -30,17 +30,34 @@
 #include "osimCommonDLL.h"
 #include <sstream>
 #include <iostream>
+#include <algorithm>
+#include <climits>
 #include "IO.h"
 #include "Signal.h"
 #include "Storage.h"
 #include "GCVSplineSet.h"
 #include "SimmIO.h"
 #include "SimmMacros.h"
+#include "TextDataParser.h"
+#include "StorageBinaryFile.h"
+#include "StorageWriter.h"
+#include "TimeIndex.h"
 #include "SimTKcommon.h"
 
 using namespace OpenSim;
 using namespace std;
 
+namespace {
+	/** Time stamps of the rows of a row-major storage, for TimeIndex. */
+	class RowTimes {
+	public:
+		explicit RowTimes(const Array<StateVector> &aRows) : _rows(aRows) {}
+		double operator[](int aIndex) const { return _rows[aIndex].getTime(); }
+	private:
+		const Array<StateVector> &_rows;
+	};
+}
+
 
 //============================================================================
 // DEFINES
@@ -78,10 +95,12 @@ const int Storage::LatestVersion = 1;
 /**
  * Destructor.
  *
- * The stored StateVectors are deleted during destruction.
+ * The stored StateVectors are deleted during destruction, and the scratch
+ * file of a stream (see beginStreaming()) is removed.
  */
 Storage::~Storage()
 {
+	removeStreamFile();
 }
 
 //=============================================================================
@@ -113,14 +132,25 @@ Storage::Storage(int aCapacity,const string &aName) :
  *
  * @param aFileName Name of the file from which the Storage is to be
  * constructed.
+ * @param readHeadersOnly Only read the header and the column labels.
+ * @param aColumnMajor Keep the data in column-major form (see
+ * setColumnMajor()).
  */
-Storage::Storage(const string &aFileName, bool readHeadersOnly) :
+Storage::Storage(const string &aFileName, bool readHeadersOnly,
+				 bool aColumnMajor) :
 	StorageInterface(aFileName),
 	_storage(StateVector())
 {
 	// SET NULL STATES
 	setNull();
 
+	// BINARY FILE
+	if(StorageBinaryFile::isBinaryFile(aFileName)) {
+		if(aColumnMajor) setColumnMajor(true);
+		readBinary(aFileName, readHeadersOnly);
+		return;
+	}
+
 	// OPEN FILE
 	ifstream *fp = IO::OpenInputFile(aFileName);
 	if(fp==NULL) throw Exception("Storage: ERROR- failed to open file " + aFileName, __FILE__,__LINE__);
@@ -150,7 +180,14 @@ Storage::Storage(const string &aFileName, bool readHeadersOnly) :
 			<< _columnLabels.getSize() << "were found" << std::endl;
 	}
 	// CAPACITY
-	_storage.ensureCapacity(nr);
+	// In column-major mode the whole file goes into one block instead of
+	// nr separately allocated StateVectors.
+	if(aColumnMajor) {
+		setColumnMajor(true);
+		_columns.reserve(nr);
+	} else {
+		_storage.ensureCapacity(nr);
+	}
 	_storage.setCapacityIncrement(-1);
 
 	// There are situations where we don't want to read the whole file in advance just header
@@ -164,7 +201,14 @@ Storage::Storage(const string &aFileName, bool readHeadersOnly) :
 
 
 	// DATA	
-	if(indexTime != -1 || indexRange != -1){ //MM edit
+	// The rows are converted in parallel from a memory map of the file. If
+	// the body is not a plain table of numbers the stream is used instead.
+	bool hasTimeColumn = (indexTime != -1 || indexRange != -1);
+	if(TextDataParser::getEnabled() &&
+		readDataFromMap(aFileName, fp->tellg(), nr, nc, hasTimeColumn)) {
+		// CLOSE FILE
+		delete fp;
+	}else if(hasTimeColumn){ //MM edit
 		int ny = nc-1;
 		double time;
 		double *y = new double[ny];
@@ -225,6 +269,8 @@ Storage::Storage(const Storage &aStorage,bool aCopyData) :
 	setStepInterval(aStorage.getStepInterval());
 	setInDegrees(aStorage.isInDegrees());
 	_fileVersion = aStorage._fileVersion;
+	_columnMajor = aStorage._columnMajor;
+	_dataInColumns = _columnMajor;
 	// COPY STORED DATA
 	if(aCopyData) copyData(aStorage);
 }
@@ -258,6 +304,8 @@ Storage(const Storage &aStorage,int aStateIndex,int aN,
 	setStepInterval(aStorage.getStepInterval());
 	setInDegrees(aStorage.isInDegrees());
 	_fileVersion = aStorage._fileVersion;
+	_columnMajor = aStorage._columnMajor;
+	_dataInColumns = _columnMajor;
 	// ERROR CHECK
 	if(aStateIndex<0) return;
 	if(aN<=0) return;
@@ -265,7 +313,7 @@ Storage(const Storage &aStorage,int aStateIndex,int aN,
 	// SET THE DATA
 	int i,n;
 	double time,*data = new double[aN];
-	for(i=0;i<aStorage._storage.getSize();i++) {
+	for(i=0;i<aStorage.getSize();i++) {
 		aStorage.getTime(i,time);
 		n = aStorage.getData(i,aStateIndex,aN,data);
 		append(time,n,data);
@@ -280,6 +328,7 @@ Storage(const Storage &aStorage,int aStateIndex,int aN,
 		for(int i=0;i<aN && aStateIndex+1+i<originalNumCol;i++) 
 			_columnLabels.append(aStorage.getColumnLabels()[aStateIndex+1+i]);
 	}
+	updateColumnIndex();
 }
 
 
@@ -314,7 +363,15 @@ setNull()
 	_stepInterval = 1;
 	_lastI = 0;
 	_fp = 0;
+	_writer = 0;
+	_streamFP = 0;
+	_streamRowCountPos = -1;
+	_streamDataPos = -1;
+	_streamWindow = 0;
+	_numStreamedRows = 0;
 	_inDegrees = false;
+	_columnMajor = false;
+	_dataInColumns = false;
 }
 //_____________________________________________________________________________
 /**
@@ -326,6 +383,9 @@ setNull()
  *
  * If this instance does not have enough capicity to hold the states
  * of the specified storage (aStorage), the capacity is increased.
+ *
+ * The copy is held in column-major form if this storage is in column-major
+ * mode, regardless of the form in which aStorage holds its data.
  */
 void Storage::
 copyData(const Storage &aStorage)
@@ -333,7 +393,18 @@ copyData(const Storage &aStorage)
 	_units = aStorage._units;
 	setInDegrees(aStorage.isInDegrees());
 
+	// COPY COLUMNS
+	if(aStorage._dataInColumns) {
+		_storage.setSize(0);
+		_columns = aStorage._columns;
+		_dataInColumns = true;
+		if(!_columnMajor) ensureRows();
+		return;
+	}
+
 	// ENSURE CAPACITY
+	_columns.clear();
+	_dataInColumns = false;
 	_storage.ensureCapacity(aStorage._storage.getCapacity());
 
 	// COPY
@@ -342,6 +413,142 @@ copyData(const Storage &aStorage)
 	for(int i=0;i<aStorage._storage.getSize();i++) {
 		_storage.append(aStorage._storage[i]);
 	}
+	ensureColumns();
+}
+
+//=============================================================================
+// COLUMN-MAJOR MODE
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Set whether the data of this storage are kept in column-major form.
+ *
+ * In column-major mode all values are held in one contiguous StorageColumns
+ * block: one column of times followed by one column per state. Reading a
+ * large file then costs one allocation instead of one per row, and column
+ * operations work directly on contiguous memory. Column-major mode requires
+ * every row to have the same number of states; a storage with ragged rows
+ * stays in row form.
+ *
+ * The const accessors read either form without changing it. Asking a
+ * non-const storage for StateVector objects (getStateVector(),
+ * getLastStateVector(), and the methods built on them) converts the data
+ * back to rows; the const versions of those calls throw instead. Data that later replace the contents of the storage (copy,
+ * resample, reset to empty, ...) go back into column-major form as long as
+ * the mode is on.
+ *
+ * Changing the representation invalidates pointers returned by
+ * getStateVector() as well as views returned by getColumnView(),
+ * getRowView() and getTimeView().
+ *
+ * @param aTrueFalse Whether (true) or not (false) to keep the data in
+ * column-major form.
+ */
+void Storage::
+setColumnMajor(bool aTrueFalse)
+{
+	_columnMajor = aTrueFalse;
+	if(_columnMajor) ensureColumns();
+	else ensureRows();
+}
+//_____________________________________________________________________________
+/**
+ * Move the data from the column-major block into StateVector rows.
+ */
+void Storage::
+ensureRows()
+{
+	if(!_dataInColumns) return;
+
+	int nr = _columns.getNumRows();
+	int ns = _columns.getNumStates();
+	_storage.setSize(0);
+	_storage.ensureCapacity(nr);
+	std::vector<double> y(ns>0 ? ns : 1);
+	for(int i=0;i<nr;i++) {
+		_columns.getRow(i,ns,&y[0]);
+		_storage.append(StateVector(_columns.getTime(i),ns,&y[0]));
+	}
+	_columns.clear();
+	_dataInColumns = false;
+	std::lock_guard<std::mutex> lock(_columnRowsMutex);
+	_columnRows.clear();
+}
+//_____________________________________________________________________________
+/**
+ * Move the data from StateVector rows into the column-major block. Nothing
+ * is done if column-major mode is off or if the rows do not all have the
+ * same number of states.
+ */
+void Storage::
+ensureColumns()
+{
+	if(_dataInColumns || !_columnMajor) return;
+
+	int nr = _storage.getSize();
+	int ns = (nr>0) ? _storage[0].getSize() : 0;
+	for(int i=1;i<nr;i++) {
+		if(_storage[i].getSize()!=ns) return;
+	}
+
+	_columns.clear();
+	_columns.setNumStates(ns);
+	_columns.reserve(nr);
+	for(int i=0;i<nr;i++) {
+		_columns.appendRow(_storage[i].getTime(),_storage[i].getData().get());
+	}
+	_storage.setSize(0);
+	_storage.trim();
+	_dataInColumns = true;
+}
+//_____________________________________________________________________________
+/**
+ * Get a view of the time column. The storage must be in column-major form
+ * (see isColumnMajor()).
+ */
+StorageColumns::ColumnView Storage::
+getTimeView() const
+{
+	if(!_dataInColumns)
+		throw Exception("Storage.getTimeView: storage "+getName()+
+			" is not in column-major form.",__FILE__,__LINE__);
+	return(_columns.getTimeView());
+}
+//_____________________________________________________________________________
+/**
+ * Get a view of the data of a state (column) without copying it. The
+ * storage must be in column-major form (see isColumnMajor()).
+ *
+ * @param aStateIndex Index of the state (column).
+ */
+StorageColumns::ColumnView Storage::
+getColumnView(int aStateIndex) const
+{
+	if(!_dataInColumns)
+		throw Exception("Storage.getColumnView: storage "+getName()+
+			" is not in column-major form.",__FILE__,__LINE__);
+	if(aStateIndex<0 || aStateIndex>=_columns.getNumStates())
+		throw Exception("Storage.getColumnView: state index out of range.",
+			__FILE__,__LINE__);
+	return(_columns.getColumnView(aStateIndex));
+}
+//_____________________________________________________________________________
+/**
+ * Get a view of the states at a time index (row) without copying them. The
+ * storage must be in column-major form (see isColumnMajor()).
+ *
+ * @param aTimeIndex Time index (row).
+ */
+StorageColumns::RowView Storage::
+getRowView(int aTimeIndex) const
+{
+	if(!_dataInColumns)
+		throw Exception("Storage.getRowView: storage "+getName()+
+			" is not in column-major form.",__FILE__,__LINE__);
+	if(aTimeIndex<0 || aTimeIndex>=_columns.getNumRows())
+		throw Exception("Storage.getRowView: time index out of range.",
+			__FILE__,__LINE__);
+	return(_columns.getRowView(aTimeIndex));
 }
 
 
@@ -428,14 +635,53 @@ getHeaderToken() const
 const int Storage::
 getStateIndex(const std::string &aColumnName, int startIndex) const
 {
-	int size = _columnLabels.getSize();
-	for(int i=startIndex;i<size;i++)
-		if(_columnLabels[i]==aColumnName)
-			return(i-1);
+	unordered_map<string,int>::const_iterator it = _columnIndex.find(aColumnName);
+	if(it==_columnIndex.end()) return(-1);
+	if(it->second>=startIndex) return(it->second-1);
+
+	// A LATER COLUMN WITH THE SAME LABEL
+	vector< pair<string,int> >::const_iterator sorted = lower_bound(
+		_sortedColumnLabels.begin(),_sortedColumnLabels.end(),
+		make_pair(aColumnName,startIndex));
+	if(sorted!=_sortedColumnLabels.end() && sorted->first==aColumnName)
+		return(sorted->second-1);
 
 	return(-1);
 }
-
+//_____________________________________________________________________________
+/**
+ * Get the index of the first column with the specified label. Unlike
+ * getStateIndex(), the time column has index 0.
+ *
+ * @return Index of the column in getColumnLabels(), or -1 if no column has
+ * the label.
+ */
+int Storage::
+getColumnIndex(const std::string &aColumnName) const
+{
+	unordered_map<string,int>::const_iterator it = _columnIndex.find(aColumnName);
+	return (it==_columnIndex.end()) ? -1 : it->second;
+}
+//_____________________________________________________________________________
+/**
+ * Rebuild the label lookup tables used by getStateIndex(), getColumnIndex()
+ * and getColumnIndicesForIdentifier(). Must be called by every method that
+ * changes _columnLabels. Building the tables when the labels change, rather
+ * than on first use, keeps these const lookups safe to call from several
+ * threads.
+ */
+void Storage::
+updateColumnIndex()
+{
+	int n = _columnLabels.getSize();
+	_columnIndex.clear();
+	_sortedColumnLabels.resize(n);
+	for(int i=0;i<n;i++) {
+		_columnIndex.insert(make_pair(_columnLabels[i],i));
+		_sortedColumnLabels[i] = make_pair(_columnLabels[i],i);
+	}
+	sort(_sortedColumnLabels.begin(),_sortedColumnLabels.end());
+}
 
 //_____________________________________________________________________________
 /**
@@ -459,6 +705,7 @@ void Storage::
 parseColumnLabels(const char *aLabels)
 {
 	_columnLabels.setSize(0);
+	updateColumnIndex();
 
 	// HANDLE NULL POINTER
 	if(aLabels==NULL) return;
@@ -489,6 +736,7 @@ parseColumnLabels(const char *aLabels)
 	}
 
 	delete[] labelsCopy;
+	updateColumnIndex();
 }
 
 //_____________________________________________________________________________
@@ -499,6 +747,7 @@ void Storage::
 setColumnLabels(const Array<std::string> &aColumnLabels)
 {
 	_columnLabels = aColumnLabels;
+	updateColumnIndex();
 }
 
 //_____________________________________________________________________________
@@ -579,6 +828,9 @@ getCapacityIncrement() const
 int Storage::
 getSmallestNumberOfStates() const
 {
+	if(_dataInColumns)
+		return((_columns.getNumRows()>0) ? _columns.getNumStates() : 0);
+
 	int n,nmin=0;
 	for(int i=0;i<_storage.getSize();i++) {
 		n = _storage[i].getSize();
@@ -593,13 +845,18 @@ getSmallestNumberOfStates() const
 }
 //_____________________________________________________________________________
 /**
- * Get the last states stored.
+ * Get the last states stored. In column-major form this is a copy of the
+ * last row (see getColumnRow()).
  *
  * @return Statevector.  If no state vector is stored, NULL is returned.
  */
 StateVector* Storage::
 getLastStateVector() const
 {
+	if(_dataInColumns) {
+		int n = _columns.getNumRows();
+		return(n>0 ? getColumnRow(n-1) : NULL);
+	}
 	StateVector *vec = NULL;
 	try {
 		vec = &_storage.updLast();
@@ -615,13 +872,97 @@ getLastStateVector() const
  * @param aTimeIndex Time index at which to get the state vector:
  * 0 <= aTimeIndex < _storage.getSize().
  * @return Statevector. If no valid statevector exists at aTimeIndex, NULL
- * is returned.
+ * is returned. In column-major form this is a copy of the row (see
+ * getColumnRow()).
  */
 StateVector* Storage::
 getStateVector(int aTimeIndex) const
 {
+	if(_dataInColumns) {
+		if(aTimeIndex<0 || aTimeIndex>=_columns.getNumRows())
+			throw Exception("Storage.getStateVector: time index out of range.",
+				__FILE__,__LINE__);
+		return(getColumnRow(aTimeIndex));
+	}
 	return(&_storage.updElt(aTimeIndex));
 }
+//_____________________________________________________________________________
+/**
+ * Get a StateVector holding a copy of a row of the column-major data. Each
+ * time index has its own StateVector, so pointers returned for different
+ * rows do not alias and stay valid until the data are converted to rows.
+ * The copy is refreshed from the columns only when it differs from them,
+ * so concurrent const readers of an unchanged row never write to it.
+ *
+ * @param aTimeIndex Time index of the row: 0 <= aTimeIndex < getSize().
+ * @return Copy of the row.
+ */
+StateVector* Storage::
+getColumnRow(int aTimeIndex) const
+{
+	std::lock_guard<std::mutex> lock(_columnRowsMutex);
+	if((int)_columnRows.size()<_columns.getNumRows())
+		_columnRows.resize(_columns.getNumRows());
+	std::unique_ptr<StateVector> &row = _columnRows[aTimeIndex];
+	if(!row) row.reset(new StateVector());
+
+	int ns = _columns.getNumStates();
+	StorageColumns::RowView y = _columns.getRowView(aTimeIndex);
+	const Array<double> &data = row->getData();
+	bool current = row->getTime()==_columns.getTime(aTimeIndex) &&
+		data.getSize()==ns;
+	for(int j=0;current && j<ns;j++)
+		current = data[j]==y[j] || (SimTK::isNaN(data[j]) && SimTK::isNaN(y[j]));
+	if(!current) {
+		std::vector<double> values(ns>0 ? ns : 1);
+		for(int j=0;j<ns;j++) values[j] = y[j];
+		row->setStates(_columns.getTime(aTimeIndex),ns,&values[0]);
+	}
+	return(row.get());
+}
+//_____________________________________________________________________________
+/**
+ * Get the last states stored, converting column-major data to rows first
+ * (see setColumnMajor()).
+ *
+ * @return Statevector.  If no state vector is stored, NULL is returned.
+ */
+StateVector* Storage::
+getLastStateVector()
+{
+	ensureRows();
+	return(static_cast<const Storage*>(this)->getLastStateVector());
+}
+//_____________________________________________________________________________
+/**
+ * Get the StateVector at a specified time index, converting column-major
+ * data to rows first (see setColumnMajor()).
+ */
+StateVector* Storage::
+getStateVector(int aTimeIndex)
+{
+	ensureRows();
+	return(static_cast<const Storage*>(this)->getStateVector(aTimeIndex));
+}
+//_____________________________________________________________________________
+/**
+ * Get the time and the first aN states of a row, in either form, without
+ * changing the form.
+ *
+ * @return The time of the row.
+ */
+double Storage::
+getRow(int aTimeIndex,int aN,double *rY) const
+{
+	if(_dataInColumns) {
+		_columns.getRow(aTimeIndex,aN,rY);
+		return(_columns.getTime(aTimeIndex));
+	}
+	const StateVector &vec = _storage[aTimeIndex];
+	const Array<double> &data = vec.getData();
+	for(int i=0;i<aN;i++) rY[i] = data[i];
+	return(vec.getTime());
+}
 
 //-----------------------------------------------------------------------------
 // TIME
@@ -636,9 +977,10 @@ getStateVector(int aTimeIndex) const
 double Storage::
 getFirstTime() const
 {
-	if(_storage.getSize()<=0) {
+	if(getSize()<=0) {
 		return(SimTK::NaN);
 	}
+	if(_dataInColumns) return(_columns.getTime(0));
 	return(_storage[0].getTime());
 }
 //_____________________________________________________________________________
@@ -651,9 +993,10 @@ getFirstTime() const
 double Storage::
 getLastTime() const
 {
-	if(_storage.getSize()<=0) {
+	if(getSize()<=0) {
 		return(SimTK::NaN);
 	}
+	if(_dataInColumns) return(_columns.getTime(_columns.getNumRows()-1));
 	return(_storage.getLast().getTime());
 }
 //_____________________________________________________________________________
@@ -692,7 +1035,15 @@ bool Storage::
 getTime(int aTimeIndex,double &rTime,int aStateIndex) const
 {
 	if(aTimeIndex<0) return false;
-	if(aTimeIndex>_storage.getSize()) return false;
+	if(aTimeIndex>getSize()) return false;
+
+	// COLUMN-MAJOR
+	if(_dataInColumns) {
+		if(aTimeIndex>=_columns.getNumRows()) return false;
+		if(aStateIndex >= _columns.getNumStates()) return false;
+		rTime = _columns.getTime(aTimeIndex);
+		return true;
+	}
 
 	// GET STATEVECTOR
 	StateVector &vec = _storage[aTimeIndex];
@@ -721,11 +1072,19 @@ getTime(int aTimeIndex,double &rTime,int aStateIndex) const
 int Storage::
 getTimeColumn(double *&rTimes,int aStateIndex) const
 {
-	if(_storage.getSize()<=0) return(0);
+	if(getSize()<=0) return(0);
 
 	// ALLOCATE MEMORY
 	if(rTimes==NULL) {
-		rTimes = new double[_storage.getSize()];
+		rTimes = new double[getSize()];
+	}
+
+	// COLUMN-MAJOR
+	if(_dataInColumns) {
+		if(aStateIndex >= _columns.getNumStates()) return(0);
+		int n = _columns.getNumRows();
+		std::copy(_columns.getTimes(),_columns.getTimes()+n,rTimes);
+		return(n);
 	}
 
 	// LOOP THROUGH STATEVECTORS
@@ -744,9 +1103,18 @@ getTimeColumn(double *&rTimes,int aStateIndex) const
 int Storage::
 getTimeColumn(Array<double> &rTimes,int aStateIndex) const
 {
-	if(_storage.getSize()<=0) return(0);
+	if(getSize()<=0) return(0);
 
-	rTimes.setSize(_storage.getSize());
+	rTimes.setSize(getSize());
+
+	// COLUMN-MAJOR
+	if(_dataInColumns) {
+		int n = (aStateIndex >= _columns.getNumStates()) ? 0 :
+			_columns.getNumRows();
+		if(n>0) std::copy(_columns.getTimes(),_columns.getTimes()+n,&rTimes[0]);
+		rTimes.setSize(n);
+		return(n);
+	}
 
 	// LOOP THROUGH STATEVECTORS
 	int i,nTimes;
@@ -769,7 +1137,7 @@ getTimeColumn(Array<double> &rTimes,int aStateIndex) const
 void Storage::
 getTimeColumnWithStartTime(Array<double>& rTimes,double aStartTime) const
 {
-	if(_storage.getSize()<=0) return;
+	if(getSize()<=0) return;
 
 	int startIndex = findIndex(aStartTime);
 
@@ -797,7 +1165,14 @@ int Storage::
 getData(int aTimeIndex,int aStateIndex,double &rValue) const
 {
 	if(aTimeIndex<0) return(0);
-	if(aTimeIndex>=_storage.getSize()) return(0);
+	if(aTimeIndex>=getSize()) return(0);
+
+	// COLUMN-MAJOR
+	if(_dataInColumns) {
+		if(aStateIndex<0 || aStateIndex>=_columns.getNumStates()) return(0);
+		rValue = _columns.getValue(aTimeIndex,aStateIndex);
+		return(1);
+	}
 
 	// ASSIGNMENT
 	StateVector *vec = getStateVector(aTimeIndex);
@@ -814,7 +1189,19 @@ getData(int aTimeIndex,int aStateIndex,int aN,double **rData) const
 	if(aN<=0) return(0);
 	if(aStateIndex<0) return(0);
 	if(aTimeIndex<0) return(0);
-	if(aTimeIndex>=_storage.getSize()) return(0);
+	if(aTimeIndex>=getSize()) return(0);
+
+	// COLUMN-MAJOR
+	if(_dataInColumns) {
+		int size = _columns.getNumStates();
+		if(aStateIndex>=size) return(0);
+		int N = (aStateIndex+aN > size) ? size-aStateIndex : aN;
+		if(*rData==NULL) *rData = new double[N];
+		StorageColumns::RowView row = _columns.getRowView(aTimeIndex);
+		double *pData = *rData;
+		for(int i=0;i<N;i++) pData[i] = row[aStateIndex+i];
+		return(N);
+	}
 
 	// GET STATEVECTOR
 	StateVector *vec = getStateVector(aTimeIndex);
@@ -948,8 +1335,8 @@ getDataAtTime(double aT,int aN,double **rData) const
 {
 
 	// FIND THE CORRECT INTERVAL FOR aT
-	int i = findIndex(_lastI,aT);
-	if((i<0)||(_storage.getSize()<=0)) {
+	int i = findIndex(_lastI.load(std::memory_order_relaxed),aT);
+	if((i<0)||(getSize()<=0)) {
 		*rData = NULL;
 		return(0);
 	}
@@ -957,11 +1344,37 @@ getDataAtTime(double aT,int aN,double **rData) const
 	// CHECK FOR i AT END POINTS
 	int i1=i,i2=i+1;
 
-	if(i2==_storage.getSize()) {
+	if(i2==getSize()) {
 		i1--;  if(i1<0) i1=0;
 		i2--;  if(i2<0) i2=0;
 	}
 
+	// COLUMN-MAJOR
+	if(_dataInColumns) {
+		int ns = _columns.getNumStates();
+		double *y;
+		if(*rData==NULL) {
+			y = new double[ns];
+		} else {
+			y = *rData;
+			if(aN<ns)  ns = aN;
+		}
+		double t1 = _columns.getTime(i1);
+		double den = _columns.getTime(i2)-t1;
+		double pct = (den<SimTK::Eps) ? 0.0 : (aT-t1)/den;
+		StorageColumns::RowView y1 = _columns.getRowView(i1);
+		StorageColumns::RowView y2 = _columns.getRowView(i2);
+		for(i=0;i<ns;i++) {
+			if(pct==0.0) {
+				y[i] = y1[i];
+			} else {
+				y[i] = y1[i] + pct*(y2[i]-y1[i]);
+			}
+		}
+		*rData = y;
+		return(ns);
+	}
+
 	// STATES AT FIRST INDEX
 	int n1 = getStateVector(i1)->getSize();
 	double t1 = getStateVector(i1)->getTime();
@@ -1058,9 +1471,18 @@ getDataAtTime(double aT,int aN,SimTK::Vector& v) const
 int Storage::
 getDataColumn(int aStateIndex,double *&rData) const
 {
-	int n = _storage.getSize();
+	int n = getSize();
 	if(n<=0) return(0);
 
+	// COLUMN-MAJOR
+	if(_dataInColumns) {
+		if(aStateIndex<0 || aStateIndex>=_columns.getNumStates()) return(0);
+		if(rData==NULL) rData = new double[n];
+		const double *col = _columns.getColumn(aStateIndex);
+		std::copy(col,col+n,rData);
+		return(n);
+	}
+
 	// ALLOCATION
 	if(rData==NULL) {
 		rData = new double[n];
@@ -1079,9 +1501,20 @@ getDataColumn(int aStateIndex,double *&rData) const
 int Storage::
 getDataColumn(int aStateIndex,Array<double> &rData) const
 {
-	int n = _storage.getSize();
+	int n = getSize();
 	if(n<=0) return(0);
 
+	// COLUMN-MAJOR
+	if(_dataInColumns) {
+		if(aStateIndex<0 || aStateIndex>=_columns.getNumStates()) n = 0;
+		rData.setSize(n);
+		if(n>0) {
+			const double *col = _columns.getColumn(aStateIndex);
+			std::copy(col,col+n,&rData[0]);
+		}
+		return(n);
+	}
+
 	rData.setSize(n);
 
 	// ASSIGNMENT
@@ -1104,13 +1537,13 @@ getDataColumn(int aStateIndex,Array<double> &rData) const
 void Storage::
 getDataColumn(const std::string& columnName, Array<double>& rData, double aStartTime)
 {
-	if(_storage.getSize()<=0) return;
+	if(getSize()<=0) return;
 
 	int startIndex = findIndex(aStartTime);
 	int colIndex = getStateIndex(columnName);
 	double *dataVec=0;
 	getDataColumn(colIndex, dataVec);
-	for(int i=startIndex; i<_storage.getSize(); i++)
+	for(int i=startIndex; i<getSize(); i++)
 		rData.append(dataVec[i]);
 	delete[] dataVec;
 }
@@ -1129,12 +1562,19 @@ getDataColumn(const std::string& columnName, Array<double>& rData, double aStart
 void Storage::
 setDataColumn(int aStateIndex,const Array<double> &aData)
 {
-	int n = _storage.getSize();
+	int n = getSize();
 	if(n!=aData.getSize()) {
 		cout<<"Storage.setDataColumn: ERR- sizes don't match." << endl;
 		return;
 	}
 
+	// COLUMN-MAJOR
+	if(_dataInColumns) {
+		if(aStateIndex<0 || aStateIndex>=_columns.getNumStates()) return;
+		if(n>0) std::copy(aData.get(),aData.get()+n,_columns.updColumn(aStateIndex));
+		return;
+	}
+
 	// ASSIGNMENT
 	for(int i=0;i<n;i++) {
 		StateVector *vec = getStateVector(i);
@@ -1146,13 +1586,21 @@ setDataColumn(int aStateIndex,const Array<double> &aData)
  * set values in the column specified by columnName to newValue
  */
 void Storage::setDataColumnToFixedValue(const std::string& columnName, double newValue) {
-    int n = _storage.getSize();
+    int n = getSize();
     int aStateIndex = getStateIndex(columnName);
 	if(aStateIndex==-1) {
 		cout<<"Storage.setDataColumnToFixedValue: ERR- column not found." << endl;
 		return;
 	}
 
+	// COLUMN-MAJOR
+	if(_dataInColumns) {
+		if(aStateIndex>=_columns.getNumStates()) return;
+		double *col = _columns.updColumn(aStateIndex);
+		std::fill(col,col+n,newValue);
+		return;
+	}
+
 	// ASSIGNMENT
 	for(int i=0;i<n;i++) {
 		StateVector *vec = getStateVector(i);
@@ -1203,7 +1651,8 @@ void Storage::getDataForIdentifier(const std::string& identifier, Array<Array<do
 	}
 	/* a row of "data" can be shorter than number of columns if time is the first column, since 
 	   that is not considered a state by storage. Need to fix this! -aseth */
-	int nd = getLastStateVector()->getSize();
+	int nd = _dataInColumns ? _columns.getNumStates() :
+		getLastStateVector()->getSize();
 	int off = _columnLabels.getSize()-nd;
 
 
@@ -1225,12 +1674,18 @@ OpenSim::Array<int>  Storage::getColumnIndicesForIdentifier(const std::string& i
 	if(lid < 1) // an empty identifier should not expect data back
 		return found;
 
-	int startIndex = 0;
-	int size = _columnLabels.getSize();
-	for(int i=startIndex;i<size;++i){
-		if(_columnLabels[i].compare(0,lid, identifier)==0)
-			found.append(i);
+	// Labels starting with the identifier are adjacent in the sorted labels.
+	vector< pair<string,int> >::const_iterator it = lower_bound(
+		_sortedColumnLabels.begin(),_sortedColumnLabels.end(),
+		make_pair(identifier,INT_MIN));
+	vector<int> indices;
+	for(;it!=_sortedColumnLabels.end();++it) {
+		if(it->first.compare(0,lid, identifier)!=0) break;
+		indices.push_back(it->second);
 	}
+	sort(indices.begin(),indices.end());
+	for(unsigned i=0;i<indices.size();++i)
+		found.append(indices[i]);
 	return found;
 }
 //=============================================================================
@@ -1253,11 +1708,30 @@ OpenSim::Array<int>  Storage::getColumnIndicesForIdentifier(const std::string& i
 int Storage::
 reset(int aIndex)
 {
-	if(aIndex>=_storage.getSize()) return(_storage.getSize());
 	if(aIndex<0) aIndex = 0;
-	_storage.setSize(aIndex);
 
-	return(_storage.getSize());
+	// START THE STREAM FILE OVER
+	if(aIndex==0 && _numStreamedRows>0) {
+		string fileName = _streamFileName;
+		bool streaming = isStreaming();
+		removeStreamFile();
+		if(streaming) beginStreaming(fileName,_streamWindow);
+	}
+
+	// AN EMPTY STORAGE GOES BACK TO COLUMN-MAJOR FORM IF REQUESTED
+	if(aIndex==0 && _columnMajor && !_dataInColumns) {
+		_storage.setSize(0);
+		_storage.trim();
+		_columns.clear();
+		_dataInColumns = true;
+		return(0);
+	}
+
+	if(aIndex>=getSize()) return(getSize());
+	if(_dataInColumns) _columns.resize(aIndex);
+	else _storage.setSize(aIndex);
+
+	return(getSize());
 }
 //_____________________________________________________________________________
 /**
@@ -1289,6 +1763,18 @@ crop(const double newStartTime, const double newFinalTime)
 {
 	int startindex = findIndex(newStartTime); 
 	int finalindex = findIndex(newFinalTime); 
+
+	// COLUMN-MAJOR
+	if(_dataInColumns) {
+		if(finalindex<startindex) {
+			cout<<"Storage.crop: WARNING: No rows will be left." << endl;
+			_columns.resize(0);
+			return;
+		}
+		_columns.resize(finalindex+1);
+		_columns.removeRows(0,startindex);
+		return;
+	}
 	// Since underlying Array is packed we'll just move what we need up then 
 	// delete remaining rows in reverse order.
 	int numRowsToKeep=finalindex-startindex+1;
@@ -1316,6 +1802,17 @@ crop(const double newStartTime, const double newFinalTime)
 int Storage::
 append(const StateVector &aStateVector,bool aCheckForDuplicateTime)
 {
+	// COLUMN-MAJOR
+	if(appendToColumns(aStateVector.getTime(),aStateVector.getSize(),
+			aStateVector.getData().get(),aCheckForDuplicateTime)) {
+		if (_fp!=0){
+			aStateVector.print(_fp);
+			fflush(_fp);
+		}
+		checkStreamWindow();
+		return(getSize());
+	}
+
 	// TODO: use some tolerance when checking for duplicate time?
 	if(aCheckForDuplicateTime && _storage.getSize() && _storage.getLast().getTime()==aStateVector.getTime())
 		_storage.updLast() = aStateVector;
@@ -1326,7 +1823,8 @@ append(const StateVector &aStateVector,bool aCheckForDuplicateTime)
 		aStateVector.print(_fp);
 		fflush(_fp);
 	}
-	return(_storage.getSize());
+	checkStreamWindow();
+	return(getSize());
 }
 //_____________________________________________________________________________
 /**
@@ -1341,9 +1839,13 @@ append(const StateVector &aStateVector,bool aCheckForDuplicateTime)
 int Storage::
 append(const Array<StateVector> &aStorage)
 {
-	for(int i=0; i<aStorage.getSize(); i++)
-		_storage.append(aStorage[i]);
-	return(_storage.getSize());
+	for(int i=0; i<aStorage.getSize(); i++) {
+		if(!appendToColumns(aStorage[i].getTime(),aStorage[i].getSize(),
+				aStorage[i].getData().get(),false))
+			_storage.append(aStorage[i]);
+	}
+	checkStreamWindow();
+	return(getSize());
 }
 //_____________________________________________________________________________
 /**
@@ -1357,8 +1859,19 @@ append(const Array<StateVector> &aStorage)
 int Storage::
 append(double aT,int aN,const double *aY,bool aCheckForDuplicateTime)
 {
-	if(aY==NULL) return(_storage.getSize());
-	if(aN<0) return(_storage.getSize());
+	if(aY==NULL) return(getSize());
+	if(aN<0) return(getSize());
+
+	// COLUMN-MAJOR
+	// Values go straight into the block without building a StateVector.
+	if(appendToColumns(aT,aN,aY,aCheckForDuplicateTime)) {
+		if (_fp!=0){
+			StateVector(aT,aN,aY).print(_fp);
+			fflush(_fp);
+		}
+		checkStreamWindow();
+		return(getSize());
+	}
 
 	// APPEND
 	StateVector vec(aT,aN,aY);
@@ -1370,7 +1883,34 @@ append(double aT,int aN,const double *aY,bool aCheckForDuplicateTime)
 	else
 		_storage.append(vec);
 	*/
-	return(_storage.getSize());
+	return(getSize());
+}
+//_____________________________________________________________________________
+/**
+ * Append a row to the column-major block.
+ *
+ * @return true if the row was appended; false if the data are held in rows.
+ * A row whose number of states differs from that of the block converts the
+ * data to rows and false is returned.
+ */
+bool Storage::
+appendToColumns(double aT,int aN,const double *aY,bool aCheckForDuplicateTime)
+{
+	if(!_dataInColumns) return(false);
+
+	int nr = _columns.getNumRows();
+	if(nr==0) _columns.setNumStates(aN);
+	if(aN!=_columns.getNumStates()) {
+		ensureRows();
+		return(false);
+	}
+
+	// TODO: use some tolerance when checking for duplicate time?
+	if(aCheckForDuplicateTime && nr && _columns.getTime(nr-1)==aT)
+		_columns.setRow(nr-1,aT,aY);
+	else
+		_columns.appendRow(aT,aY);
+	return(true);
 }
 //_____________________________________________________________________________
 /**
@@ -1416,12 +1956,12 @@ append(double aT,const Array<double>& aY,bool aCheckForDuplicateTime)
 int Storage::
 store(int aStep,double aT,int aN,const double *aY)
 {
-	if(_stepInterval==0) return(_storage.getSize());
+	if(_stepInterval==0) return(getSize());
 	if((aStep%_stepInterval) == 0) {
 		append(aT,aN,aY);
 	}
 
-	return(_storage.getSize());
+	return(getSize());
 }
 
 
@@ -1440,6 +1980,11 @@ store(int aStep,double aT,int aN,const double *aY)
 void Storage::
 shiftTime(double aValue)
 {
+	if(_dataInColumns) {
+		double *t = _columns.updTimes();
+		for(int i=0;i<_columns.getNumRows();i++) t[i] += aValue;
+		return;
+	}
 	for(int i=0;i<_storage.getSize();i++) {
 		_storage[i].shiftTime(aValue);
 	}
@@ -1453,6 +1998,11 @@ shiftTime(double aValue)
 void Storage::
 scaleTime(double aValue)
 {
+	if(_dataInColumns) {
+		double *t = _columns.updTimes();
+		for(int i=0;i<_columns.getNumRows();i++) t[i] *= aValue;
+		return;
+	}
 	for(int i=0;i<_storage.getSize();i++) {
 		_storage[i].scaleTime(aValue);
 	}
@@ -1471,6 +2021,7 @@ scaleTime(double aValue)
 void Storage::
 add(double aValue)
 {
+	ensureRows();
 	for(int i=0;i<_storage.getSize();i++) {
 		_storage[i].add(aValue);
 	}
@@ -1486,6 +2037,7 @@ add(double aValue)
 void Storage::
 add(int aN, double aValue)
 {
+	ensureRows();
 	for(int i=0;i<_storage.getSize();i++) {
 		_storage[i].add(aN,aValue);
 	}
@@ -1503,6 +2055,7 @@ add(int aN, double aValue)
 void Storage::
 add(int aN,double aY[])
 {
+	ensureRows();
 	for(int i=0;i<_storage.getSize();i++) {
 		_storage[i].add(aN,aY);
 	}
@@ -1517,6 +2070,7 @@ add(int aN,double aY[])
 void Storage::
 add(StateVector *aStateVector)
 {
+	ensureRows();
 	for(int i=0;i<_storage.getSize();i++) {
 		_storage[i].add(aStateVector);
 	}
@@ -1534,6 +2088,7 @@ s */
 void Storage::
 add(Storage *aStorage)
 {
+	ensureRows();
 	if(aStorage==NULL) return;
 
 	int n,N=0,nN;
@@ -1571,6 +2126,7 @@ add(Storage *aStorage)
 void Storage::
 subtract(double aValue)
 {
+	ensureRows();
 	for(int i=0;i<_storage.getSize();i++) {
 		_storage[i].subtract(aValue);
 	}
@@ -1588,6 +2144,7 @@ subtract(double aValue)
 void Storage::
 subtract(int aN,double aY[])
 {
+	ensureRows();
 	for(int i=0;i<_storage.getSize();i++) {
 		_storage[i].subtract(aN,aY);
 	}
@@ -1602,6 +2159,7 @@ subtract(int aN,double aY[])
 void Storage::
 subtract(StateVector *aStateVector)
 {
+	ensureRows();
 	for(int i=0;i<_storage.getSize();i++) {
 		_storage[i].subtract(aStateVector);
 	}
@@ -1619,6 +2177,7 @@ s */
 void Storage::
 subtract(Storage *aStorage)
 {
+	ensureRows();
 	if(aStorage==NULL) return;
 
 	int n,N=0,nN;
@@ -1656,6 +2215,10 @@ subtract(Storage *aStorage)
 void Storage::
 multiply(double aValue)
 {
+	if(_dataInColumns) {
+		for(int j=0;j<_columns.getNumStates();j++) multiplyColumn(j,aValue);
+		return;
+	}
 	for(int i=0;i<_storage.getSize();i++) {
 		_storage[i].multiply(aValue);
 	}
@@ -1673,6 +2236,7 @@ multiply(double aValue)
 void Storage::
 multiply(int aN,double aY[])
 {
+	ensureRows();
 	for(int i=0;i<_storage.getSize();i++) {
 		_storage[i].multiply(aN,aY);
 	}
@@ -1688,6 +2252,7 @@ multiply(int aN,double aY[])
 void Storage::
 multiply(StateVector *aStateVector)
 {
+	ensureRows();
 	for(int i=0;i<_storage.getSize();i++) {
 		_storage[i].multiply(aStateVector);
 	}
@@ -1705,6 +2270,7 @@ s */
 void Storage::
 multiply(Storage *aStorage)
 {
+	ensureRows();
 	if(aStorage==NULL) return;
 
 	int n,N=0,nN;
@@ -1738,6 +2304,12 @@ multiply(Storage *aStorage)
 void Storage::
 multiplyColumn(int aIndex, double aValue)
 {
+	if(_dataInColumns) {
+		if(aIndex<0 || aIndex>=_columns.getNumStates()) return;
+		double *col = _columns.updColumn(aIndex);
+		for(int i=0;i<_columns.getNumRows();i++) col[i] *= aValue;
+		return;
+	}
 	double newValue;
 	for(int i=0;i<_storage.getSize();i++) {
 		_storage[i].getDataValue(aIndex, newValue);
@@ -1758,6 +2330,7 @@ multiplyColumn(int aIndex, double aValue)
 void Storage::
 divide(double aValue)
 {
+	ensureRows();
 	for(int i=0;i<_storage.getSize();i++) {
 		_storage[i].divide(aValue);
 	}
@@ -1774,6 +2347,7 @@ divide(double aValue)
 void Storage::
 divide(int aN,double aY[])
 {
+	ensureRows();
 	for(int i=0;i<_storage.getSize();i++) {
 		_storage[i].divide(aN,aY);
 	}
@@ -1787,6 +2361,7 @@ divide(int aN,double aY[])
 void Storage::
 divide(StateVector *aStateVector)
 {
+	ensureRows();
 	for(int i=0;i<_storage.getSize();i++) {
 		_storage[i].divide(aStateVector);
 	}
@@ -1804,6 +2379,7 @@ s */
 void Storage::
 divide(Storage *aStorage)
 {
+	ensureRows();
 	if(aStorage==NULL) return;
 
 	int i;
@@ -1906,7 +2482,7 @@ int Storage::
 integrate(int aI1,int aI2,int aN,double *rArea,Storage *rStorage) const
 {
 	// CHECK THAT THERE ARE STATES STORED
-	if(_storage.getSize()<=0) {
+	if(getSize()<=0) {
 		cout << "Storage.integrate: ERROR- no stored states." << endl;
 		return(0);
 	}
@@ -1927,11 +2503,13 @@ integrate(int aI1,int aI2,int aN,double *rArea,Storage *rStorage) const
 
 	// SET THE INDICES
 	if(aI1<0) aI1 = 0;
-	if(aI2<0) aI2 = _storage.getSize()-1;
+	if(aI2<0) aI2 = getSize()-1;
 
 	// WORKING MEMORY
+	// Rows are read in either form (see getRow()).
 	double ti,tf;
-	double *yi=NULL,*yf=NULL;
+	std::vector<double> yiRow(n),yfRow(n);
+	double *yi=&yiRow[0],*yf=&yfRow[0];
 
 	bool functionAllocatedArea = false;
 	if(!rArea) {
@@ -1944,7 +2522,7 @@ integrate(int aI1,int aI2,int aN,double *rArea,Storage *rStorage) const
 
 	// RECORD FIRST STATE
 	if(rStorage) {
-		ti = getStateVector(aI1)->getTime();
+		ti = getRow(aI1,0,yi);
 		rStorage->append(ti,n,rArea);
 	}
 
@@ -1952,12 +2530,10 @@ integrate(int aI1,int aI2,int aN,double *rArea,Storage *rStorage) const
 	for(int I=aI1;I<aI2;I++) {
 
 		// INITIAL
-		ti = getStateVector(I)->getTime();
-		yi = getStateVector(I)->getData().get();
+		ti = getRow(I,n,yi);
 
 		// FINAL
-		tf = getStateVector(I+1)->getTime();
-		yf = getStateVector(I+1)->getData().get();
+		tf = getRow(I+1,n,yf);
 
 		// AREA
 		for(int i=0;i<n;i++) {
@@ -1981,7 +2557,7 @@ int Storage::
 integrate(double aTI,double aTF,int aN,double *rArea,Storage *rStorage) const
 {
 	// CHECK THAT THERE ARE STATES STORED
-	if(_storage.getSize()<=0) {
+	if(getSize()<=0) {
 		cout << "Storage.integrate: ERROR- no stored states." << endl;
 		return(0);
 	}
@@ -2046,12 +2622,13 @@ integrate(double aTI,double aTF,int aN,double *rArea,Storage *rStorage) const
 
 	// SPANS MULTIPLE INTERVALS
 	} else {
-		double *yi=NULL,*yf=NULL;
+		// Rows are read in either form (see getRow()).
+		std::vector<double> yiRow(n),yfRow(n);
+		double *yi=&yiRow[0],*yf=&yfRow[0];
 
 		// FIRST SLICE
 		getDataAtTime(aTI,n,&yI);
-		tf = getStateVector(II)->getTime();
-		yf = getStateVector(II)->getData().get();
+		tf = getRow(II,n,yf);
 		for(int i=0;i<n;i++) {
 			rArea[i] += 0.5*(yf[i]+yI[i])*(tf-aTI);
 		}
@@ -2059,10 +2636,8 @@ integrate(double aTI,double aTF,int aN,double *rArea,Storage *rStorage) const
 
 		// INTERVALS
 		for(int I=II;I<FF;I++) {
-			ti = getStateVector(I)->getTime();
-			yi = getStateVector(I)->getData().get();
-			tf = getStateVector(I+1)->getTime();
-			yf = getStateVector(I+1)->getData().get();
+			ti = getRow(I,n,yi);
+			tf = getRow(I+1,n,yf);
 			for(int i=0;i<n;i++) {
 				rArea[i] += 0.5*(yf[i]+yi[i])*(tf-ti);
 			}
@@ -2070,8 +2645,7 @@ integrate(double aTI,double aTF,int aN,double *rArea,Storage *rStorage) const
 		}
 
 		// LAST SLICE
-		ti = getStateVector(FF)->getTime();
-		yi = getStateVector(FF)->getData().get();
+		ti = getRow(FF,n,yi);
 		getDataAtTime(aTF,n,&yF);
 		for(int i=0;i<n;i++) {
 			rArea[i] += 0.5*(yF[i]+yi[i])*(aTF-ti);
@@ -2102,7 +2676,7 @@ computeArea(int aN,double *aArea) const
 	// CHECK FOR VALID OUTPUT ARRAYS
 	if(aN<=0) return(0);
 	else if(aArea==NULL) return(0);
-	else return integrate(0,_storage.getSize()-1,aN,aArea,NULL);
+	else return integrate(0,getSize()-1,aN,aArea,NULL);
 }
 //_____________________________________________________________________________
 /**
@@ -2216,6 +2790,23 @@ pad(int aPadSize)
 	// PAD EACH COLUMN
 	int nc = getSmallestNumberOfStates();
 	Array<double> paddedSignal(0.0,size);
+
+	// COLUMN-MAJOR
+	if(_dataInColumns) {
+		StorageColumns padded;
+		padded.setNumStates(nc);
+		padded.resize(newSize);
+		std::copy(paddedTime.get(),paddedTime.get()+newSize,padded.updTimes());
+		for(int i=0;i<nc;i++) {
+			getDataColumn(i,paddedSignal);
+			Signal::Pad(aPadSize,paddedSignal);
+			std::copy(paddedSignal.get(),paddedSignal.get()+newSize,
+				padded.updColumn(i));
+		}
+		_columns = padded;
+		return;
+	}
+
 	StateVector *vecs = new StateVector[newSize];
 	for(int j=0;j<newSize;j++) {
 		vecs[j].getData().setSize(nc);
@@ -2270,8 +2861,15 @@ smoothSpline(int aOrder,double aCutoffFrequency)
 	Array<double> filt(0.0,size);
 	getTimeColumn(times,0);
 	for(int i=0;i<nc;i++) {
-		getDataColumn(i,signal);
-		Signal::SmoothSpline(aOrder,dtmin,aCutoffFrequency,size,times,signal,&filt[0]);
+		double *sig;
+		if(_dataInColumns) {
+			// Column-major data are filtered without copying the column.
+			sig = _columns.updColumn(i);
+		} else {
+			getDataColumn(i,signal);
+			sig = signal;
+		}
+		Signal::SmoothSpline(aOrder,dtmin,aCutoffFrequency,size,times,sig,&filt[0]);
 		setDataColumn(i,filt);
 	}
 
@@ -2313,8 +2911,15 @@ lowpassIIR(double aCutoffFrequency)
 	double *signal=NULL;
 	Array<double> filt(0.0,size);
 	for(int i=0;i<nc;i++) {
-		getDataColumn(i,signal);
-		Signal::LowpassIIR(dtmin,aCutoffFrequency,size,signal,&filt[0]);
+		double *sig;
+		if(_dataInColumns) {
+			// Column-major data are filtered without copying the column.
+			sig = _columns.updColumn(i);
+		} else {
+			getDataColumn(i,signal);
+			sig = signal;
+		}
+		Signal::LowpassIIR(dtmin,aCutoffFrequency,size,sig,&filt[0]);
 		setDataColumn(i,filt);
 	}
 
@@ -2355,8 +2960,15 @@ lowpassFIR(int aOrder,double aCutoffFrequency)
 	double *signal=NULL;
 	Array<double> filt(0.0,size);
 	for(int i=0;i<nc;i++) {
-		getDataColumn(i,signal);
-		Signal::LowpassFIR(aOrder,dtmin,aCutoffFrequency,size,signal,&filt[0]);
+		double *sig;
+		if(_dataInColumns) {
+			// Column-major data are filtered without copying the column.
+			sig = _columns.updColumn(i);
+		} else {
+			getDataColumn(i,signal);
+			sig = signal;
+		}
+		Signal::LowpassFIR(aOrder,dtmin,aCutoffFrequency,size,sig,&filt[0]);
 		setDataColumn(i,filt);
 	}
 
@@ -2373,12 +2985,13 @@ lowpassFIR(int aOrder,double aCutoffFrequency)
  * Find the index of the storage element that occured immediately before
  * or at time aT ( aT <= getTime(index) ).
  *
- * This method can be much more efficient than findIndex(aT) if a good guess
- * is made for aI.
- * If aI corresponds to a state which occured later than aT, an exhaustive
- * search is performed by calling findIndex(aT).
+ * The search is done by TimeIndex: aI is tried first, then the index that
+ * uniformly sampled data would have, then a binary search, so a query costs
+ * O(1) when stepping through the data or when the data are sampled at a
+ * fixed rate, and O(log n) otherwise.
  *
- * @param aI Index at which to start searching.
+ * @param aI Index at which to start searching, e.g., the result of the
+ * previous call. An invalid index is ignored.
  * @param aT Time.
  * @return Index preceding or at time aT.  If aT is less than the earliest
  * time, 0 is returned.
@@ -2386,28 +2999,30 @@ lowpassFIR(int aOrder,double aCutoffFrequency)
 int Storage::
 findIndex(int aI,double aT) const
 {
-	// MAKE SURE aI IS VALID
-	if(_storage.getSize()<=0) return(-1);
-	if((aI>=_storage.getSize())||(aI<0)) aI=0;
-	if(getStateVector(aI)->getTime()>aT) aI=0;
-
-	// SEARCH
-	//cout << "Storage.findIndex: starting at " << aI << endl;
 	int i;
-	for(i=aI;i<_storage.getSize();i++) {
-		if(aT<getStateVector(i)->getTime()) break;
+	if(_dataInColumns) {
+		int n = _columns.getNumRows();
+		if(n<=0) return(-1);
+		i = TimeIndex::findLastAtOrBefore(_columns.getTimes(),n,aT,aI);
+	} else {
+		int n = _storage.getSize();
+		if(n<=0) return(-1);
+		i = TimeIndex::findLastAtOrBefore(RowTimes(_storage),n,aT,aI);
 	}
-	_lastI = i-1;
-	if(_lastI<0) _lastI=0;
-	return(_lastI);
+	if(i<0) i = 0;
+	// Only store a new hint, so that threads searching the same storage do
+	// not keep writing the same value.
+	if(_lastI.load(std::memory_order_relaxed)!=i)
+		_lastI.store(i,std::memory_order_relaxed);
+	return(i);
 }
 //_____________________________________________________________________________
 /**
  * Find the index of the storage element that occured immediately before
  * or at a specified time ( getTime(index) <= aT ).
  *
- * This method is not very efficient because it always starts its search
- * with the first stored state.
+ * The index found by the previous search is used as a hint (see
+ * findIndex(int,double)).
  *
  * @param aT Time.
  * @return Index preceding or at time aT.  If aT is less than the earliest
@@ -2416,14 +3031,7 @@ findIndex(int aI,double aT) const
 int Storage::
 findIndex(double aT) const
 {
-	if(_storage.getSize()<=0) return(-1);
-	int i;
-	for(i=0;i<_storage.getSize();i++) {
-		if(aT<getStateVector(i)->getTime()) break;
-	}
-	_lastI = i-1;
-	if(_lastI<0) _lastI=0;
-	return(_lastI);
+	return(findIndex(_lastI.load(std::memory_order_relaxed),aT));
 }
 //_____________________________________________________________________________
 /** 
@@ -2452,7 +3060,7 @@ void Storage::findFrameRange(double aStartTime, double aEndTime, int& oStartFram
 double Storage::
 resample(double aDT, int aDegree)
 {
-	int numDataRows = _storage.getSize();
+	int numDataRows = getSize();
 
 	if(numDataRows<=1) return aDT;
 
@@ -2468,7 +3076,7 @@ resample(double aDT, int aDegree)
 
 	Array<std::string> saveLabels = getColumnLabels();
 	// Free up memory used by Storage
-	_storage.setSize(0);
+	reset(0);
 	// For every column, collect data and fit spline to originalTimes, dataColumn.
 	Storage *newStorage = splineSet->constructStorage(0,aDT);
 	newStorage->setInDegrees(isInDegrees());
@@ -2488,7 +3096,7 @@ resample(double aDT, int aDegree)
 double Storage::
 resampleLinear(double aDT)
 {
-	int numDataRows = _storage.getSize();
+	int numDataRows = getSize();
 
 	if(numDataRows<=1) return aDT;
 
@@ -2535,6 +3143,7 @@ resampleLinear(double aDT)
  */
 void Storage::interpolateAt(const Array<double> &targetTimes)
 {
+	ensureRows();
 	for(int i=0; i<targetTimes.getSize();i++){
 		double t = targetTimes[i];
 		// get index for t
@@ -2586,6 +3195,214 @@ setOutputFileName(const std::string& aFileName)
 	// WRITE THE COLUMN LABELS
 	n = writeColumnLabels(_fp);
 }
+//=============================================================================
+// STREAMING
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Start streaming rows to a file so that memory use stays bounded however
+ * many rows are appended.
+ *
+ * Once 2*aWindowSize rows are held, all but the most recent aWindowSize are
+ * handed to a background StorageWriter and dropped from memory, so a long
+ * simulation holds at most that many rows (plus the blocks queued for
+ * writing) instead of its whole history. The storage is put in column-major
+ * mode so that the dropped rows can be handed over as one block.
+ *
+ * The file is a scratch file: it holds only the rows dropped from memory
+ * and is removed when the storage is destroyed or reset(0) is called, which
+ * starts the file over. While streaming, getSize(), getStateVector() and the
+ * other accessors see only the rows still in memory. print() and
+ * printBinary() write the streamed rows followed by the rows in memory, so
+ * callers such as Analysis::printResults() produce the complete results
+ * unchanged, as often as they like.
+ *
+ * @param aFileName Scratch file receiving the rows.
+ * @param aWindowSize Number of rows kept in memory.
+ * @throws Exception if rows of an earlier stream are still held in its
+ * scratch file (call reset(0) first), or if the file cannot be opened.
+ */
+void Storage::
+beginStreaming(const string &aFileName,int aWindowSize)
+{
+	if(_numStreamedRows>0)
+		throw Exception("Storage.beginStreaming: storage "+getName()+
+			" still holds rows streamed to "+_streamFileName+
+			"; call reset(0) first.",__FILE__,__LINE__);
+	removeStreamFile();
+	_streamFP = IO::OpenFile(aFileName,"w");
+	if(_streamFP==NULL)
+		throw Exception("Storage.beginStreaming: could not open file "+aFileName,
+			__FILE__,__LINE__);
+	_streamFileName = aFileName;
+	_streamWindow = (aWindowSize<1) ? 1 : aWindowSize;
+	setColumnMajor(true);
+	checkStreamWindow();
+}
+//_____________________________________________________________________________
+/**
+ * Stop streaming. The scratch file is closed, and rows appended afterwards
+ * stay in memory; print() still writes the rows streamed so far followed by
+ * those in memory.
+ */
+void Storage::
+endStreaming()
+{
+	finishStreamFile();
+}
+//_____________________________________________________________________________
+/**
+ * Write the first aNumRows rows to the stream file and drop them from
+ * memory.
+ */
+void Storage::
+streamRows(int aNumRows)
+{
+	if(!_streamFP) return;
+	if(aNumRows>getSize()) aNumRows = getSize();
+	if(aNumRows<=0) return;
+
+	// HEADER AND WRITER
+	if(!_writer) {
+		writeHeader(_streamFP,-1,&_streamRowCountPos);
+		writeDescription(_streamFP);
+		writeColumnLabels(_streamFP);
+		_streamDataPos = ftell(_streamFP);
+		_writer = new StorageWriter(_streamFP);
+	}
+
+	ensureColumns();
+	if(_dataInColumns) {
+		// Hand the rows to the writer as one block.
+		int ns = _columns.getNumStates();
+		StorageColumns block;
+		block.setNumStates(ns);
+		block.resize(aNumRows);
+		copy(_columns.getTimes(),_columns.getTimes()+aNumRows,block.updTimes());
+		for(int j=0;j<ns;j++)
+			copy(_columns.getColumn(j),_columns.getColumn(j)+aNumRows,
+				block.updColumn(j));
+		_writer->write(block);
+		_columns.removeRows(0,aNumRows);
+	} else {
+		// Rows of different lengths are written on this thread.
+		_writer->flush();
+		for(int i=0;i<aNumRows;i++) _storage[i].print(_streamFP);
+		int n = _storage.getSize();
+		for(int i=aNumRows;i<n;i++) _storage[i-aNumRows] = _storage[i];
+		_storage.setSize(n-aNumRows);
+	}
+	_numStreamedRows += aNumRows;
+}
+//_____________________________________________________________________________
+/**
+ * Stop the writer, put the number of streamed rows in the header of the
+ * stream file and close it. The file keeps exactly the streamed rows.
+ */
+void Storage::
+finishStreamFile()
+{
+	if(!_streamFP) return;
+	if(_writer) {
+		_writer->finish();
+		if(_writer->getFailed())
+			cout << "Storage: ERROR- failed writing to " << _streamFileName << endl;
+		delete _writer;
+		_writer = 0;
+
+		fseek(_streamFP,_streamRowCountPos,SEEK_SET);
+		fprintf(_streamFP,"nRows=%-12d",_numStreamedRows);
+	}
+	fclose(_streamFP);
+	_streamFP = 0;
+}
+//_____________________________________________________________________________
+/**
+ * Finish and delete the stream file, and forget the rows it holds.
+ */
+void Storage::
+removeStreamFile()
+{
+	finishStreamFile();
+	if(!_streamFileName.empty()) remove(_streamFileName.c_str());
+	_streamFileName = "";
+	_numStreamedRows = 0;
+}
+//_____________________________________________________________________________
+/**
+ * Copy the streamed rows, as formatted in the stream file, to rFP.
+ *
+ * @return Number of characters copied, or -1 if the stream file could not
+ * be read.
+ */
+int Storage::
+copyStreamedRows(FILE *rFP) const
+{
+	// Everything handed to the writer must be in the file.
+	if(_writer) _writer->flush();
+
+	FILE *in = fopen(_streamFileName.c_str(),"rb");
+	if(in==NULL) return(-1);
+	bool ok = fseek(in,_streamDataPos,SEEK_SET)==0;
+	char buffer[65536];
+	size_t n;
+	int nTotal = 0;
+	while(ok && (n=fread(buffer,1,sizeof(buffer),in))>0) {
+		ok = fwrite(buffer,1,n,rFP)==n;
+		nTotal += (int)n;
+	}
+	if(ferror(in)) ok = false;
+	fclose(in);
+	return(ok ? nTotal : -1);
+}
+//_____________________________________________________________________________
+/**
+ * Append the streamed rows, read back from the stream file, followed by the
+ * rows in memory to rStorage.
+ *
+ * @return false if the stream file could not be read.
+ */
+bool Storage::
+appendAllRows(Storage &rStorage) const
+{
+	// STREAMED ROWS
+	if(_numStreamedRows>0) {
+		if(_writer) _writer->flush();
+		ifstream in(_streamFileName.c_str());
+		if(!in.seekg(_streamDataPos)) return(false);
+		string line;
+		std::vector<double> y;
+		for(int i=0;i<_numStreamedRows;i++) {
+			if(!getline(in,line)) return(false);
+			const char *p = line.c_str();
+			char *end;
+			double t = strtod(p,&end);
+			if(end==p) return(false);
+			y.clear();
+			for(p=end;;p=end) {
+				double value = strtod(p,&end);
+				if(end==p) break;
+				y.push_back(value);
+			}
+			y.push_back(0.0);
+			rStorage.append(t,(int)y.size()-1,&y[0],false);
+		}
+	}
+
+	// ROWS IN MEMORY
+	if(_dataInColumns) {
+		int ns = _columns.getNumStates();
+		std::vector<double> y(ns>0 ? ns : 1);
+		for(int i=0;i<_columns.getNumRows();i++) {
+			double t = getRow(i,ns,&y[0]);
+			rStorage.append(t,ns,&y[0],false);
+		}
+	} else {
+		for(int i=0;i<_storage.getSize();i++)
+			rStorage.append(_storage[i],false);
+	}
+	return(true);
+}
 //_____________________________________________________________________________
 /**
  * Print the contents of this storage instance to a file.
@@ -2602,10 +3419,30 @@ setOutputFileName(const std::string& aFileName)
  * default is "w".
  * @param aComment string to be written to the file header (preceded by # per SIMM)
  * @return true on success
+ *
+ * If rows were streamed (see beginStreaming()) they are copied from the
+ * stream file ahead of the rows in memory. Streaming goes on.
  */
 bool Storage::
 print(const string &aFileName,const string &aMode, const string& aComment) const
 {
+	// STREAMED ROWS
+	if(_numStreamedRows>0) {
+		if(aFileName==_streamFileName) {
+			cout << "Storage.print: cannot print to the stream file "
+				<< aFileName << endl;
+			return(false);
+		}
+		// The SIMM header needs the range of all the rows.
+		if(_writeSIMMHeader) {
+			Storage full(*this,false);
+			full._keyValueMap = _keyValueMap;
+			full.setWriteSIMMHeader(true);
+			if(!appendAllRows(full)) return(false);
+			return(full.print(aFileName,aMode,aComment));
+		}
+	}
+
 	// OPEN THE FILE
 	FILE *fp = IO::OpenFile(aFileName,aMode);
 	if(fp==NULL) return(false);
@@ -2645,9 +3482,42 @@ print(const string &aFileName,const string &aMode, const string& aComment) const
 		return(false);
 	}
 
+	// STREAMED ROWS
+	if(_numStreamedRows>0) {
+		n = copyStreamedRows(fp);
+		if(n<0) {
+			cout << "Storage.print(const string&,const string&): failed to" << endl
+				  << " copy the rows streamed to " << _streamFileName << endl;
+			fclose(fp);
+			return(false);
+		}
+		nTotal += n;
+	}
+
 //printf("Storage.cpp:print storage=%x  n=%d ",&_storage, _storage.getSize());
 //std::cout << aFileName << endl;
 
+	// COLUMN-MAJOR
+	// Rows are formatted through one reused StateVector so the output is
+	// identical to that of a row storage.
+	if(_dataInColumns) {
+		int ns = _columns.getNumStates();
+		std::vector<double> y(ns>0 ? ns : 1);
+		StateVector vec;
+		for(int i=0;i<_columns.getNumRows();i++) {
+			_columns.getRow(i,ns,&y[0]);
+			vec.setStates(_columns.getTime(i),ns,&y[0]);
+			n = vec.print(fp);
+			if(n<0) {
+				cout << "Storage.print(const string&,const string&): error printing to " << aFileName;
+				return(false);
+			}
+			nTotal += n;
+		}
+		fclose(fp);
+		return(nTotal!=0);
+	}
+
 	// VECTORS
 	for(int i=0;i<_storage.getSize();i++) {
 		n = getStateVector(i)->print(fp);
@@ -2683,6 +3553,15 @@ print(const string &aFileName,double aDT,const string &aMode) const
 	// CHECK FOR VALID DT
 	if(aDT<=0) return(0);
 
+	// STREAMED ROWS
+	if(_numStreamedRows>0) {
+		Storage full(*this,false);
+		full._keyValueMap = _keyValueMap;
+		full.setWriteSIMMHeader(_writeSIMMHeader);
+		if(!appendAllRows(full)) return(-1);
+		return(full.print(aFileName,aDT,aMode));
+	}
+
 	if (_fp!= NULL) fclose(_fp);
 	// OPEN THE FILE
 	FILE *fp = IO::OpenFile(aFileName,aMode);
@@ -2755,6 +3634,26 @@ print(const string &aFileName,double aDT,const string &aMode) const
 
 	return(nTotal);
 }
+//_____________________________________________________________________________
+/**
+ * Write the storage in the binary storage format (see StorageBinaryFile).
+ * The file keeps the name, description, column labels, inDegrees, units and
+ * key/value pairs, and can be loaded with Storage(aFileName). Use print() to
+ * get a text file that can be read by people and other programs.
+ *
+ * @return false if the file could not be written.
+ */
+bool Storage::
+printBinary(const string &aFileName) const
+{
+	if(_numStreamedRows>0) {
+		Storage full(*this,false);
+		full._keyValueMap = _keyValueMap;
+		if(!appendAllRows(full)) return(false);
+		return(StorageBinaryFile::write(full,aFileName));
+	}
+	return(StorageBinaryFile::write(*this,aFileName));
+}
 
 void Storage::
 printResult(const Storage *aStorage,const std::string &aName,
@@ -2770,16 +3669,19 @@ printResult(const Storage *aStorage,const std::string &aName,
 //_____________________________________________________________________________
 /**
  * Write the header.
+ *
+ * @param rRowCountPos If not NULL, the nRows field is padded so that it can
+ * be overwritten later, and its position in the file is returned here.
  */
 int Storage::
-writeHeader(FILE *rFP,double aDT) const
+writeHeader(FILE *rFP,double aDT,long *rRowCountPos) const
 {
 	if(rFP==NULL) return(-1);
 
 	// COMPUTE ATTRIBUTES
 	int nr,nc;
 	if(aDT<=0) {
-		nr = _storage.getSize();
+		nr = _numStreamedRows+getSize();
 	} else {
 		double ti = getFirstTime();
 		double tf = getLastTime();
@@ -2790,7 +3692,13 @@ writeHeader(FILE *rFP,double aDT) const
 	// ATTRIBUTES
 	fprintf(rFP,"%s\n",getName().c_str());
 	fprintf(rFP,"version=%d\n",LatestVersion);
-	fprintf(rFP,"nRows=%d\n",nr);
+	if(rRowCountPos) {
+		// Padded so the final count can be written over it in place.
+		*rRowCountPos = ftell(rFP);
+		fprintf(rFP,"nRows=%-12d\n",nr);
+	} else {
+		fprintf(rFP,"nRows=%d\n",nr);
+	}
 	fprintf(rFP,"nColumns=%d\n",nc);
 	fprintf(rFP,"inDegrees=%s\n",(_inDegrees?"yes":"no"));
 
@@ -2824,7 +3732,7 @@ writeSIMMHeader(FILE *rFP,double aDT, const char *aComment) const
 	// ROWS
 	int nRows;
 	if(aDT<=0) {
-		nRows = _storage.getSize();
+		nRows = getSize();
 	} else {
 		nRows = IO::ComputeNumberOfSteps(getFirstTime(),getLastTime(),aDT);
 	}
@@ -3086,6 +3994,109 @@ bool Storage::parseHeaders(std::ifstream& aStream, int& rNumRows, int& rNumColum
 	return true;
 }
 //_____________________________________________________________________________
+/**
+ * Read the data rows of a file through a TextDataParser, converting the rows
+ * in parallel straight into the column-major block. Consecutive rows with
+ * the same time are collapsed as append() would. The data are converted to
+ * StateVector rows afterwards unless column-major mode is on.
+ *
+ * @param aFileName Name of the file.
+ * @param aOffset Offset of the first data row in the file.
+ * @param aNumRows Number of rows declared in the header.
+ * @param aNumColumns Number of columns declared in the header.
+ * @param aTimeColumn Whether the first column holds the time. If not, the
+ * row index is used as the time.
+ * @return false if the rows could not be read this way, in which case the
+ * storage holds no data.
+ */
+bool Storage::
+readDataFromMap(const string &aFileName,streamoff aOffset,int aNumRows,
+	int aNumColumns,bool aTimeColumn)
+{
+	int ny = aTimeColumn ? aNumColumns-1 : aNumColumns;
+	if(aOffset<0 || aNumRows<=0 || ny<0) return(false);
+
+	int nRead = -1;
+	try {
+		TextDataParser parser(aFileName);
+		_columns.clear();
+		_columns.setNumStates(ny);
+		_columns.resize(aNumRows);
+		int ld = _columns.getCapacity();
+		double *block = _columns.updTimes();
+		nRead = parser.parseRows((size_t)aOffset,aNumRows,aNumColumns,
+			aTimeColumn ? block : block+ld,ld);
+		if(nRead<0) {
+			cout << parser.getErrorMessage() << " Reading " << aFileName
+				<< " as a stream." << endl;
+		}
+	} catch(const Exception&) {
+		nRead = -1;
+	}
+	if(nRead<0) {
+		_columns.clear();
+		return(false);
+	}
+	_columns.resize(nRead);
+
+	// TIMES
+	if(!aTimeColumn) {
+		for(int r=0;r<nRead;r++) _columns.updTime(r) = (double)r;
+	} else {
+		// A row with the same time as the previous row replaces it.
+		int w = 0;
+		for(int r=0;r<nRead;r++) {
+			if(w>0 && _columns.getTime(r)==_columns.getTime(w-1)) w--;
+			if(w!=r) {
+				_columns.updTime(w) = _columns.getTime(r);
+				for(int i=0;i<ny;i++) _columns.updValue(w,i) = _columns.getValue(r,i);
+			}
+			w++;
+		}
+		_columns.resize(w);
+	}
+
+	_dataInColumns = true;
+	if(!_columnMajor) ensureRows();
+	return(true);
+}
+//_____________________________________________________________________________
+/**
+ * Load a file in the binary storage format (see StorageBinaryFile). The
+ * columns are copied out of the file mapping one at a time.
+ */
+void Storage::
+readBinary(const string &aFileName,bool aReadHeadersOnly)
+{
+	StorageBinaryFile file(aFileName);
+	cout << "Storage: binary file=" << aFileName << " (nr=" << file.getNumRows()
+		<< " nc=" << file.getNumStates()+1 << ")" << endl;
+
+	// HEADER
+	setName(file.getName());
+	setDescription(file.getDescription());
+	setColumnLabels(file.getColumnLabels());
+	setInDegrees(file.isInDegrees());
+	_units = file.getUnits();
+	_keyValueMap = file.getKeyValueMap();
+	_fileVersion = LatestVersion;
+	if(aReadHeadersOnly) return;
+
+	// DATA
+	int nr = file.getNumRows();
+	int ns = file.getNumStates();
+	_columns.clear();
+	_columns.setNumStates(ns);
+	_columns.resize(nr);
+	if(nr>0) {
+		copy(file.getTimes(),file.getTimes()+nr,_columns.updTimes());
+		for(int j=0;j<ns;j++)
+			copy(file.getColumn(j),file.getColumn(j)+nr,_columns.updColumn(j));
+	}
+	_dataInColumns = true;
+	if(!_columnMajor) ensureRows();
+}
+//_____________________________________________________________________________
 /**
  * This function exchanges the time column (including the label) with the column	
  * at the passed in aColumnIndex. The index is zero based relative to the Data
@@ -3093,6 +4104,7 @@ bool Storage::parseHeaders(std::ifstream& aStream, int& rNumRows, int& rNumColum
 void Storage::
 exchangeTimeColumnWith(int aColumnIndex)
 {
+	ensureRows();
 	StateVector* vec;
 	for(int i=0; i< _storage.getSize(); i++){
 		vec = getStateVector(i);
@@ -3105,6 +4117,7 @@ exchangeTimeColumnWith(int aColumnIndex)
 	string swap = _columnLabels.get(0);
 	_columnLabels.set(aColumnIndex+1, swap);
 	_columnLabels.set(0, "time");
+	updateColumnIndex();
 
 }
 //_____________________________________________________________________________
@@ -3117,6 +4130,7 @@ exchangeTimeColumnWith(int aColumnIndex)
  */
 void Storage::postProcessSIMMMotion() 
 {
+	ensureRows();
 	Array<std::string> currentLabels = getColumnLabels();
 	// If time is not first column check if it exists somewhere else and exchange
 	if (!(currentLabels.get(0)=="time")){
@@ -3176,8 +4190,8 @@ void Storage::postProcessSIMMMotion()
 double Storage::compareColumn(Storage& aOtherStorage, const std::string& aColumnName, double startTime, double endTime)
 {
 	//Subtract one since, the data does not include the time column anymore.
-	int thisColumnIndex=_columnLabels.findIndex(aColumnName)-1;
-	int otherColumnIndex = aOtherStorage._columnLabels.findIndex(aColumnName)-1;
+	int thisColumnIndex=getColumnIndex(aColumnName)-1;
+	int otherColumnIndex = aOtherStorage.getColumnIndex(aColumnName)-1;
 
 	double theDiff = SimTK::NaN;
 
@@ -3218,8 +4232,8 @@ double Storage::compareColumn(Storage& aOtherStorage, const std::string& aColumn
 double Storage::compareColumnRMS(Storage& aOtherStorage, const std::string& aColumnName, double startTime, double endTime)
 {
 	//Subtract one since, the data does not include the time column anymore.
-	int thisColumnIndex=_columnLabels.findIndex(aColumnName)-1;
-	int otherColumnIndex = aOtherStorage._columnLabels.findIndex(aColumnName)-1;
+	int thisColumnIndex=getColumnIndex(aColumnName)-1;
+	int otherColumnIndex = aOtherStorage.getColumnIndex(aColumnName)-1;
 
 	if ((thisColumnIndex < 0) || (otherColumnIndex < 0)) {
 		//Assume new component state variable labeling so redo find with the just the
@@ -3229,10 +4243,10 @@ double Storage::compareColumnRMS(Storage& aOtherStorage, const std::string& aCol
 		std::string shortName = aColumnName.substr(back+1, aColumnName.length()-back);
 		
 		if (thisColumnIndex < 0)
-			thisColumnIndex = _columnLabels.findIndex(shortName) - 1;
+			thisColumnIndex = getColumnIndex(shortName) - 1;
 
 		if (otherColumnIndex < 0)
-			otherColumnIndex = aOtherStorage._columnLabels.findIndex(shortName) - 1;
+			otherColumnIndex = aOtherStorage.getColumnIndex(shortName) - 1;
 
 		if ((thisColumnIndex < 0) || (otherColumnIndex < 0))
 			return SimTK::NaN;
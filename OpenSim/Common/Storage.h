@@ -30,9 +30,16 @@
 #include "osimCommonDLL.h"
 #include "Object.h"
 #include "StateVector.h"
+#include "StorageColumns.h"
 #include "Units.h"
 #include "SimTKcommon.h"
 #include "StorageInterface.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 const int Storage_DEFAULT_CAPACITY = 256;
 //=============================================================================
@@ -54,11 +61,33 @@ const int Storage_DEFAULT_CAPACITY = 256;
  * TimeIndex, and a particular state (or column) is indexed by the
  * StateIndex.
  *
+ * By default each row is kept in its own StateVector. A Storage can instead
+ * be put in column-major mode (see setColumnMajor()), in which case the data
+ * are kept in a single contiguous StorageColumns block. Column operations
+ * (getDataColumn(), smoothSpline(), resample(), GCVSplineSet construction,
+ * ...) then stream through contiguous memory and getColumnView() and
+ * getRowView() give access to the data without copying. The const accessors
+ * read either form without changing it, so a const Storage can be read from
+ * several threads at once. Asking a non-const Storage for StateVector
+ * objects (getStateVector(), getLastStateVector()) converts the data back
+ * to rows, which invalidates pointers and views obtained earlier; a const
+ * Storage in column-major form instead hands out a copy of the row that is
+ * refreshed from the columns on each call, so writing through it does not
+ * change the stored data.
+ *
+ * For long simulations a Storage can stream its rows to a file (see
+ * beginStreaming()). Only a window of the most recent rows then stays in
+ * memory; older rows are written in blocks by a background StorageWriter
+ * to a scratch file, and print() writes the streamed rows followed by the
+ * rows still in memory. The scratch file is removed with the Storage.
+ *
  * @version 1.0
  * @author Frank C. Anderson
  */
 namespace OpenSim { 
 
+class StorageWriter;
+
 typedef std::map<std::string, std::string, std::less<std::string> > MapKeysToValues;
 
 //static std::string[] simmReservedKeys;
@@ -77,17 +106,37 @@ public:
 protected:
 	static std::string simmReservedKeys[];
 
-	/** Array of StateVectors. */
+	/** Array of StateVectors. Empty while the data are held in _columns. */
 	Array<StateVector> _storage;
+	/** Column-major data. Only used while _dataInColumns is true. */
+	StorageColumns _columns;
+	/** Whether data replacing the contents of this storage (from a file,
+	a copy, a resample, ...) is put in column-major form. */
+	bool _columnMajor;
+	/** Whether the data currently live in _columns rather than _storage. */
+	bool _dataInColumns;
+	/** Rows handed out by the const getStateVector() while the data live in
+	_columns, one per time index so that the returned pointers stay valid.
+	Not copied; emptied by ensureRows(). */
+	mutable std::vector< std::unique_ptr<StateVector> > _columnRows;
+	/** Guards _columnRows. */
+	mutable std::mutex _columnRowsMutex;
 	/** Token used to mark the end of the description in a file. */
 	std::string _headerToken;
 	/** Column labels. */
 	Array<std::string> _columnLabels;
+	/** Index of the first column with each label. Rebuilt by
+	updateColumnIndex() whenever the labels change. */
+	std::unordered_map<std::string,int> _columnIndex;
+	/** The column labels paired with their indices and sorted, for searches
+	by prefix and for repeated labels. */
+	std::vector< std::pair<std::string,int> > _sortedColumnLabels;
 	/** Step interval at which states in a simulation are stored. See
 	store(). */
 	int _stepInterval;
-	/** Last index at which a search was started. */
-	mutable int _lastI;
+	/** Last index at which a search was started. Atomic because const
+	searches from several threads update it. */
+	mutable std::atomic<int> _lastI;
 	/** Flag for whether or not to insert a SIMM style header. */
 	bool _writeSIMMHeader;
 	/** Units in which the data is represented. */
@@ -99,6 +148,21 @@ protected:
 	/** Cache for fileName and file pointer when the file is opened so we can flush and write intermediate files if needed */
 	std::string _fileName;
 	FILE *_fp;
+	/** Background writer of the rows dropped from memory while streaming
+	(see beginStreaming()). Created when the first block is written. */
+	StorageWriter *_writer;
+	/** File receiving the streamed rows, and its name. */
+	FILE *_streamFP;
+	std::string _streamFileName;
+	/** Position of the nRows field in the stream file. */
+	long _streamRowCountPos;
+	/** Position of the first row in the stream file. */
+	long _streamDataPos;
+	/** Number of rows kept in memory while streaming. */
+	int _streamWindow;
+	/** Number of rows that were written to the stream file and dropped from
+	memory. */
+	int _numStreamedRows;
 	/** Name and Description */
 	std::string _name;
 	std::string _description;
@@ -113,7 +177,8 @@ public:
 	// make this constructor explicit so you don't get implicit casting of int to Storage
 	explicit Storage(int aCapacity=Storage_DEFAULT_CAPACITY,
 		const std::string &aName="UNKNOWN");
-	Storage(const std::string &aFileName, bool readHeadersOnly=false) SWIG_DECLARE_EXCEPTION;
+	Storage(const std::string &aFileName, bool readHeadersOnly=false,
+		bool aColumnMajor=false) SWIG_DECLARE_EXCEPTION;
 	Storage(const Storage &aStorage,bool aCopyData=true);
 	Storage(const Storage &aStorage,int aStateIndex,int aN,
 		const char *aDelimiter="\t");
@@ -141,21 +206,47 @@ private:
 	void setNull();
 	void copyData(const Storage &aStorage);
 	void parseColumnLabels(const char *aLabels);
+	void updateColumnIndex();
 	bool parseHeaders(std::ifstream& aStream, int& rNumRows, int& rNumColumns);
+	bool readDataFromMap(const std::string& aFileName, std::streamoff aOffset,
+		int aNumRows, int aNumColumns, bool aTimeColumn);
+	void readBinary(const std::string& aFileName, bool aReadHeadersOnly);
 	bool isSimmReservedToken(const std::string& aToken);
 	void postProcessSIMMMotion();
 	void exchangeTimeColumnWith(int aColumnIndex);
+	void ensureRows();
+	void ensureColumns();
+	double getRow(int aTimeIndex,int aN,double *rY) const;
+	StateVector* getColumnRow(int aTimeIndex) const;
+	bool appendToColumns(double aT,int aN,const double *aY,
+		bool aCheckForDuplicateTime);
+	void checkStreamWindow() {
+		if(_streamFP && getSize()>=2*_streamWindow)
+			streamRows(getSize()-_streamWindow); }
 public:
 
+	//--------------------------------------------------------------------------
+	// COLUMN-MAJOR MODE
+	//--------------------------------------------------------------------------
+	void setColumnMajor(bool aTrueFalse);
+	bool getColumnMajor() const { return _columnMajor; }
+	bool isColumnMajor() const { return _dataInColumns; }
+	StorageColumns::ColumnView getTimeView() const;
+	StorageColumns::ColumnView getColumnView(int aStateIndex) const;
+	StorageColumns::RowView getRowView(int aTimeIndex) const;
+
 	//--------------------------------------------------------------------------
 	// GET AND SET
 	//--------------------------------------------------------------------------
 	// SIZE
-	virtual int getSize() const { return(_storage.getSize()); }
+	virtual int getSize() const {
+		return(_dataInColumns ? _columns.getNumRows() : _storage.getSize()); }
 	// STATEVECTOR
 	int getSmallestNumberOfStates() const;
 	virtual StateVector* getStateVector(int aTimeIndex) const;
 	virtual StateVector* getLastStateVector() const;
+	StateVector* getStateVector(int aTimeIndex);
+	StateVector* getLastStateVector();
 	// TIME
 	virtual double getFirstTime() const;
 	virtual double getLastTime() const;
@@ -168,6 +259,9 @@ public:
 	void addKeyValuePair(const std::string& aKey, const std::string& aValue);
 	void getValueForKey(const std::string& aKey, std::string& rValue) const;
 	bool hasKey(const std::string& aKey) const;
+	const MapKeysToValues& getKeyValueMap() const { return _keyValueMap; }
+	const Units& getUnits() const { return _units; }
+	void setUnits(const Units& aUnits) { _units = aUnits; }
 	const bool isInDegrees() const { return _inDegrees; };
 	void setInDegrees(const bool isInDegrees) { _inDegrees = isInDegrees; };
 	// DATA
@@ -218,6 +312,7 @@ public:
 	const std::string& getHeaderToken() const;
 	// COLUMN LABELS
 	const int getStateIndex(const std::string &aColumnName, int startIndex=0) const;
+	int getColumnIndex(const std::string &aColumnName) const;
 	void setColumnLabels(const Array<std::string> &aColumnLabels);
 	const Array<std::string> &getColumnLabels() const;
 	//--------------------------------------------------------------------------
@@ -225,7 +320,7 @@ public:
 	//--------------------------------------------------------------------------
 	int reset(int aIndex=0);
 	int reset(double aTime);
-	void purge() { _storage.setSize(0); };	// Similar to reset but doesn't try to keep history
+	void purge() { reset(0); };	// Similar to reset but doesn't try to keep history
 	void crop(const double newStartTime, const double newFinalTime);
 	//--------------------------------------------------------------------------
 	// STORAGE
@@ -297,13 +392,27 @@ public:
 	//--------------------------------------------------------------------------
 	bool print(const std::string &aFileName,const std::string &aMode="w", const std::string& aComment="") const;
 	int print(const std::string &aFileName,double aDT,const std::string &aMode="w") const;
+	bool printBinary(const std::string &aFileName) const;
 	void setOutputFileName(const std::string& aFileName) ;
+	//--------------------------------------------------------------------------
+	// STREAMING
+	//--------------------------------------------------------------------------
+	void beginStreaming(const std::string& aFileName, int aWindowSize=1000);
+	void endStreaming();
+	bool isStreaming() const { return _streamFP!=0; }
+	const std::string& getStreamFileName() const { return _streamFileName; }
+	int getNumStreamedRows() const { return _numStreamedRows; }
 	// convenience function for Analyses and DerivCallbacks
 	static void printResult(const Storage *aStorage,const std::string &aName,
 		const std::string &aDir,double aDT,const std::string &aExtension);
     void interpolateAt(const Array<double> &targetTimes);
 private:
-	int writeHeader(FILE *rFP,double aDT=-1) const;
+	int writeHeader(FILE *rFP,double aDT=-1,long *rRowCountPos=NULL) const;
+	void streamRows(int aNumRows);
+	void finishStreamFile();
+	void removeStreamFile();
+	int copyStreamedRows(FILE *rFP) const;
+	bool appendAllRows(Storage &rStorage) const;
 	int writeSIMMHeader(FILE *rFP,double aDT=-1, const char*aComment=0) const;
 	int writeDescription(FILE *rFP) const;
 	int writeColumnLabels(FILE *rFP) const;
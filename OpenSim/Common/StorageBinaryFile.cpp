@@ -0,0 +1,255 @@
+/* -------------------------------------------------------------------------- *
+ *                     OpenSim:  StorageBinaryFile.cpp                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2012 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDES
+#include "StorageBinaryFile.h"
+#include "Exception.h"
+#include "SimTKcommon.h"
+#include <fstream>
+#include <climits>
+#include <cstring>
+#include <vector>
+#include <stdint.h>
+
+using namespace OpenSim;
+using namespace std;
+
+//=============================================================================
+// STATICS
+//=============================================================================
+const int StorageBinaryFile::LatestVersion = 1;
+
+namespace {
+
+const char SIGNATURE[8] = { 'O','S','I','M','S','T','B','\0' };
+const uint32_t BYTE_ORDER_MARK = 0x01020304;
+const size_t HEADER_SIZE = 64;
+
+/** Decoder of the metadata that checks every read against the end. */
+class MetadataReader {
+public:
+	MetadataReader(const char *aBegin,const char *aEnd,const string &aFileName) :
+		_p(aBegin), _end(aEnd), _fileName(aFileName) {}
+	uint32_t readInt() {
+		uint32_t value;
+		read(&value,sizeof(value));
+		return value;
+	}
+	string readString() {
+		uint32_t n = readInt();
+		check(n);
+		string value(_p,n);
+		_p += n;
+		return value;
+	}
+private:
+	void check(size_t n) {
+		if((size_t)(_end-_p)<n)
+			throw Exception("StorageBinaryFile: ERROR- truncated header in file "+
+				_fileName,__FILE__,__LINE__);
+	}
+	void read(void *rValue,size_t n) {
+		check(n);
+		memcpy(rValue,_p,n);
+		_p += n;
+	}
+	const char *_p;
+	const char *_end;
+	const string &_fileName;
+};
+
+void appendInt(string &rBuffer,uint32_t aValue)
+{	rBuffer.append((const char*)&aValue,sizeof(aValue)); }
+
+void appendString(string &rBuffer,const string &aValue)
+{
+	appendInt(rBuffer,(uint32_t)aValue.size());
+	rBuffer.append(aValue);
+}
+
+} // namespace
+
+//=============================================================================
+// CONSTRUCTOR(S)
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Map a binary storage file and decode its header. The data are not read.
+ */
+StorageBinaryFile::StorageBinaryFile(const string &aFileName) :
+	_file(aFileName),
+	_version(0),
+	_numRows(0),
+	_numColumns(0),
+	_columnLabels(""),
+	_inDegrees(false),
+	_data(0)
+{
+	const char *base = _file.getData();
+	size_t size = _file.getSize();
+	if(size<HEADER_SIZE || memcmp(base,SIGNATURE,sizeof(SIGNATURE))!=0)
+		throw Exception("StorageBinaryFile: ERROR- "+aFileName+
+			" is not a binary storage file.",__FILE__,__LINE__);
+
+	// FIXED HEADER
+	uint32_t version, byteOrder;
+	uint64_t nr, nc, metadataOffset, metadataSize, dataOffset;
+	memcpy(&version,base+8,4);
+	memcpy(&byteOrder,base+12,4);
+	memcpy(&nr,base+16,8);
+	memcpy(&nc,base+24,8);
+	memcpy(&metadataOffset,base+32,8);
+	memcpy(&metadataSize,base+40,8);
+	memcpy(&dataOffset,base+48,8);
+	if(version>(uint32_t)LatestVersion)
+		throw Exception("StorageBinaryFile: ERROR- "+aFileName+
+			" was written by a newer version of OpenSim.",__FILE__,__LINE__);
+	if(byteOrder!=BYTE_ORDER_MARK)
+		throw Exception("StorageBinaryFile: ERROR- "+aFileName+
+			" was written on a machine with a different byte order.",
+			__FILE__,__LINE__);
+	if(nc<1 || nr>(uint64_t)INT_MAX || nc>(uint64_t)INT_MAX ||
+		metadataOffset>size || metadataSize>size-metadataOffset ||
+		dataOffset%8!=0 || dataOffset>size ||
+		nr*nc>(size-dataOffset)/sizeof(double))
+		throw Exception("StorageBinaryFile: ERROR- "+aFileName+
+			" is truncated or corrupt.",__FILE__,__LINE__);
+	_version = (int)version;
+	_numRows = (int)nr;
+	_numColumns = (int)nc;
+	_data = (const double*)(base+dataOffset);
+
+	// METADATA
+	MetadataReader in(base+metadataOffset,base+metadataOffset+metadataSize,
+		aFileName);
+	_name = in.readString();
+	_description = in.readString();
+	_inDegrees = (in.readInt()!=0);
+	_units = Units((Units::UnitType)in.readInt());
+	uint32_t numLabels = in.readInt();
+	for(uint32_t i=0;i<numLabels;i++) _columnLabels.append(in.readString());
+	uint32_t numPairs = in.readInt();
+	for(uint32_t i=0;i<numPairs;i++) {
+		string key = in.readString();
+		_keyValueMap[key] = in.readString();
+	}
+}
+
+//=============================================================================
+// UTILITY
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Check whether a file starts with the binary storage signature.
+ */
+bool StorageBinaryFile::
+isBinaryFile(const string &aFileName)
+{
+	ifstream in(aFileName.c_str(),ios::in|ios::binary);
+	char signature[sizeof(SIGNATURE)];
+	if(!in.read(signature,sizeof(signature))) return(false);
+	return(memcmp(signature,SIGNATURE,sizeof(SIGNATURE))==0);
+}
+//_____________________________________________________________________________
+/**
+ * Write a storage in the latest version of the binary format. Rows with
+ * fewer states than the longest row are padded with NaN.
+ *
+ * @return false if the file could not be written.
+ */
+bool StorageBinaryFile::
+write(const Storage &aStorage,const string &aFileName)
+{
+	// SHAPE
+	int nr = aStorage.getSize();
+	int ns = 0;
+	if(aStorage.isColumnMajor()) {
+		ns = (nr>0) ? aStorage.getRowView(0).size() : 0;
+	} else {
+		for(int i=0;i<nr;i++)
+			if(aStorage.getStateVector(i)->getSize()>ns)
+				ns = aStorage.getStateVector(i)->getSize();
+	}
+
+	// METADATA
+	string metadata;
+	appendString(metadata,aStorage.getName());
+	appendString(metadata,aStorage.getDescription());
+	appendInt(metadata,aStorage.isInDegrees() ? 1 : 0);
+	appendInt(metadata,(uint32_t)aStorage.getUnits().getType());
+	const Array<string> &labels = aStorage.getColumnLabels();
+	appendInt(metadata,(uint32_t)labels.getSize());
+	for(int i=0;i<labels.getSize();i++) appendString(metadata,labels[i]);
+	const MapKeysToValues &pairs = aStorage.getKeyValueMap();
+	appendInt(metadata,(uint32_t)pairs.size());
+	for(MapKeysToValues::const_iterator it=pairs.begin();it!=pairs.end();++it) {
+		appendString(metadata,it->first);
+		appendString(metadata,it->second);
+	}
+	metadata.resize((metadata.size()+7)/8*8,'\0');
+
+	// FIXED HEADER
+	char header[HEADER_SIZE];
+	memset(header,0,sizeof(header));
+	uint32_t version = LatestVersion, byteOrder = BYTE_ORDER_MARK;
+	uint64_t nr64 = nr, nc64 = ns+1, metadataOffset = HEADER_SIZE,
+		metadataSize = metadata.size(), dataOffset = HEADER_SIZE+metadata.size();
+	memcpy(header,SIGNATURE,sizeof(SIGNATURE));
+	memcpy(header+8,&version,4);
+	memcpy(header+12,&byteOrder,4);
+	memcpy(header+16,&nr64,8);
+	memcpy(header+24,&nc64,8);
+	memcpy(header+32,&metadataOffset,8);
+	memcpy(header+40,&metadataSize,8);
+	memcpy(header+48,&dataOffset,8);
+
+	ofstream out(aFileName.c_str(),ios::out|ios::binary|ios::trunc);
+	if(!out) {
+		cout << "StorageBinaryFile.write: failed to open " << aFileName << endl;
+		return(false);
+	}
+	out.write(header,sizeof(header));
+	out.write(metadata.data(),metadata.size());
+
+	// DATA
+	if(aStorage.isColumnMajor()) {
+		out.write((const char*)aStorage.getTimeView().data(),nr*sizeof(double));
+		for(int j=0;j<ns;j++)
+			out.write((const char*)aStorage.getColumnView(j).data(),
+				nr*sizeof(double));
+	} else {
+		vector<double> column(nr>0 ? nr : 1);
+		for(int j=-1;j<ns;j++) {
+			for(int i=0;i<nr;i++) {
+				const StateVector &row = *aStorage.getStateVector(i);
+				column[i] = (j<0) ? row.getTime() :
+					(j<row.getSize() ? row.getData()[j] : SimTK::NaN);
+			}
+			out.write((const char*)&column[0],nr*sizeof(double));
+		}
+	}
+	if(!out) {
+		cout << "StorageBinaryFile.write: failed to write " << aFileName << endl;
+		return(false);
+	}
+	return(true);
+}
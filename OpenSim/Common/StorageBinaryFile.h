@@ -0,0 +1,124 @@
+#ifndef _StorageBinaryFile_h_
+#define _StorageBinaryFile_h_
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  StorageBinaryFile.h                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2012 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimCommonDLL.h"
+#include "MappedFile.h"
+#include "Storage.h"
+#include <string>
+
+namespace OpenSim {
+
+//=============================================================================
+//=============================================================================
+/**
+ * Reader and writer of the binary Storage file format (.osb). The format
+ * keeps everything a .sto header holds (name, description, column labels,
+ * inDegrees, units and the key/value pairs) and stores the data as raw
+ * doubles, so saving and loading involve no number formatting at all.
+ *
+ * A file is opened through a read-only memory mapping. Only the header and
+ * labels are decoded on construction; getTimes() and getColumn() return
+ * pointers straight into the mapping, so a column is read from disk only
+ * when it is first touched and nothing is copied. Storage(fileName) and
+ * MarkerData(fileName) recognize binary files by their signature and load
+ * them through this class; Storage::printBinary() writes them.
+ *
+ * Layout of version 1 (all integers unsigned, in the byte order of the
+ * writer, which is checked on reading):
+ * @code
+ * offset  0  char[8]  signature "OSIMSTB\0"
+ *         8  uint32   format version
+ *        12  uint32   byte order mark 0x01020304
+ *        16  uint64   number of rows
+ *        24  uint64   number of columns, including time
+ *        32  uint64   offset of the metadata
+ *        40  uint64   size of the metadata in bytes
+ *        48  uint64   offset of the data (a multiple of 8)
+ *        56  uint64   reserved (0)
+ * metadata: name, description (strings), inDegrees, units type (uint32),
+ *           number of labels followed by the labels, number of key/value
+ *           pairs followed by the keys and values. A string is a uint32
+ *           length followed by its characters.
+ * data:     the columns one after another, time first, each holding
+ *           "number of rows" doubles.
+ * @endcode
+ * Readers reject files with a newer version than they know.
+ */
+class OSIMCOMMON_API StorageBinaryFile
+{
+//=============================================================================
+// DATA
+//=============================================================================
+public:
+	/** Latest version of the format, the one written by write(). */
+	static const int LatestVersion;
+private:
+	/** The mapped file. */
+	MappedFile _file;
+	int _version;
+	int _numRows;
+	int _numColumns;
+	std::string _name;
+	std::string _description;
+	Array<std::string> _columnLabels;
+	bool _inDegrees;
+	Units _units;
+	MapKeysToValues _keyValueMap;
+	/** Start of the data in the mapping. */
+	const double *_data;
+
+//=============================================================================
+// METHODS
+//=============================================================================
+public:
+	explicit StorageBinaryFile(const std::string &aFileName);
+
+	int getVersion() const { return _version; }
+	int getNumRows() const { return _numRows; }
+	/** Number of columns not counting time. */
+	int getNumStates() const { return _numColumns-1; }
+	const std::string& getName() const { return _name; }
+	const std::string& getDescription() const { return _description; }
+	const Array<std::string>& getColumnLabels() const { return _columnLabels; }
+	bool isInDegrees() const { return _inDegrees; }
+	const Units& getUnits() const { return _units; }
+	const MapKeysToValues& getKeyValueMap() const { return _keyValueMap; }
+
+	/** Pointer to the getNumRows() times, inside the mapping. */
+	const double* getTimes() const { return _data; }
+	/** Pointer to the getNumRows() values of a state, inside the mapping. */
+	const double* getColumn(int aStateIndex) const
+	{	return _data + (size_t)(1+aStateIndex)*_numRows; }
+
+	static bool isBinaryFile(const std::string &aFileName);
+	static bool write(const Storage &aStorage,const std::string &aFileName);
+
+//=============================================================================
+};	// END of class StorageBinaryFile
+
+}; //namespace
+//=============================================================================
+//=============================================================================
+
+#endif //__StorageBinaryFile_h__
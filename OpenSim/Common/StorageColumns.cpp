@@ -0,0 +1,172 @@
+/* -------------------------------------------------------------------------- *
+ *                       OpenSim:  StorageColumns.cpp                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2012 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDES
+#include "StorageColumns.h"
+#include "Exception.h"
+#include <algorithm>
+
+using namespace OpenSim;
+using namespace std;
+
+//=============================================================================
+// CONSTRUCTOR(S)
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Default constructor. Holds no rows and no states.
+ */
+StorageColumns::StorageColumns() :
+	_capacity(0),
+	_numRows(0),
+	_numStates(0)
+{
+}
+
+//=============================================================================
+// SIZE
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Set the number of states per row. The number of states can only be changed
+ * while there are no rows.
+ */
+void StorageColumns::
+setNumStates(int aNumStates)
+{
+	if(aNumStates==_numStates) return;
+	if(_numRows>0)
+		throw Exception("StorageColumns.setNumStates: cannot change the number "
+			"of states of a non-empty block.",__FILE__,__LINE__);
+	_numStates = (aNumStates<0) ? 0 : aNumStates;
+	_block.assign((size_t)(1+_numStates)*_capacity, 0.0);
+}
+//_____________________________________________________________________________
+/**
+ * Make room for at least aNumRows rows. Existing values are moved to their
+ * new place in the block, so all views are invalidated when the capacity
+ * changes.
+ */
+void StorageColumns::
+reserve(int aNumRows)
+{
+	if(aNumRows<=_capacity) return;
+
+	int nc = 1+_numStates;
+	vector<double> block((size_t)nc*aNumRows);
+	for(int c=0;c<nc && _numRows>0;c++) {
+		const double *from = &_block[0] + (size_t)c*_capacity;
+		copy(from, from+_numRows, block.begin() + (size_t)c*aNumRows);
+	}
+	_block.swap(block);
+	_capacity = aNumRows;
+}
+//_____________________________________________________________________________
+/**
+ * Change the number of rows. New rows are zero.
+ */
+void StorageColumns::
+resize(int aNumRows)
+{
+	if(aNumRows<0) aNumRows = 0;
+	if(aNumRows>_capacity) reserve(aNumRows);
+	for(int c=0;c<=_numStates && aNumRows>_numRows;c++) {
+		double *col = &_block[0] + (size_t)c*_capacity;
+		fill(col+_numRows, col+aNumRows, 0.0);
+	}
+	_numRows = aNumRows;
+}
+//_____________________________________________________________________________
+/**
+ * Remove all rows and states and release the memory.
+ */
+void StorageColumns::
+clear()
+{
+	vector<double>().swap(_block);
+	_capacity = 0;
+	_numRows = 0;
+	_numStates = 0;
+}
+
+//=============================================================================
+// ACCESS
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Copy the first aN states of a row into rData. aN is clamped to the
+ * number of states.
+ */
+void StorageColumns::
+getRow(int aRow,int aN,double *rData) const
+{
+	if(aN>_numStates) aN = _numStates;
+	if(aN<=0) return;
+	const double *p = &_block[0] + _capacity + aRow;
+	for(int i=0;i<aN;i++,p+=_capacity) rData[i] = *p;
+}
+
+//=============================================================================
+// MODIFY
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Append a row. aY must hold getNumStates() values. The capacity grows
+ * geometrically so that appending n rows costs O(n) copies overall.
+ */
+void StorageColumns::
+appendRow(double aT,const double *aY)
+{
+	if(_numRows==_capacity)
+		reserve(_capacity<16 ? 16 : 2*_capacity);
+	setRow(_numRows++,aT,aY);
+}
+//_____________________________________________________________________________
+/**
+ * Overwrite an existing row. aY must hold getNumStates() values.
+ */
+void StorageColumns::
+setRow(int aRow,double aT,const double *aY)
+{
+	double *p = &_block[0] + aRow;
+	*p = aT;
+	for(int i=0;i<_numStates;i++) {
+		p += _capacity;
+		*p = aY[i];
+	}
+}
+//_____________________________________________________________________________
+/**
+ * Remove aN rows starting at aFirst, shifting later rows up.
+ */
+void StorageColumns::
+removeRows(int aFirst,int aN)
+{
+	if(aFirst<0) { aN += aFirst; aFirst = 0; }
+	if(aFirst+aN>_numRows) aN = _numRows-aFirst;
+	if(aN<=0) return;
+	for(int c=0;c<=_numStates;c++) {
+		double *col = &_block[0] + (size_t)c*_capacity;
+		copy(col+aFirst+aN, col+_numRows, col+aFirst);
+	}
+	_numRows -= aN;
+}
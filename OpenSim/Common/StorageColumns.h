@@ -0,0 +1,153 @@
+#ifndef _StorageColumns_h_
+#define _StorageColumns_h_
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  StorageColumns.h                          *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2012 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimCommonDLL.h"
+#include <vector>
+
+namespace OpenSim {
+
+//=============================================================================
+//=============================================================================
+/**
+ * A column-major block of time-stamped data used as the backing store of a
+ * Storage in column-major mode (see Storage::setColumnMajor()).
+ *
+ * All values live in a single contiguous allocation. Column 0 holds the
+ * times and column 1+j holds state j, each column occupying getCapacity()
+ * consecutive doubles. A column can therefore be handed to numerical
+ * kernels (splines, filters) as a plain pointer, and a row is a strided
+ * view into the same memory. Neither view copies any data.
+ *
+ * Unlike the row storage of Storage, every row has the same number of
+ * states.
+ */
+class OSIMCOMMON_API StorageColumns
+{
+//=============================================================================
+// VIEWS
+//=============================================================================
+public:
+	/** Read-only, non-owning view of one column. It is invalidated by any
+	call that adds rows to, or resizes, the owning StorageColumns. */
+	class ColumnView {
+	public:
+		ColumnView() : _data(0), _size(0) {}
+		ColumnView(const double *aData,int aSize) :
+			_data(aData), _size(aSize) {}
+		int size() const { return _size; }
+		const double* data() const { return _data; }
+		const double& operator[](int i) const { return _data[i]; }
+	private:
+		const double *_data;
+		int _size;
+	};
+
+	/** Read-only, non-owning view of the states of one row. Consecutive
+	elements are getCapacity() doubles apart. It is invalidated by any call
+	that adds rows to, or resizes, the owning StorageColumns. */
+	class RowView {
+	public:
+		RowView() : _data(0), _size(0), _stride(0) {}
+		RowView(const double *aData,int aSize,int aStride) :
+			_data(aData), _size(aSize), _stride(aStride) {}
+		int size() const { return _size; }
+		int stride() const { return _stride; }
+		const double& operator[](int i) const { return _data[i*_stride]; }
+	private:
+		const double *_data;
+		int _size;
+		int _stride;
+	};
+
+//=============================================================================
+// DATA
+//=============================================================================
+private:
+	/** Contiguous column-major block of (1+_numStates) x _capacity values. */
+	std::vector<double> _block;
+	/** Number of rows that can be held without reallocating. */
+	int _capacity;
+	/** Number of rows in use. */
+	int _numRows;
+	/** Number of states (columns not counting time). */
+	int _numStates;
+
+//=============================================================================
+// METHODS
+//=============================================================================
+public:
+	StorageColumns();
+
+	//--------------------------------------------------------------------------
+	// SIZE
+	//--------------------------------------------------------------------------
+	int getNumRows() const { return _numRows; }
+	int getNumStates() const { return _numStates; }
+	int getCapacity() const { return _capacity; }
+	void setNumStates(int aNumStates);
+	void reserve(int aNumRows);
+	void resize(int aNumRows);
+	void clear();
+
+	//--------------------------------------------------------------------------
+	// ACCESS
+	//--------------------------------------------------------------------------
+	double getTime(int aRow) const { return _block[aRow]; }
+	double& updTime(int aRow) { return _block[aRow]; }
+	double getValue(int aRow,int aStateIndex) const
+	{	return _block[(1+aStateIndex)*_capacity + aRow]; }
+	double& updValue(int aRow,int aStateIndex)
+	{	return _block[(1+aStateIndex)*_capacity + aRow]; }
+	/** Pointer to the getNumRows() contiguous times. */
+	const double* getTimes() const { return _block.empty() ? 0 : &_block[0]; }
+	double* updTimes() { return _block.empty() ? 0 : &_block[0]; }
+	/** Pointer to the getNumRows() contiguous values of a state. */
+	const double* getColumn(int aStateIndex) const
+	{	return _block.empty() ? 0 : &_block[(1+aStateIndex)*_capacity]; }
+	double* updColumn(int aStateIndex)
+	{	return _block.empty() ? 0 : &_block[(1+aStateIndex)*_capacity]; }
+	ColumnView getTimeView() const
+	{	return ColumnView(getTimes(),_numRows); }
+	ColumnView getColumnView(int aStateIndex) const
+	{	return ColumnView(getColumn(aStateIndex),_numRows); }
+	RowView getRowView(int aRow) const
+	{	return RowView(_numStates>0 ? &_block[_capacity + aRow] : 0,
+			_numStates,_capacity); }
+	void getRow(int aRow,int aN,double *rData) const;
+
+	//--------------------------------------------------------------------------
+	// MODIFY
+	//--------------------------------------------------------------------------
+	void appendRow(double aT,const double *aY);
+	void setRow(int aRow,double aT,const double *aY);
+	void removeRows(int aFirst,int aN);
+
+//=============================================================================
+};	// END of class StorageColumns
+
+}; //namespace
+//=============================================================================
+//=============================================================================
+
+#endif //_StorageColumns_h_
@@ -0,0 +1,166 @@
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  StorageWriter.cpp                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2012 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDES
+#include "StorageWriter.h"
+#include "StateVector.h"
+#include <vector>
+
+using namespace OpenSim;
+using namespace std;
+
+//=============================================================================
+// CONSTRUCTOR(S) AND DESTRUCTOR
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Start a writer thread that appends rows to an open file.
+ *
+ * @param aFP File to write to, positioned where the rows go.
+ * @param aMaxPendingBlocks Number of blocks that may wait to be written
+ * before write() blocks.
+ */
+StorageWriter::StorageWriter(FILE *aFP,int aMaxPendingBlocks) :
+	_fp(aFP),
+	_maxPendingBlocks(aMaxPendingBlocks<1 ? 1 : aMaxPendingBlocks),
+	_done(false),
+	_busy(false),
+	_failed(false),
+	_numRowsWritten(0)
+{
+	_thread = thread(&StorageWriter::run,this);
+}
+//_____________________________________________________________________________
+/**
+ * Destructor. Writes any pending blocks before returning.
+ */
+StorageWriter::~StorageWriter()
+{
+	finish();
+}
+
+//=============================================================================
+// WRITING
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Queue a block of rows. The contents of rBlock are taken over by the
+ * writer, leaving rBlock empty.
+ */
+void StorageWriter::
+write(StorageColumns &rBlock)
+{
+	unique_lock<mutex> lock(_mutex);
+	while((int)_pending.size()>=_maxPendingBlocks && !_done)
+		_changed.wait(lock);
+	if(_done) return;
+	_pending.push_back(StorageColumns());
+	swap(_pending.back(),rBlock);
+	_changed.notify_all();
+}
+//_____________________________________________________________________________
+/**
+ * Wait until every queued block is in the file.
+ */
+void StorageWriter::
+flush()
+{
+	unique_lock<mutex> lock(_mutex);
+	while(!_pending.empty() || _busy) _changed.wait(lock);
+	if(_fp) fflush(_fp);
+}
+//_____________________________________________________________________________
+/**
+ * Write the queued blocks and stop the writer thread. Further calls to
+ * write() are ignored.
+ */
+void StorageWriter::
+finish()
+{
+	{
+		lock_guard<mutex> lock(_mutex);
+		_done = true;
+		_changed.notify_all();
+	}
+	if(_thread.joinable()) _thread.join();
+	if(_fp) fflush(_fp);
+}
+//_____________________________________________________________________________
+/**
+ * Number of rows written to the file so far.
+ */
+int StorageWriter::
+getNumRowsWritten()
+{
+	lock_guard<mutex> lock(_mutex);
+	return(_numRowsWritten);
+}
+//_____________________________________________________________________________
+/**
+ * Whether writing to the file failed. Rows queued after a failure are
+ * dropped.
+ */
+bool StorageWriter::
+getFailed()
+{
+	lock_guard<mutex> lock(_mutex);
+	return(_failed);
+}
+//_____________________________________________________________________________
+/**
+ * Body of the writer thread.
+ */
+void StorageWriter::
+run()
+{
+	StateVector vec;
+	vector<double> y;
+	for(;;) {
+		StorageColumns block;
+		{
+			unique_lock<mutex> lock(_mutex);
+			while(_pending.empty() && !_done) _changed.wait(lock);
+			if(_pending.empty()) return;
+			swap(block,_pending.front());
+			_pending.pop_front();
+			_busy = true;
+			_changed.notify_all();
+		}
+
+		// Rows are formatted through a StateVector so the output matches
+		// Storage::print().
+		int ns = block.getNumStates();
+		y.resize(ns>0 ? ns : 1);
+		bool ok = !_failed;
+		for(int i=0;ok && i<block.getNumRows();i++) {
+			block.getRow(i,ns,&y[0]);
+			vec.setStates(block.getTime(i),ns,&y[0]);
+			ok = (vec.print(_fp)>=0);
+		}
+
+		lock_guard<mutex> lock(_mutex);
+		if(ok) _numRowsWritten += block.getNumRows();
+		else _failed = true;
+		_busy = false;
+		_changed.notify_all();
+	}
+}
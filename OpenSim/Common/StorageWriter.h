@@ -0,0 +1,96 @@
+#ifndef _StorageWriter_h_
+#define _StorageWriter_h_
+/* -------------------------------------------------------------------------- *
+ *                         OpenSim:  StorageWriter.h                          *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2012 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimCommonDLL.h"
+#include "StorageColumns.h"
+#include <cstdio>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace OpenSim {
+
+//=============================================================================
+//=============================================================================
+/**
+ * A background writer that appends blocks of rows to an open storage file.
+ * It is used by Storage in streaming mode (see Storage::beginStreaming()).
+ *
+ * write() hands a block over to the writer thread and returns immediately,
+ * so formatting and disk I/O overlap with the simulation. At most
+ * getMaxPendingBlocks() blocks wait to be written; beyond that write()
+ * blocks until the writer catches up, which bounds the memory held by the
+ * queue. Rows are formatted exactly as Storage::print() formats them.
+ *
+ * The writer does not own the file; the caller closes it after finish().
+ */
+class OSIMCOMMON_API StorageWriter
+{
+//=============================================================================
+// DATA
+//=============================================================================
+private:
+	FILE *_fp;
+	int _maxPendingBlocks;
+	std::deque<StorageColumns> _pending;
+	std::mutex _mutex;
+	std::condition_variable _changed;
+	/** Set by finish() to stop the thread once the queue is empty. */
+	bool _done;
+	/** Whether the writer thread is formatting a block. */
+	bool _busy;
+	bool _failed;
+	int _numRowsWritten;
+	std::thread _thread;
+
+//=============================================================================
+// METHODS
+//=============================================================================
+public:
+	explicit StorageWriter(FILE *aFP,int aMaxPendingBlocks=2);
+	~StorageWriter();
+
+	void write(StorageColumns &rBlock);
+	void flush();
+	void finish();
+
+	int getMaxPendingBlocks() const { return _maxPendingBlocks; }
+	int getNumRowsWritten();
+	bool getFailed();
+
+private:
+	void run();
+	// Not copyable; the object owns a thread.
+	StorageWriter(const StorageWriter&);
+	StorageWriter& operator=(const StorageWriter&);
+
+//=============================================================================
+};	// END of class StorageWriter
+
+}; //namespace
+//=============================================================================
+//=============================================================================
+
+#endif //__StorageWriter_h__
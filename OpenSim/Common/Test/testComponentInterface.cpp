@@ -565,6 +565,22 @@ int main() {
         ASSERT_EQUAL(3.5, foo.getInputValue<double>(s, "fiberLength"), 1e-10);
         ASSERT_EQUAL(1.5, foo.getInputValue<double>(s, "activation"), 1e-10);
 
+        // A resolved layout reaches the same values as the names.
+        Array<std::string> names;
+        names.append("activation");
+        names.append("fiberLength");
+        Component::StateVariableLayout layout =
+            bar.getStateVariableLayout(s, names);
+        Vector values;
+        bar.getStateVariableValues(s, layout, values);
+        ASSERT_EQUAL(1.5, values[0], 1e-10);
+        ASSERT_EQUAL(3.5, values[1], 1e-10);
+        values[0] = 0.5;
+        values[1] = 2.5;
+        bar.setStateVariableValues(s, layout, values);
+        ASSERT_EQUAL(0.5, bar.getStateVariable(s, "activation"), 1e-10);
+        ASSERT_EQUAL(2.5, bar.getStateVariable(s, "fiberLength"), 1e-10);
+
 		theWorld.print("Doubled" + modelFile);
 	}
     catch (const std::exception& e) {
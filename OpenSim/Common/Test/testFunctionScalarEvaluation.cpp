@@ -0,0 +1,107 @@
+/* -------------------------------------------------------------------------- *
+ *                 OpenSim:  testFunctionScalarEvaluation.cpp                 *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2012 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+#include <OpenSim/Common/GCVSpline.h>
+#include <OpenSim/Common/SimmSpline.h>
+#include <OpenSim/Common/PiecewiseLinearFunction.h>
+#include <OpenSim/Common/Constant.h>
+#include <OpenSim/Common/LinearFunction.h>
+#include <OpenSim/Common/PolynomialFunction.h>
+#include <OpenSim/Common/StepFunction.h>
+#include <OpenSim/Common/Sine.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+
+// The scalar calcValue(double) and calcDerivative(double, order) must agree
+// with evaluating the function's SimTK::Function through an argument Vector,
+// inside and outside the range of the data.
+void compareWithVectorEvaluation(const Function& f, int maxOrder, double tol)
+{
+    SimTK::Function* reference = f.createSimTKFunction();
+    for (double x = -0.5; x < 10.5; x += 0.037) {
+        SimTK::Vector xvec(1, x);
+        double expected = reference->calcValue(xvec);
+        ASSERT_EQUAL(expected, f.calcValue(x), tol*(1 + fabs(expected)), __FILE__, __LINE__);
+        ASSERT_EQUAL(expected, f.calcDerivative(x, 0), tol*(1 + fabs(expected)), __FILE__, __LINE__);
+        for (int order = 1; order <= maxOrder; ++order) {
+            expected = reference->calcDerivative(vector<int>(order, 0), xvec);
+            ASSERT_EQUAL(expected, f.calcDerivative(x, order), tol*(1 + fabs(expected)), __FILE__, __LINE__);
+        }
+    }
+    delete reference;
+}
+
+// Evaluation starts its search from the interval of the previous evaluation;
+// the result must not depend on the order of the queries.
+void compareQueryOrders(const Function& f)
+{
+    vector<double> queries;
+    for (double x = -0.5; x < 10.5; x += 0.013) queries.push_back(x);
+    for (double x = 10.5; x > -0.5; x -= 0.29) queries.push_back(x);
+    for (int i = 0; i < 200; ++i) queries.push_back(fmod(i*7.31, 11.0) - 0.5);
+
+    for (unsigned int i = 0; i < queries.size(); ++i) {
+        Function* fresh = f.clone();
+        for (int order = 0; order <= 2; ++order)
+            ASSERT_EQUAL(fresh->calcDerivative(queries[i], order),
+                f.calcDerivative(queries[i], order), 1e-12, __FILE__, __LINE__);
+        delete fresh;
+    }
+}
+
+int main() {
+    try {
+        double x[] = {0.0, 1.0, 2.0, 2.5, 3.2, 4.0, 5.0, 6.1, 7.0, 8.5, 10.0};
+        double y[] = {0.5, 0.7, 2.0, -1.0, -0.4, 0.3, 0.5, 1.2, 0.8, 0.2, 0.1};
+        int n = 11;
+
+        compareWithVectorEvaluation(GCVSpline(5, n, x, y), 3, 1e-10);
+        compareWithVectorEvaluation(GCVSpline(3, n, x, y), 2, 1e-10);
+        compareWithVectorEvaluation(SimmSpline(n, x, y), 2, 1e-12);
+        compareWithVectorEvaluation(PiecewiseLinearFunction(n, x, y), 2, 1e-12);
+        compareWithVectorEvaluation(LinearFunction(-1.5, 0.25), 2, 1e-12);
+        compareWithVectorEvaluation(PolynomialFunction(SimTK::Vector(SimTK::Vec4(0.3, -1.0, 2.0, 0.5))), 4, 1e-12);
+        compareWithVectorEvaluation(StepFunction(2.0, 6.5, -1.0, 3.0), 3, 1e-12);
+        compareWithVectorEvaluation(Sine(1.5, 2.0, 0.3), 3, 1e-12);
+
+        compareQueryOrders(GCVSpline(5, n, x, y));
+        compareQueryOrders(SimmSpline(n, x, y));
+        compareQueryOrders(PiecewiseLinearFunction(n, x, y));
+
+        Constant constant(2.5);
+        ASSERT_EQUAL(2.5, constant.calcValue(1.0), 0.0, __FILE__, __LINE__);
+        ASSERT_EQUAL(0.0, constant.calcDerivative(1.0, 1), 0.0, __FILE__, __LINE__);
+
+        // A Function used through the base class takes the scalar path too.
+        const Function& f = SimmSpline(n, x, y);
+        ASSERT_EQUAL(f.calcValue(SimTK::Vector(1, 4.4)), f.calcValue(4.4), 1e-12, __FILE__, __LINE__);
+    }
+    catch (const Exception& e) {
+        e.print(cerr);
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
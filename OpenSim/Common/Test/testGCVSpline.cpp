@@ -21,11 +21,77 @@
  * -------------------------------------------------------------------------- */
 
 #include <OpenSim/Common/GCVSpline.h>
+#include <OpenSim/Common/GCVSplineSet.h>
+#include <OpenSim/Common/Constant.h>
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
 
 using namespace OpenSim;
 using namespace std;
 
+// Evaluating a whole set at many times at once must match evaluating each
+// function, derivative and time on its own.
+void testBatchEvaluation()
+{
+	const int size = 60;
+	double x[size], y[size];
+	GCVSplineSet splines;
+	for (int f = 0; f < 8; ++f) {
+		for (int i = 0; i < size; ++i) {
+			x[i] = 0.05*i + 0.001*(i%3);
+			y[i] = sin((f+1)*x[i]) + 0.1*f*x[i]*x[i];
+		}
+		splines.adoptAndAppend(new GCVSpline(5, size, x, y));
+		// Functions that cannot be evaluated with the rest
+		if (f == 3) splines.adoptAndAppend(new Constant(2.5));
+		if (f == 5) splines.adoptAndAppend(new GCVSpline(3, size, x, y));
+	}
+	int nf = splines.getSize();
+
+	vector<double> times;
+	for (double t = -0.1; t < 0.05*size + 0.1; t += 0.0173)
+		times.push_back(t);
+	const int derivOrders[] = {0, 1, 2, 3};
+	int nt = (int)times.size();
+	vector<double> values(nt*4*nf);
+	splines.evaluate(nt, &times[0], 4, derivOrders, &values[0]);
+
+	for (int i = 0; i < nt; ++i) {
+		for (int d = 0; d < 4; ++d) {
+			for (int f = 0; f < nf; ++f) {
+				double expected = splines.evaluate(f, derivOrders[d], times[i]);
+				ASSERT_EQUAL(expected, values[(i*4 + d)*nf + f],
+					1e-9*(1 + fabs(expected)), __FILE__, __LINE__);
+			}
+		}
+	}
+}
+
+// Changing the degree of a spline must refit it, so that it evaluates as a
+// spline made with that degree.
+void testChangeDegree()
+{
+	const int size = 50;
+	double x[size], y[size];
+	for (int i = 0; i < size; ++i) {
+		x[i] = 0.1*i;
+		y[i] = sin(x[i]) + 0.2*x[i]*x[i];
+	}
+	GCVSpline spline(5, size, x, y);
+	const int degrees[] = {3, 1, 7};
+	for (int k = 0; k < 3; ++k) {
+		spline.setDegree(degrees[k]);
+		GCVSpline expected(degrees[k], size, x, y);
+		for (int i = 0; i < 10*(size-1); ++i) {
+			double t = 0.01*i;
+			for (int d = 0; d < 2; ++d) {
+				double value = expected.calcDerivative(t, d);
+				ASSERT_EQUAL(value, spline.calcDerivative(t, d),
+					1e-9*(1 + fabs(value)), __FILE__, __LINE__);
+			}
+		}
+	}
+}
+
 int main() {
     try {
         const int size = 100;
@@ -38,6 +104,8 @@ int main() {
         for (int i = 0; i < 10*(size-1); ++i) {
             ASSERT_EQUAL(sin(0.01*i), spline.calcValue(SimTK::Vector(1, 0.01*i)), 1e-4, __FILE__, __LINE__);
         }
+        testBatchEvaluation();
+        testChangeDegree();
     }
     catch(const Exception& e) {
         e.print(cerr);
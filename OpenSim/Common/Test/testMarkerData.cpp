@@ -81,6 +81,17 @@ int main() {
 		const SimTK::Vec3& m31 = markers3[1];    
 		SimTK::Vec3 diff3 = (markers3[1]-SimTK::Vec3(expectedData3));
 		ASSERT(diff.norm() < 1e-7, __FILE__, __LINE__);
+
+		// Round trip through the binary format
+		ASSERT(md2.printBinary("testNaNsParsing.osb"), __FILE__, __LINE__);
+		MarkerData md4("testNaNsParsing.osb");
+		ASSERT(md4.getNumFrames()==md2.getNumFrames(), __FILE__, __LINE__);
+		ASSERT(md4.getMarkerNames()==md2.getMarkerNames(), __FILE__, __LINE__);
+		ASSERT(md4.getUnits().getType()==md2.getUnits().getType(), __FILE__, __LINE__);
+		ASSERT(md4.getDataRate()==md2.getDataRate(), __FILE__, __LINE__);
+		const SimTK::Array_<SimTK::Vec3>& markers4 = md4.getFrame(1).getMarkers();
+		ASSERT(SimTK::isNaN(markers4[0][0]), __FILE__, __LINE__);
+		ASSERT(markers4[1]==markers[1], __FILE__, __LINE__);
 	}
     catch(const Exception& e) {
         e.print(cerr);
@@ -0,0 +1,110 @@
+/* -------------------------------------------------------------------------- *
+ *                           OpenSim:  testSet.cpp                            *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2012 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include <OpenSim/Common/Set.h>
+#include <OpenSim/Common/Constant.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+
+// Reference: the first element named aName at or after aStart, else the first
+// from the beginning.
+static int linearIndex(const Set<Function>& aSet, const string& aName,
+	int aStart=0)
+{
+	int n = aSet.getSize();
+	if(aStart<0 || aStart>=n) aStart = 0;
+	for(int i=aStart; i<n; ++i) if(aSet[i].getName()==aName) return i;
+	for(int i=0; i<aStart; ++i) if(aSet[i].getName()==aName) return i;
+	return -1;
+}
+
+static void checkLookups(const Set<Function>& aSet)
+{
+	for(int i=0; i<aSet.getSize(); ++i) {
+		const string& name = aSet[i].getName();
+		for(int start=-1; start<=aSet.getSize(); start+=3)
+			ASSERT(aSet.getIndex(name, start)==linearIndex(aSet, name, start));
+		ASSERT(aSet.contains(name));
+		ASSERT(&aSet.get(name)==&aSet[linearIndex(aSet, name)]);
+	}
+	ASSERT(aSet.getIndex("missing")==-1 && !aSet.contains("missing"));
+}
+
+int main() {
+	try {
+		Set<Function> functions;
+		for(int i=0; i<50; ++i) {
+			Constant* c = new Constant(i);
+			// a few repeated names
+			char name[16];
+			sprintf(name, "f%d", (i%10==9) ? i-9 : i);
+			c->setName(name);
+			functions.adoptAndAppend(c);
+		}
+		checkLookups(functions);
+
+		// Renaming a member is seen by the next lookup
+		functions[20].setName("renamed");
+		ASSERT(functions.getIndex("renamed")==20);
+		ASSERT(functions.getIndex("f20")==-1);
+		functions[30].setName("f0");
+		checkLookups(functions);
+
+		// Renaming an Object that is not a member leaves the names alone
+		Constant outside(0.0);
+		outside.setName("renamed");
+		ASSERT(functions.getIndex("renamed")==20);
+		checkLookups(functions);
+
+		// Structural changes
+		functions.remove(0);
+		checkLookups(functions);
+		Constant* c = new Constant(1.0);
+		c->setName("inserted");
+		functions.insert(5, c);
+		ASSERT(functions.getIndex("inserted")==5);
+		checkLookups(functions);
+		c = new Constant(2.0);
+		c->setName("replacement");
+		functions.set(7, c);
+		checkLookups(functions);
+
+		// Assigning an element renames it; copying the set keeps the names
+		functions[10] = functions[11];
+		checkLookups(functions);
+		Set<Function> copy(functions);
+		checkLookups(copy);
+		ASSERT(copy.getIndex("inserted")==5);
+
+		functions.setSize(3);
+		checkLookups(functions);
+		ASSERT(functions.getIndex("inserted")==-1);
+	}
+	catch (const Exception& e) {
+		e.print(cerr);
+		return 1;
+	}
+	cout << "Done" << endl;
+	return 0;
+}
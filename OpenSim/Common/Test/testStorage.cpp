@@ -22,6 +22,7 @@
 
 #include <fstream>
 #include <OpenSim/Common/Storage.h>
+#include <OpenSim/Common/StorageBinaryFile.h>
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
 
 using namespace OpenSim;
@@ -63,6 +64,23 @@ int main() {
 		ASSERT(col[1]==40.0);
 	
 		ASSERT(st->getStateIndex("v2")==1);
+		ASSERT(st->getStateIndex("v3")==-1 && st->getColumnIndex("time")==0);
+
+		// Label lookups follow label changes, including repeated labels
+		Storage labeled(*st);
+		Array<std::string> newLabels;
+		newLabels.append("time"); newLabels.append("r_knee.x");
+		newLabels.append("r_knee.y"); newLabels.append("r_hip");
+		newLabels.append("r_knee.x");
+		labeled.setColumnLabels(newLabels);
+		ASSERT(labeled.getStateIndex("v2")==-1);
+		ASSERT(labeled.getStateIndex("r_knee.x")==0);
+		ASSERT(labeled.getStateIndex("r_knee.x", 2)==3);
+		ASSERT(labeled.getStateIndex("r_knee.x", 5)==-1);
+		Array<int> knee = labeled.getColumnIndicesForIdentifier("r_knee");
+		ASSERT(knee.getSize()==3 && knee[0]==1 && knee[1]==2 && knee[2]==4);
+		ASSERT(labeled.getColumnIndicesForIdentifier("r_").getSize()==4);
+		ASSERT(labeled.getColumnIndicesForIdentifier("l_").getSize()==0);
 
 		Storage st2("testDiff.sto");
 		// Test Comparison
@@ -71,6 +89,115 @@ int main() {
 		diff = st->compareColumn(st2, stdLabels[2], 0.);
 		ASSERT(fabs(diff) < 1E-7);
 
+		// Column-major storage must agree with the row storage
+		Storage stCols("test.sto", false, true);
+		ASSERT(stCols.isColumnMajor());
+		ASSERT(stCols.getSize()==st->getSize());
+		ASSERT(stCols.getSmallestNumberOfStates()==ncol);
+		stCols.getDataColumn(1, col);
+		ASSERT(col[0]==20.);
+		ASSERT(col[1]==40.0);
+		ASSERT(stCols.getColumnView(1)[1]==40.0);
+		ASSERT(stCols.getRowView(1)[0]==20.0);
+		ASSERT(stCols.getTimeView()[1]==2.0);
+		stCols.append(3.0, 2, &col[0]);
+		ASSERT(stCols.getSize()==3 && stCols.getLastTime()==3.0);
+		Array<double> interp(0.0, 2);
+		stCols.getDataAtTime(1.5, 2, interp);
+		ASSERT(interp[0]==15.0);
+		diff = stCols.compareColumn(st2, stdLabels[2], 0., 2.);
+		ASSERT(fabs(diff) < 1E-7);
+		// Asking for a StateVector converts the data back to rows
+		ASSERT(stCols.getStateVector(0)->getData()[1]==20.0);
+		ASSERT(!stCols.isColumnMajor() && stCols.getColumnMajor());
+		stCols.purge();
+		ASSERT(stCols.isColumnMajor() && stCols.getSize()==0);
+
+		// Binary files keep the header and the exact values
+		st->addKeyValuePair("DataRate", "100");
+		st->setInDegrees(true);
+		ASSERT(st->printBinary("test.osb"));
+		Storage stBin("test.osb");
+		ASSERT(stBin.getSize()==st->getSize());
+		ASSERT(stBin.getColumnLabels()==st->getColumnLabels());
+		ASSERT(stBin.getName()==st->getName());
+		ASSERT(stBin.isInDegrees() && stBin.hasKey("DataRate"));
+		diff = stBin.compareColumn(*st, stdLabels[2], 0.);
+		ASSERT(diff==0.0);
+		StorageBinaryFile binFile("test.osb");
+		ASSERT(binFile.getNumRows()==2 && binFile.getNumStates()==2);
+		ASSERT(binFile.getColumn(1)[1]==40.0 && binFile.getTimes()[0]==1.0);
+
+		// Streaming keeps a bounded window in memory and all rows in the file.
+		// Printing does not end the stream, so a later print has every row.
+		double y[2];
+		{
+			Storage stream(512, "stream");
+			stream.setColumnLabels(st->getColumnLabels());
+			stream.beginStreaming("testStream_scratch.sto", 100);
+			for(int pass=0; pass<2; pass++){
+				int nr = (pass+1)*5000;
+				for(i=pass*5000; i<nr; i++){
+					y[0] = 0.5*i;  y[1] = -1.0*i;
+					stream.append(0.01*i, 2, y);
+					ASSERT(stream.getSize()<200);
+				}
+				ASSERT(stream.isStreaming() && stream.getNumStreamedRows()>=nr-200);
+				ASSERT(stream.getLastTime()==0.01*(nr-1));
+				ASSERT(stream.print("testStream.sto"));
+				ASSERT(stream.isStreaming());
+				Storage streamed("testStream.sto");
+				ASSERT(streamed.getSize()==nr);
+				ASSERT(streamed.getColumnLabels()==st->getColumnLabels());
+				for(i=0; i<streamed.getSize(); i++){
+					const StateVector& row = *streamed.getStateVector(i);
+					ASSERT(row.getData()[0]==0.5*i && row.getData()[1]==-1.0*i);
+				}
+			}
+			ASSERT(ifstream("testStream_scratch.sto").good());
+		}
+		// The scratch file goes with the storage
+		ASSERT(!ifstream("testStream_scratch.sto").good());
+
+		// Time searches agree with a linear search for uniform, non-uniform
+		// and repeated time stamps, in row and column form
+		for(int form=0; form<2; form++){
+			Storage times(512, "times");
+			times.setColumnMajor(form==1);
+			double t = 0.0;
+			for(i=0; i<300; i++){
+				y[0] = y[1] = i;
+				times.append(t, 2, y, false);
+				t += (i<100) ? 0.01 : ((i%7==0) ? 0.0 : 0.001*(i%5+1));
+			}
+			ASSERT(times.isColumnMajor()==(form==1));
+			double lastTime = times.getLastTime();
+			for(int q=0; q<2000; q++){
+				double tq = -0.05 + (lastTime+0.1)*((q*7919)%2000)/2000.0;
+				if(q%3==0) times.getTime((q*31)%300, tq);
+				int expected = 0;
+				for(int k=0; k<times.getSize(); k++){
+					double tk;
+					times.getTime(k, tk);
+					if(tq<tk) break;
+					expected = k;
+				}
+				ASSERT(times.findIndex(tq)==expected);
+				ASSERT(times.findIndex(q%300, tq)==expected);
+			}
+
+			// A const storage hands out rows in either form without
+			// converting it, and distinct rows do not alias
+			const Storage& constTimes = times;
+			const StateVector* first = constTimes.getStateVector(1);
+			const StateVector* last = constTimes.getLastStateVector();
+			ASSERT(times.isColumnMajor()==(form==1));
+			ASSERT(first!=last);
+			ASSERT(first->getTime()==0.01 && first->getData()[0]==1.0);
+			ASSERT(last->getTime()==lastTime && last->getData()[1]==299.0);
+			ASSERT(constTimes.getStateVector(1)==first);
+		}
+
 		delete st;
     }
     catch (const Exception& e) {
@@ -0,0 +1,160 @@
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  testTextDataParser.cpp                      *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2012 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// Checks that the memory-mapped parser reads .sto and .trc files exactly as
+// the stream parsers do, and compares the time both take on a large file.
+
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <OpenSim/Common/Storage.h>
+#include <OpenSim/Common/MarkerData.h>
+#include <OpenSim/Common/TextDataParser.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+
+static void testParseNumber()
+{
+	const char *text[] = { "1009.526917", "-1.52E-01", "NaN", "-inf", ".5",
+		"3.", "1e-320", "0.1234567890123456789" };
+	for(int i=0;i<8;i++) {
+		const char *p = text[i];
+		double value;
+		ASSERT(TextDataParser::parseNumber(p, p+strlen(p), value));
+		ASSERT(*p=='\0');
+		double expected = (i==2) ? SimTK::NaN : strtod(text[i], 0);
+		ASSERT(i==2 ? SimTK::isNaN(value) : value==expected);
+	}
+	const char *word = "time";
+	double value;
+	ASSERT(!TextDataParser::parseNumber(word, word+4, value));
+}
+
+static void writeLargeStorage(const string &aFileName, int aNumRows, int aNumColumns)
+{
+	Storage st(aNumRows);
+	st.setName("large");
+	Array<string> labels("", aNumColumns+1);
+	labels[0] = "time";
+	for(int j=0;j<aNumColumns;j++) {
+		char label[16];
+		sprintf(label, "q%d", j);
+		labels[j+1] = label;
+	}
+	st.setColumnLabels(labels);
+	Array<double> y(0.0, aNumColumns);
+	for(int i=0;i<aNumRows;i++) {
+		for(int j=0;j<aNumColumns;j++) y[j] = sin(0.001*i*(j+1)) * (j+1);
+		st.append(0.001*i, aNumColumns, &y[0]);
+	}
+	st.print(aFileName);
+}
+
+static void testStorage()
+{
+	const int nr = 20000, nc = 60;
+	writeLargeStorage("testTextDataParser.sto", nr, nc);
+
+	TextDataParser::setEnabled(false);
+	double start = SimTK::realTime();
+	Storage streamed("testTextDataParser.sto");
+	double streamTime = SimTK::realTime() - start;
+
+	TextDataParser::setEnabled(true);
+	start = SimTK::realTime();
+	Storage mapped("testTextDataParser.sto");
+	double mappedTime = SimTK::realTime() - start;
+	start = SimTK::realTime();
+	Storage mappedColumns("testTextDataParser.sto", false, true);
+	double columnsTime = SimTK::realTime() - start;
+
+	cout << "Reading " << nr << " x " << nc+1 << " storage: stream "
+		<< streamTime << "s, mapped " << mappedTime << "s, mapped into columns "
+		<< columnsTime << "s" << endl;
+
+	ASSERT(streamed.getSize()==nr && mapped.getSize()==nr);
+	ASSERT(mappedColumns.isColumnMajor() && mappedColumns.getSize()==nr);
+	ASSERT(mapped.getColumnLabels()==streamed.getColumnLabels());
+	for(int i=0;i<nr;i++) {
+		const StateVector &a = *streamed.getStateVector(i);
+		const StateVector &b = *mapped.getStateVector(i);
+		ASSERT(a.getTime()==b.getTime() && a.getSize()==b.getSize());
+		ASSERT(mappedColumns.getTimeView()[i]==a.getTime());
+		for(int j=0;j<nc;j++) {
+			ASSERT(a.getData()[j]==b.getData()[j]);
+			ASSERT(mappedColumns.getColumnView(j)[i]==a.getData()[j]);
+		}
+	}
+
+	// Rows that wrap over several lines are not a table the mapped parser
+	// accepts; such a file must still load through the stream.
+	ofstream wrapped("testTextDataParserWrapped.sto");
+	wrapped << "wrapped\nnRows=2\nnColumns=3\nendheader\ntime\tv1\tv2\n"
+		<< "1.0\t10.0\n20.0\n2.0\t20.0\t40.0\n";
+	wrapped.close();
+	Storage st("testTextDataParserWrapped.sto");
+	ASSERT(st.getSize()==2 && st.getStateVector(1)->getData()[1]==40.0);
+	ASSERT(st.getStateVector(0)->getData()[1]==20.0);
+}
+
+static void testMarkerData()
+{
+	const char *files[] = { "TRCFileWithNANs.trc", "testNaNsParsing.trc",
+		"testEformatParsing.trc" };
+	for(int f=0;f<3;f++) {
+		TextDataParser::setEnabled(false);
+		MarkerData streamed(files[f]);
+		TextDataParser::setEnabled(true);
+		MarkerData mapped(files[f]);
+		ASSERT(streamed.getNumFrames()==mapped.getNumFrames());
+		for(int i=0;i<mapped.getNumFrames();i++) {
+			const MarkerFrame &a = streamed.getFrame(i);
+			const MarkerFrame &b = mapped.getFrame(i);
+			ASSERT(a.getFrameNumber()==b.getFrameNumber());
+			ASSERT(a.getFrameTime()==b.getFrameTime());
+			ASSERT(a.getMarkers().size()==b.getMarkers().size());
+			for(unsigned m=0;m<a.getMarkers().size();m++) {
+				for(int k=0;k<3;k++) {
+					double x = a.getMarkers()[m][k], y = b.getMarkers()[m][k];
+					ASSERT(x==y || (SimTK::isNaN(x) && SimTK::isNaN(y)));
+				}
+			}
+		}
+	}
+}
+
+int main()
+{
+	try {
+		testParseNumber();
+		testStorage();
+		testMarkerData();
+	}
+	catch (const Exception& e) {
+		e.print(cerr);
+		return 1;
+	}
+	cout << "Done" << endl;
+	return 0;
+}
@@ -0,0 +1,399 @@
+/* -------------------------------------------------------------------------- *
+ *                       OpenSim:  TextDataParser.cpp                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2012 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDES
+#include "TextDataParser.h"
+#include "Exception.h"
+#include "SimTKcommon.h"
+#include "SimTKcommon/internal/ParallelExecutor.h"
+#include <clocale>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+using namespace OpenSim;
+using namespace std;
+
+//=============================================================================
+// STATICS
+//=============================================================================
+std::atomic<bool> TextDataParser::_enabled(true);
+std::atomic<int> TextDataParser::_numThreads(0);
+
+namespace {
+
+/** Bodies smaller than this are converted on the calling thread. */
+const size_t MIN_CHUNK_BYTES = 1<<16;
+
+/** Powers of ten that are exactly representable as doubles. */
+const double POW10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9,
+	1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21,
+	1e22 };
+
+inline bool isBlank(char c)
+{	return c==' ' || c=='\t' || c=='\r'; }
+
+inline bool isDelimiter(const char *p,const char *aEnd)
+{	return p==aEnd || isBlank(*p) || *p=='\n'; }
+
+/** Match a lower-case word case-insensitively and advance past it. */
+bool matchWord(const char *&rPos,const char *aEnd,const char *aWord)
+{
+	const char *p = rPos;
+	for(; *aWord; ++aWord, ++p) {
+		if(p==aEnd || (*p|0x20)!=*aWord) return false;
+	}
+	rPos = p;
+	return true;
+}
+
+/** Whether a line holds anything besides white space. */
+bool hasData(const char *p,const char *aEnd)
+{
+	for(; p<aEnd; ++p) if(!isBlank(*p)) return true;
+	return false;
+}
+
+/** End of the line starting at p, i.e., the position of its '\n' or aEnd. */
+inline const char* endOfLine(const char *p,const char *aEnd)
+{
+	const char *eol = (const char*)memchr(p,'\n',aEnd-p);
+	return eol ? eol : aEnd;
+}
+
+/**
+ * Parse a line of white-space separated values. The line must hold exactly
+ * aNumColumns numbers.
+ */
+bool parseSpaceLine(const char *p,const char *aEnd,int aNumColumns,
+	double *rRow,int aLeadingDimension,char aDecimalPoint)
+{
+	int c = 0;
+	for(;;) {
+		while(p<aEnd && isBlank(*p)) ++p;
+		if(p==aEnd) break;
+		if(c==aNumColumns) return false;
+		double value;
+		if(!TextDataParser::parseNumber(p,aEnd,value,aDecimalPoint))
+			return false;
+		if(!isDelimiter(p,aEnd)) return false;
+		rRow[(size_t)c*aLeadingDimension] = value;
+		c++;
+	}
+	return c==aNumColumns;
+}
+
+/**
+ * Parse a line of tab separated fields as written in TRC files. An empty
+ * field is a missing value (NaN), as are fields missing at the end of the
+ * line; fields beyond aNumColumns are ignored.
+ */
+bool parseTabLine(const char *p,const char *aEnd,int aNumColumns,
+	double *rRow,int aLeadingDimension,char aDecimalPoint)
+{
+	int c = 0;
+	while(c<aNumColumns && p<=aEnd) {
+		const char *eof = (const char*)memchr(p,'\t',aEnd-p);
+		if(!eof) eof = aEnd;
+		while(p<eof && (*p==' ' || *p=='\r')) ++p;
+		double value = SimTK::NaN;
+		if(p<eof) {
+			if(!TextDataParser::parseNumber(p,eof,value,aDecimalPoint))
+				return false;
+			while(p<eof && (*p==' ' || *p=='\r')) ++p;
+			if(p!=eof) return false;
+		}
+		rRow[(size_t)c*aLeadingDimension] = value;
+		c++;
+		p = eof+1;
+	}
+	for(; c<aNumColumns; c++)
+		rRow[(size_t)c*aLeadingDimension] = SimTK::NaN;
+	return true;
+}
+
+/**
+ * Work shared by the threads converting a file body. Pass 0 counts the rows
+ * of each chunk; pass 1 converts them, each chunk starting at the row that
+ * follows the rows of all earlier chunks.
+ */
+class ParseTask : public SimTK::ParallelExecutor::Task {
+public:
+	ParseTask(const vector<const char*> &aStarts,int aMaxRows,int aNumColumns,
+		double *rBlock,int aLeadingDimension,bool aTabDelimited,
+		char aDecimalPoint) :
+		_starts(aStarts), _maxRows(aMaxRows), _numColumns(aNumColumns),
+		_block(rBlock), _ld(aLeadingDimension), _tabDelimited(aTabDelimited),
+		_decimalPoint(aDecimalPoint), _pass(0), _numRows(aStarts.size()-1,0), _firstRow(aStarts.size()-1,0),
+		_failedRow(aStarts.size()-1,-1) {}
+
+	void setPass(int aPass) { _pass = aPass; }
+	int getNumChunks() const { return (int)_numRows.size(); }
+
+	/** Number the chunks' first rows and return the number of rows to keep. */
+	int numberRows() {
+		int row = 0;
+		for(int i=0;i<getNumChunks();i++) {
+			_firstRow[i] = row;
+			row += _numRows[i];
+		}
+		return row<_maxRows ? row : _maxRows;
+	}
+	/** First row that could not be parsed, or -1. */
+	int getFailedRow() const {
+		for(int i=0;i<getNumChunks();i++)
+			if(_failedRow[i]>=0) return _failedRow[i];
+		return -1;
+	}
+
+	void execute(int aChunk) {
+		const char *p = _starts[aChunk];
+		const char *end = _starts[aChunk+1];
+		int row = _firstRow[aChunk];
+		while(p<end) {
+			const char *eol = endOfLine(p,end);
+			if(hasData(p,eol)) {
+				if(_pass==0) {
+					_numRows[aChunk]++;
+				} else {
+					if(row>=_maxRows) return;
+					bool ok = _tabDelimited ?
+						parseTabLine(p,eol,_numColumns,_block+row,_ld,
+							_decimalPoint) :
+						parseSpaceLine(p,eol,_numColumns,_block+row,_ld,
+							_decimalPoint);
+					if(!ok) { _failedRow[aChunk] = row; return; }
+					row++;
+				}
+			}
+			p = eol+1;
+		}
+	}
+
+private:
+	const vector<const char*> &_starts;
+	int _maxRows;
+	int _numColumns;
+	double *_block;
+	int _ld;
+	bool _tabDelimited;
+	char _decimalPoint;
+	int _pass;
+	vector<int> _numRows;
+	vector<int> _firstRow;
+	vector<int> _failedRow;
+};
+
+void runTask(ParseTask &aTask,int aNumThreads)
+{
+	int n = aTask.getNumChunks();
+	if(n==1 || aNumThreads==1) {
+		for(int i=0;i<n;i++) aTask.execute(i);
+	} else {
+		SimTK::ParallelExecutor executor(aNumThreads);
+		executor.execute(aTask,n);
+	}
+}
+
+} // namespace
+
+//=============================================================================
+// CONSTRUCTOR(S)
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Map a file into memory for reading.
+ */
+TextDataParser::TextDataParser(const string &aFileName) :
+	_file(aFileName)
+{
+}
+
+//=============================================================================
+// PARSING
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Convert the rows of the file that start at a byte offset. Blank lines are
+ * skipped. Value c of row r is written to rBlock[c*aLeadingDimension + r].
+ *
+ * @param aOffset Offset of the first data row, e.g., the stream position
+ * after the column labels were read.
+ * @param aMaxRows Maximum number of rows to convert (rBlock must have room
+ * for that many); any further rows are ignored.
+ * @param aNumColumns Number of values per row.
+ * @param rBlock Column-major destination block.
+ * @param aLeadingDimension Distance between consecutive columns in rBlock.
+ * @param aTabDelimited If false, values are separated by any white space and
+ * each row must hold exactly aNumColumns values. If true, values are
+ * separated by single tabs and empty or missing values are NaN (TRC files).
+ * @return Number of rows converted, or -1 if the body could not be parsed
+ * (see getErrorMessage()).
+ */
+int TextDataParser::
+parseRows(size_t aOffset,int aMaxRows,int aNumColumns,
+	double *rBlock,int aLeadingDimension,bool aTabDelimited)
+{
+	_errorMessage = "";
+	if(aOffset>=_file.getSize() || aMaxRows<=0) return(0);
+
+	// SPLIT THE BODY INTO CHUNKS OF WHOLE LINES
+	const char *begin = _file.getData() + aOffset;
+	const char *end = _file.getData() + _file.getSize();
+	size_t bytes = end - begin;
+	int numThreads = _numThreads;
+	if(numThreads<1) numThreads = SimTK::ParallelExecutor::getNumProcessors();
+	size_t numChunks = (numThreads>1) ? 4*numThreads : 1;
+	if(numChunks>bytes/MIN_CHUNK_BYTES) numChunks = bytes/MIN_CHUNK_BYTES;
+	if(numChunks<1) numChunks = 1;
+	vector<const char*> starts(numChunks+1,end);
+	starts[0] = begin;
+	for(size_t i=1;i<numChunks;i++) {
+		const char *p = begin + i*(bytes/numChunks);
+		if(p<starts[i-1]) p = starts[i-1];
+		const char *eol = endOfLine(p,end);
+		starts[i] = (eol<end) ? eol+1 : end;
+	}
+
+	// COUNT, THEN CONVERT
+	// The locale is read here, once; the threads only get its decimal point.
+	ParseTask task(starts,aMaxRows,aNumColumns,rBlock,aLeadingDimension,
+		aTabDelimited,getLocaleDecimalPoint());
+	runTask(task,numThreads);
+	int numRows = task.numberRows();
+	task.setPass(1);
+	runTask(task,numThreads);
+
+	int failedRow = task.getFailedRow();
+	if(failedRow>=0) {
+		ostringstream msg;
+		msg << "TextDataParser.parseRows: could not parse data row " << failedRow
+			<< " (expected " << aNumColumns << " numeric values).";
+		_errorMessage = msg.str();
+		return(-1);
+	}
+	return(numRows);
+}
+//_____________________________________________________________________________
+/**
+ * Convert one number without regard to the C locale. Accepts an optional
+ * sign, digits with an optional '.', an optional exponent, and "nan", "inf"
+ * or "infinity" in any case. On success rPos is moved past the number.
+ *
+ * Numbers with at most 15 significant digits and a decimal exponent of at
+ * most 22 (which covers what OpenSim writes) are converted with a single
+ * correctly rounded operation. Anything else is handed to strtod, so the
+ * result is always the correctly rounded value.
+ *
+ * @param aDecimalPoint The decimal point of the C locale, which strtod
+ * expects in place of '.'. Threads converting numbers concurrently are
+ * given the one read by getLocaleDecimalPoint() before they start, since
+ * localeconv() may not be called while another thread sets the locale.
+ * @return false if no number starts at rPos.
+ */
+bool TextDataParser::
+parseNumber(const char *&rPos,const char *aEnd,double &rValue,
+	char aDecimalPoint)
+{
+	const char *p = rPos;
+	bool negative = false;
+	if(p<aEnd && (*p=='-' || *p=='+')) negative = (*p++=='-');
+
+	// NAN AND INFINITY
+	if(p<aEnd && ((*p|0x20)=='n' || (*p|0x20)=='i')) {
+		if(matchWord(p,aEnd,"nan")) {
+			rValue = SimTK::NaN;
+		} else if(matchWord(p,aEnd,"infinity") || matchWord(p,aEnd,"inf")) {
+			rValue = negative ? -SimTK::Infinity : SimTK::Infinity;
+		} else {
+			return(false);
+		}
+		rPos = p;
+		return(true);
+	}
+
+	// MANTISSA
+	unsigned long long mantissa = 0;
+	int numDigits = 0, exponent = 0;
+	bool anyDigits = false, truncated = false;
+	for(; p<aEnd && *p>='0' && *p<='9'; ++p) {
+		int d = *p - '0';
+		anyDigits = true;
+		if(mantissa==0 && d==0) continue;
+		if(numDigits<19) { mantissa = 10*mantissa + d; numDigits++; }
+		else { exponent++; truncated |= (d!=0); }
+	}
+	if(p<aEnd && *p=='.') {
+		for(++p; p<aEnd && *p>='0' && *p<='9'; ++p) {
+			int d = *p - '0';
+			anyDigits = true;
+			if(mantissa==0 && d==0) { exponent--; continue; }
+			if(numDigits<19) { mantissa = 10*mantissa + d; numDigits++; exponent--; }
+			else truncated |= (d!=0);
+		}
+	}
+	if(!anyDigits) return(false);
+
+	// EXPONENT
+	if(p<aEnd && (*p|0x20)=='e') {
+		const char *q = p+1;
+		bool negativeExponent = false;
+		if(q<aEnd && (*q=='-' || *q=='+')) negativeExponent = (*q++=='-');
+		if(q<aEnd && *q>='0' && *q<='9') {
+			int e = 0;
+			for(; q<aEnd && *q>='0' && *q<='9'; ++q)
+				if(e<100000) e = 10*e + (*q-'0');
+			exponent += negativeExponent ? -e : e;
+			p = q;
+		}
+	}
+
+	// CONVERT
+	double value;
+	if(mantissa==0) {
+		value = 0.0;
+	} else if(!truncated && mantissa<=(1ULL<<53) && exponent>=-22 && exponent<=22) {
+		value = (double)mantissa;
+		value = (exponent<0) ? value/POW10[-exponent] : value*POW10[exponent];
+	} else {
+		// strtod honors the locale's decimal point, so substitute it.
+		string token(rPos,p);
+		for(size_t i=0;i<token.size();i++)
+			if(token[i]=='.') token[i] = aDecimalPoint;
+		value = fabs(strtod(token.c_str(),0));
+	}
+	rValue = negative ? -value : value;
+	rPos = p;
+	return(true);
+}
+//_____________________________________________________________________________
+/**
+ * The decimal point of the current C locale. Read it on one thread and hand
+ * it to the threads that call parseNumber().
+ */
+char TextDataParser::
+getLocaleDecimalPoint()
+{
+	return *localeconv()->decimal_point;
+}
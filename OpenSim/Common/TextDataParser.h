@@ -0,0 +1,105 @@
+#ifndef _TextDataParser_h_
+#define _TextDataParser_h_
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  TextDataParser.h                          *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2012 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimCommonDLL.h"
+#include "MappedFile.h"
+#include <atomic>
+#include <string>
+
+namespace OpenSim {
+
+//=============================================================================
+//=============================================================================
+/**
+ * A read-only, memory-mapped view of a text data file (.sto, .mot, .trc)
+ * together with a parser for the numeric body of the file.
+ *
+ * The headers are still read by the stream-based code of Storage and
+ * MarkerData; this class only takes over from the byte offset at which the
+ * data rows start. The body is split into ranges of whole lines that are
+ * converted concurrently, each range writing straight into its own rows of
+ * a caller-supplied column-major block.
+ *
+ * Numbers are converted without consulting the C locale, so a process whose
+ * locale uses a decimal comma (as some GUIs set) reads files the same way
+ * as any other. "NaN" and "Inf" are accepted in any case.
+ *
+ * If the body does not have the expected shape (a row with the wrong number
+ * of values, or a token that is not a number) parseRows() returns -1 and the
+ * caller falls back to its stream parser, so malformed files behave exactly
+ * as they did before.
+ */
+class OSIMCOMMON_API TextDataParser
+{
+//=============================================================================
+// DATA
+//=============================================================================
+private:
+	/** The mapped file. */
+	MappedFile _file;
+	/** Description of the last failure of parseRows(). */
+	std::string _errorMessage;
+
+	/** Settings shared by every parser. Atomic since files may be read, and
+	the settings changed, on several threads at once. */
+	static std::atomic<bool> _enabled;
+	static std::atomic<int> _numThreads;
+
+//=============================================================================
+// METHODS
+//=============================================================================
+public:
+	explicit TextDataParser(const std::string &aFileName);
+
+	const char* getData() const { return _file.getData(); }
+	size_t getSize() const { return _file.getSize(); }
+	const std::string& getErrorMessage() const { return _errorMessage; }
+
+	int parseRows(size_t aOffset,int aMaxRows,int aNumColumns,
+		double *rBlock,int aLeadingDimension,bool aTabDelimited=false);
+
+	static bool parseNumber(const char *&rPos,const char *aEnd,double &rValue,
+		char aDecimalPoint);
+	/** Convert one number on a thread that may read the locale itself. */
+	static bool parseNumber(const char *&rPos,const char *aEnd,double &rValue)
+	{	return parseNumber(rPos,aEnd,rValue,getLocaleDecimalPoint()); }
+	static char getLocaleDecimalPoint();
+
+	/** Whether Storage and MarkerData read the data rows of a file through
+	this parser. When disabled they use their original stream parsers. */
+	static void setEnabled(bool aTrueFalse) { _enabled = aTrueFalse; }
+	static bool getEnabled() { return _enabled; }
+	/** Number of threads used to convert a file body. A value less than 1
+	(the default) uses one thread per processor. */
+	static void setNumThreads(int aNumThreads) { _numThreads = aNumThreads; }
+	static int getNumThreads() { return _numThreads; }
+
+//=============================================================================
+};	// END of class TextDataParser
+
+}; //namespace
+//=============================================================================
+//=============================================================================
+
+#endif //__TextDataParser_h__
@@ -0,0 +1,151 @@
+#ifndef _TimeIndex_h_
+#define _TimeIndex_h_
+/* -------------------------------------------------------------------------- *
+ *                          OpenSim:  TimeIndex.h                             *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2012 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+namespace OpenSim {
+
+//=============================================================================
+//=============================================================================
+/**
+ * Searches in a sequence of non-decreasing time stamps, as held by Storage
+ * and MarkerData.
+ *
+ * A query is answered in three steps. First the interval following the
+ * caller's hint (usually the result of the previous query) is tried, which
+ * makes sequential queries O(1). Next the index is computed arithmetically
+ * as if the samples were uniformly spaced and the guess is checked against
+ * its neighbours; data recorded at a fixed rate are therefore found in O(1)
+ * wherever the query falls. Otherwise a binary search finishes the job
+ * within the bracket left by the first two steps, so no query costs more
+ * than O(log n). Each step only proposes a candidate that is checked against
+ * the time stamps, so the result is always that of a linear search.
+ *
+ * The time stamps are read through aTimes[i], so a raw pointer or any small
+ * adapter with an operator[](int) returning the time of element i can be
+ * used.
+ */
+class TimeIndex
+{
+//=============================================================================
+// METHODS
+//=============================================================================
+public:
+	//_________________________________________________________________________
+	/**
+	 * Find the last element whose time is at or before aT.
+	 *
+	 * @param aTimes Time stamps, in non-decreasing order.
+	 * @param aSize Number of time stamps.
+	 * @param aT Time.
+	 * @param aHint Index returned by a previous query, or -1.
+	 * @return Index of the element, or -1 if aT precedes all elements.
+	 */
+	template <class T>
+	static int findLastAtOrBefore(const T &aTimes,int aSize,double aT,
+		int aHint=-1)
+	{
+		return(findBoundary(aTimes,aSize,aT,aHint,true)-1);
+	}
+	//_________________________________________________________________________
+	/**
+	 * Find the first element whose time is at or after aT.
+	 *
+	 * @param aTimes Time stamps, in non-decreasing order.
+	 * @param aSize Number of time stamps.
+	 * @param aT Time.
+	 * @param aHint Index returned by a previous query, or -1.
+	 * @return Index of the element, or aSize if aT follows all elements.
+	 */
+	template <class T>
+	static int findFirstAtOrAfter(const T &aTimes,int aSize,double aT,
+		int aHint=-1)
+	{
+		return(findBoundary(aTimes,aSize,aT,aHint-1,false));
+	}
+
+private:
+	static bool isAfter(double aTime,double aT,bool aInclusive)
+	{
+		return(aInclusive ? (aT<aTime) : (aT<=aTime));
+	}
+	//_________________________________________________________________________
+	/**
+	 * Find the first element that lies after aT: the first element whose
+	 * time exceeds aT if aInclusive, or the first whose time is at least aT
+	 * otherwise. aHint, if valid, is an index expected to lie just before
+	 * the result.
+	 */
+	template <class T>
+	static int findBoundary(const T &aTimes,int aSize,double aT,int aHint,
+		bool aInclusive)
+	{
+		// OUTSIDE THE RANGE (also catches a NaN aT)
+		if(aSize<=0) return(0);
+		if(isAfter(aTimes[0],aT,aInclusive)) return(0);
+		if(!isAfter(aTimes[aSize-1],aT,aInclusive)) return(aSize);
+
+		// From here on the search is bracketed: element lo is not after aT
+		// and element hi is.
+		int lo=0, hi=aSize-1;
+
+		// HINT: THE SAME OR THE NEXT INTERVAL
+		if(aHint>=0 && aHint<hi && !isAfter(aTimes[aHint],aT,aInclusive)) {
+			if(isAfter(aTimes[aHint+1],aT,aInclusive)) return(aHint+1);
+			lo = aHint+1;
+			if(lo+1<hi && isAfter(aTimes[lo+1],aT,aInclusive)) return(lo+1);
+		}
+
+		// UNIFORM SAMPLING GUESS
+		double t0 = aTimes[0];
+		double span = aTimes[aSize-1] - t0;
+		if(span>0.0) {
+			double guess = (aT-t0)/span*(aSize-1);
+			int k = (guess<lo) ? lo : ((guess>hi-1) ? hi-1 : (int)guess);
+			if(!isAfter(aTimes[k],aT,aInclusive)) {
+				if(isAfter(aTimes[k+1],aT,aInclusive)) return(k+1);
+				lo = k+1;
+				// Round-off can put the guess one interval short.
+				if(lo+1<hi && isAfter(aTimes[lo+1],aT,aInclusive)) return(lo+1);
+			} else {
+				hi = k;
+				if(k>lo && !isAfter(aTimes[k-1],aT,aInclusive)) return(k);
+			}
+		}
+
+		// BINARY SEARCH
+		while(hi-lo>1) {
+			int mid = lo + (hi-lo)/2;
+			if(isAfter(aTimes[mid],aT,aInclusive)) hi = mid;
+			else lo = mid;
+		}
+		return(hi);
+	}
+
+//=============================================================================
+};	// END of class TimeIndex
+
+}; //namespace
+//=============================================================================
+//=============================================================================
+
+#endif // _TimeIndex_h_
@@ -160,12 +160,11 @@ void PrescribedController::connectToModel(Model& model)
 // compute the control value for an actuator
 void PrescribedController::computeControls(const SimTK::State& s, SimTK::Vector& controls) const
 {
-	SimTK::Vector actControls(1, 0.0);
-	SimTK::Vector time(1, s.getTime());
+	double time = s.getTime();
 
 	for(int i=0; i<getActuatorSet().getSize(); i++){
-		actControls[0] = get_ControlFunctions()[i].calcValue(time);
-		getActuatorSet()[i].addInControls(actControls, controls);
+		getActuatorSet()[i].addInControls(
+			get_ControlFunctions()[i].calcValue(time), controls);
 	}  
 }
 
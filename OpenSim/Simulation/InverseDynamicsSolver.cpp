@@ -24,12 +24,85 @@
 #include "InverseDynamicsSolver.h"
 #include "Model/Model.h"
 #include <OpenSim/Common/FunctionSet.h>
+#include "SimTKcommon/internal/ParallelExecutor.h"
+#include <vector>
 
 using namespace std;
 using namespace SimTK;
 
 namespace OpenSim {
 
+namespace {
+
+// Frames per thread below which a trajectory is solved in sequence.
+const int MIN_FRAMES_PER_CHUNK = 10;
+
+/**
+ * Set the time, coordinates, speeds and accelerations of s for one frame from
+ * batch-evaluated coordinate functions: nq values, then nq first and nq
+ * second derivatives.
+ */
+void setFrame(State &s, double time, const double *values, int nq)
+{
+	s.updTime() = time;
+	Vector &q = s.updQ();
+	Vector &u = s.updU();
+	Vector &udot = s.updUDot();
+	for(int i=0; i<nq; i++){
+		q[i] = values[i];
+		u[i] = values[nq+i];
+		udot[i] = values[2*nq+i];
+	}
+}
+
+/**
+ * Solves a contiguous range of frames per chunk, each chunk with its own copy
+ * of the State, writing into the preallocated trajectory.
+ */
+class SolveFramesTask : public SimTK::ParallelExecutor::Task {
+public:
+	SolveFramesTask(InverseDynamicsSolver &aSolver, const State &aState,
+		const std::vector<double> &aFrames, int aNumCoordinates,
+		const Array_<double> &aTimes, Array_<Vector> &rGenForceTrajectory,
+		int aNumChunks) :
+		_solver(aSolver), _state(aState), _frames(aFrames),
+		_nq(aNumCoordinates), _times(aTimes),
+		_genForceTrajectory(rGenForceTrajectory), _errors(aNumChunks) {}
+
+	void execute(int aChunk) {
+		int nt = _times.size();
+		int nc = _errors.size();
+		try {
+			State s(_state);
+			for(int i=(aChunk*nt)/nc; i<((aChunk+1)*nt)/nc; i++){
+				setFrame(s, _times[i], &_frames[3*i*_nq], _nq);
+				_genForceTrajectory[i] = _solver.solve(s, s.getUDot());
+			}
+		}
+		catch(const std::exception &ex) {
+			_errors[aChunk] = ex.what();
+		}
+	}
+
+	/** The first error in any chunk, or an empty string. */
+	std::string getError() const {
+		for(unsigned int i=0; i<_errors.size(); i++)
+			if(!_errors[i].empty()) return _errors[i];
+		return "";
+	}
+
+private:
+	InverseDynamicsSolver &_solver;
+	const State &_state;
+	const std::vector<double> &_frames;
+	int _nq;
+	const Array_<double> &_times;
+	Array_<Vector> &_genForceTrajectory;
+	Array_<std::string> _errors;
+};
+
+} // namespace
+
 //______________________________________________________________________________
 /**
  * An implementation of the InverseDynamicsSolver 
@@ -39,6 +112,7 @@ namespace OpenSim {
 InverseDynamicsSolver::InverseDynamicsSolver(const Model &model) : Solver(model)
 {
 	setAuthors("Ajay Seth");
+	_numThreads = 1;
 }
 
 /** Solve the inverse dynamics system of equations for generalized coordinate forces, Tau. 
@@ -124,21 +198,58 @@ Vector InverseDynamicsSolver::solve(SimTK::State &s, const FunctionSet &Qs, doub
 }
 
 
-/** Same as above but for a given time series */
+/** Same as above but for a given time series. The coordinate functions are
+    evaluated for all times in one pass before the frames are solved. */
 void InverseDynamicsSolver::solve(SimTK::State &s, const FunctionSet &Qs, const Array_<double> &times, Array_<Vector> &genForceTrajectory)
 {
 	int nq = getModel().getNumCoordinates();
 	int nt = times.size();
 
+	if(Qs.getSize() != nq){
+		throw Exception("InverseDynamicsSolver::solve invalid number of q functions.");
+	}
+
+	if( nq != getModel().getNumSpeeds()){
+		throw Exception("InverseDynamicsSolver::solve using FunctionSet, nq != nu not supported.");
+	}
+
 	//Preallocate if not done already
 	genForceTrajectory.resize(nt, Vector(nq));
+	if(nt == 0) return;
+
+	// q, u and udot of every frame
+	const int derivOrders[] = {0, 1, 2};
+	std::vector<double> frames(3*nt*nq);
+	Qs.evaluate(nt, &times[0], 3, derivOrders, &frames[0]);
 	
 	AnalysisSet& analysisSet = const_cast<AnalysisSet&>(getModel().getAnalysisSet());
-	//fill in results for each time
-	for(int i=0; i<nt; i++){ 
-		genForceTrajectory[i] = solve(s, Qs, times[i]);
+
+	int numThreads = _numThreads>0 ? _numThreads :
+		SimTK::ParallelExecutor::getNumProcessors();
+	int numChunks = min(numThreads, nt/MIN_FRAMES_PER_CHUNK);
+	if(numChunks <= 1){
+		//fill in results for each time
+		for(int i=0; i<nt; i++){ 
+			setFrame(s, times[i], &frames[3*i*nq], nq);
+			genForceTrajectory[i] = solve(s, s.getUDot());
+			analysisSet.step(s, i);
+		}
+		return;
+	}
+
+	SolveFramesTask task(*this, s, frames, nq, times, genForceTrajectory, numChunks);
+	SimTK::ParallelExecutor executor(numChunks);
+	executor.execute(task, numChunks);
+	std::string error = task.getError();
+	if(!error.empty())
+		throw Exception("InverseDynamicsSolver::solve failed: "+error, __FILE__, __LINE__);
+
+	// Analyses see the frames in order; only the state needs to be set again
+	for(int i=(analysisSet.getSize()>0 ? 0 : nt-1); i<nt; i++){
+		setFrame(s, times[i], &frames[3*i*nq], nq);
+		getModel().getMultibodySystem().realize(s, SimTK::Stage::Dynamics);
 		analysisSet.step(s, i);
 	}
 }
 
-} // end of namespace OpenSim
\ No newline at end of file
+} // end of namespace OpenSim
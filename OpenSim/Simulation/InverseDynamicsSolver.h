@@ -58,6 +58,9 @@ OpenSim_DECLARE_CONCRETE_OBJECT(InverseDynamicsSolver, Solver);
 //=============================================================================
 protected:
 
+	// Number of threads over which frames of a trajectory are solved
+	int _numThreads;
+
 //=============================================================================
 // METHODS
 //=============================================================================
@@ -67,6 +70,12 @@ public:
 	//--------------------------------------------------------------------------
 	/** Construct an InverseDynamics solver applied to the provided model */
 	InverseDynamicsSolver(const Model& model);
+
+	/** Set the number of threads over which the frames of a trajectory are
+	    solved. The default, 1, solves them in sequence; 0 or less uses one
+		thread per processor. */
+	void setNumThreads(int numThreads) {_numThreads = numThreads; }
+	int getNumThreads() const {return _numThreads; }
 	
 	/** Solve the inverse dynamics system of equations for generalized 
 	    coordinate forces, Tau. Applied loads are computed by the model  
@@ -93,7 +102,11 @@ public:
 	virtual SimTK::Vector solve(SimTK::State& s, const FunctionSet& Qs, double time);
 #ifndef SWIG
     /** Same as above but for a given time series populate an Array (trajectory) of
-	    generalized-coordinate forces (Vector) */
+	    generalized-coordinate forces (Vector). Frames are independent, so with
+		more than one thread (see setNumThreads()) each thread solves a
+		contiguous range of them with its own copy of the State. Analyses of
+		the model are then stepped through the frames in order, and s is left
+		at the last frame, as when solving in sequence. */
 	virtual void solve(SimTK::State& s, const FunctionSet& Qs, 
 		         const SimTK::Array_<double>&  times,
 				 SimTK::Array_<SimTK::Vector>& genForceTrajectory);
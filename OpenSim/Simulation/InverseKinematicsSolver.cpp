@@ -48,6 +48,12 @@ InverseKinematicsSolver::InverseKinematicsSolver(const Model &model, MarkersRefe
 	// Base AssemblySolver takes care of creating the underlying _assembler and setting up CoordinateReferences;
 	_markerAssemblyCondition = NULL;
 
+	_useLeastSquaresTracking = false;
+	_canTrackByLeastSquares = false;
+	_trackedByLeastSquares = false;
+	_numLeastSquaresIterations = 0;
+	_numPreviousFrames = 0;
+
 	// Do some consistency checking for markers
 	const MarkerSet &modelMarkerSet = getModel().getMarkerSet();
 
@@ -95,6 +101,8 @@ void InverseKinematicsSolver::updateMarkerWeight(int markerIndex, double value)
 	if(markerIndex >=0 && markerIndex < _markersReference.updMarkerWeightSet().getSize()){
 		_markersReference.updMarkerWeightSet()[markerIndex].setWeight(value);
 		_markerAssemblyCondition->changeMarkerWeight(SimTK::Markers::MarkerIx(markerIndex), value);
+		if(markerIndex < (int)_markerWeights.size())
+			_markerWeights[markerIndex] = value;
 	}
 	else
 		throw Exception("InverseKinematicsSolver::updateMarkerWeight: invalid markerIndex.");
@@ -108,6 +116,8 @@ void InverseKinematicsSolver::updateMarkerWeights(const SimTK::Array_<double> &w
 		for(unsigned int i=0; i<weights.size(); i++){
 			_markersReference.updMarkerWeightSet()[i].setWeight(weights[i]);
 			_markerAssemblyCondition->changeMarkerWeight(SimTK::Markers::MarkerIx(i), weights[i]);
+			if(i < _markerWeights.size())
+				_markerWeights[i] = weights[i];
 		}
 	}
 	else
@@ -126,7 +136,7 @@ SimTK::Vec3 InverseKinematicsSolver::computeCurrentMarkerLocation(const std::str
 SimTK::Vec3 InverseKinematicsSolver::computeCurrentMarkerLocation(int markerIndex)
 {
 	if(markerIndex >=0 && markerIndex < _markerAssemblyCondition->getNumMarkers()){
-		return _markerAssemblyCondition->findCurrentMarkerLocation(SimTK::Markers::MarkerIx(markerIndex));
+		return findCurrentMarkerLocation(markerIndex);
 	}
 	else
 		throw Exception("InverseKinematicsSolver::computeCurrentMarkerLocation: invalid markerIndex.");
@@ -137,7 +147,7 @@ void InverseKinematicsSolver::computeCurrentMarkerLocations(SimTK::Array_<SimTK:
 {
 	markerLocations.resize(_markerAssemblyCondition->getNumMarkers());
 	for(unsigned int i=0; i<markerLocations.size(); i++)
-		markerLocations[i] = _markerAssemblyCondition->findCurrentMarkerLocation(SimTK::Markers::MarkerIx(i));
+		markerLocations[i] = findCurrentMarkerLocation(i);
 }
 
 
@@ -153,7 +163,7 @@ double InverseKinematicsSolver::computeCurrentMarkerError(const std::string &mar
 double InverseKinematicsSolver::computeCurrentMarkerError(int markerIndex)
 {
 	if(markerIndex >=0 && markerIndex < _markerAssemblyCondition->getNumMarkers()){
-		return _markerAssemblyCondition->findCurrentMarkerError(SimTK::Markers::MarkerIx(markerIndex));
+		return sqrt(findCurrentMarkerErrorSquared(markerIndex));
 	}
 	else
 		throw Exception("InverseKinematicsSolver::computeCurrentMarkerError: invalid markerIndex.");
@@ -164,7 +174,7 @@ void InverseKinematicsSolver::computeCurrentMarkerErrors(SimTK::Array_<double> &
 {
 	markerErrors.resize(_markerAssemblyCondition->getNumMarkers());
 	for(unsigned int i=0; i<markerErrors.size(); i++)
-		markerErrors[i] = _markerAssemblyCondition->findCurrentMarkerError(SimTK::Markers::MarkerIx(i));
+		markerErrors[i] = sqrt(findCurrentMarkerErrorSquared(i));
 }
 
 
@@ -180,7 +190,7 @@ double InverseKinematicsSolver::computeCurrentSquaredMarkerError(const std::stri
 double InverseKinematicsSolver::computeCurrentSquaredMarkerError(int markerIndex)
 {
 	if(markerIndex >=0 && markerIndex < _markerAssemblyCondition->getNumMarkers()){
-		return _markerAssemblyCondition->findCurrentMarkerErrorSquared(SimTK::Markers::MarkerIx(markerIndex));
+		return findCurrentMarkerErrorSquared(markerIndex);
 	}
 	else
 		throw Exception("InverseKinematicsSolver::computeCurrentMarkerSquaredError: invalid markerIndex.");
@@ -191,7 +201,7 @@ void InverseKinematicsSolver::computeCurrentSquaredMarkerErrors(SimTK::Array_<do
 {
 	markerErrors.resize(_markerAssemblyCondition->getNumMarkers());
 	for(unsigned int i=0; i<markerErrors.size(); i++)
-		markerErrors[i] = _markerAssemblyCondition->findCurrentMarkerErrorSquared(SimTK::Markers::MarkerIx(i));
+		markerErrors[i] = findCurrentMarkerErrorSquared(i);
 }
 
 /** Marker errors are reported in order different from tasks file or model, find name corresponding to passed in index  */
@@ -205,9 +215,62 @@ std::string InverseKinematicsSolver::getMarkerNameForIndex(int markerIndex) cons
 	of the base assembly solver, that is going to do the assembly.  */
 void InverseKinematicsSolver::setupGoals(SimTK::State &s)
 {
+	const SimbodyMatterSubsystem &matter = getModel().getMatterSubsystem();
+	const CoordinateSet &modelCoordSet = getModel().getCoordinateSet();
+
+	// Least-squares tracking holds locked coordinates fixed itself, so it
+	// applies if the locks are the only enabled constraints. Find them before
+	// the base class unlocks them in s.
+	Array_<bool> isFreeU(s.getNU(), true);
+	int numLocked = 0;
+	_clampedQs.clear();
+	_clampedRanges.clear();
+	for(int i=0; i<modelCoordSet.getSize(); ++i){
+		const Coordinate& coord = modelCoordSet[i];
+		const MobilizedBody &mobod = matter.getMobilizedBody(coord.getBodyIndex());
+		if(coord.getLocked(s)){
+			isFreeU[mobod.getFirstUIndex(s) + coord.getMobilizerQIndex()] = false;
+			numLocked++;
+		}
+		if(coord.getClamped(s)){
+			_clampedQs.push_back(QIndex(mobod.getFirstQIndex(s) + coord.getMobilizerQIndex()));
+			_clampedRanges.push_back(Vec2(coord.getRangeMin(), coord.getRangeMax()));
+		}
+	}
+	int numEnabled = 0;
+	for(ConstraintIndex cx(0); cx < matter.getNumConstraints(); ++cx)
+		if(!matter.getConstraint(cx).isDisabled(s))
+			numEnabled++;
+	_canTrackByLeastSquares = (numEnabled == numLocked) && (s.getNQ() == s.getNU());
+	_freeUs.clear();
+	for(UIndex ux(0); ux < s.getNU(); ++ux)
+		if(isFreeU[ux])
+			_freeUs.push_back(ux);
+
 	// Setup coordinates performed by the base class
 	AssemblySolver::setupGoals(s);
 
+	// Coordinate goals remaining after the base class dropped locked ones.
+	// A goal with an infinite weight is a hard constraint, which only the
+	// Assembler enforces.
+	_goalQs.clear();
+	for(unsigned int i=0; i<_coordinateReferencesp->size(); ++i){
+		const Coordinate &coord = modelCoordSet.get((*_coordinateReferencesp)[i].getName());
+		_goalQs.push_back(QIndex(matter.getMobilizedBody(coord.getBodyIndex()).getFirstQIndex(s)
+			+ coord.getMobilizerQIndex()));
+		if(isInf((*_coordinateReferencesp)[i].getWeight(s)))
+			_canTrackByLeastSquares = false;
+	}
+	_goalValues.assign(_goalQs.size(), 0.0);
+	_goalWeights.assign(_goalQs.size(), 0.0);
+	_markerBodies.clear();
+	_markerStations.clear();
+	_markerWeights.clear();
+	_markerObservations.clear();
+	_trackingState = s;
+	_trackedByLeastSquares = false;
+	_numPreviousFrames = 0;
+
 	_markerAssemblyCondition = new SimTK::Markers();
 
 	// Setup markers goals
@@ -236,6 +299,10 @@ void InverseKinematicsSolver::setupGoals(SimTK::State &s)
 				_markerAssemblyCondition->
 					addMarker(marker.getName(), mobod, marker.getOffset(),
 					markerWeights[i]);
+			_markerBodies.push_back(mobod.getMobilizedBodyIndex());
+			_markerStations.push_back(marker.getOffset());
+			_markerWeights.push_back(markerWeights[i]);
+			_markerObservations.push_back(i);
 
 			//cout << "IKSolver Marker: " << markerNames[i] << " " << marker.getName() << "  weight: " << markerWeights[i] << endl;
 		}
@@ -262,4 +329,250 @@ void InverseKinematicsSolver::updateGoals(const SimTK::State &s)
 	_markerAssemblyCondition->moveAllObservations(_markerValues);
 }
 
+//=============================================================================
+// LEAST-SQUARES TRACKING
+//=============================================================================
+//______________________________________________________________________________
+/**
+ * Track with the dedicated least-squares solver when it was asked for and the
+ * model allows it, otherwise with the Assembler.
+ */
+void InverseKinematicsSolver::track(SimTK::State &s)
+{
+	_trackedByLeastSquares = false;
+	if(!(_useLeastSquaresTracking && _canTrackByLeastSquares)){
+		AssemblySolver::track(s);
+		return;
+	}
+	if(!(_assembler && _assembler->isInitialized()))
+		throw Exception(
+			"InverseKinematicsSolver::track() failed: assemble() must be called first.");
+
+	try{
+		trackByLeastSquares(s);
+	}
+	catch (const std::exception& ex)
+	{
+		std::cout << "InverseKinematicsSolver::track() attempt Failed: " << ex.what() << std::endl;
+		throw Exception("InverseKinematicsSolver::track() attempt failed.");
+	}
+}
+
+//______________________________________________________________________________
+/**
+ * The objective is the Assembler's: the weighted mean of the squared errors
+ * of the observed markers plus the weighted squared errors of the coordinate
+ * goals. Each Levenberg-Marquardt step solves
+ *     (J^T J + lambda*diag(J^T J)) du = -J^T r
+ * for the free mobilities, with J the analytic Jacobian of the residuals r,
+ * and moves q by N(q) du. Damping is reduced after a step that lowers the
+ * objective and raised until one does. The iterations stop when no mobility
+ * changes by more than the accuracy.
+ */
+void InverseKinematicsSolver::trackByLeastSquares(SimTK::State &s)
+{
+	const int MaxIterations = 50;
+	const double MaxDamping = 1e10;
+
+	const MultibodySystem &system = getModel().getMultibodySystem();
+	const SimbodyMatterSubsystem &matter = system.getMatterSubsystem();
+	State &ts = _trackingState;
+	const double time = s.getTime();
+
+	// Goals for this frame
+	_markersReference.getValues(s, _markerValues);
+	for(unsigned int i=0; i<_goalQs.size(); ++i){
+		_goalValues[i] = (*_coordinateReferencesp)[i].getValue(s);
+		_goalWeights[i] = (*_coordinateReferencesp)[i].getWeight(s);
+	}
+
+	// Start from the pose in s or, if s holds the last solution, from the
+	// pose extrapolated from the last two frames if that is closer.
+	ts.updTime() = time;
+	ts.updQ() = s.getQ();
+	Vector residuals;
+	double cost = calcLeastSquaresResiduals(ts, residuals);
+	if(_numPreviousFrames > 0 && (s.getQ() - _previousQs[_numPreviousFrames-1]).normRMS() != 0)
+		_numPreviousFrames = 0;
+	if(_numPreviousFrames == 2 && time > _previousTimes[1] && _previousTimes[1] > _previousTimes[0]){
+		double ratio = (time - _previousTimes[1])/(_previousTimes[1] - _previousTimes[0]);
+		Vector predicted = _previousQs[1] + ratio*(_previousQs[1] - _previousQs[0]);
+		clampLeastSquaresQ(predicted);
+		ts.updQ() = predicted;
+		Vector predictedResiduals;
+		double predictedCost = calcLeastSquaresResiduals(ts, predictedResiduals);
+		if(predictedCost < cost){
+			cost = predictedCost;
+			residuals = predictedResiduals;
+		}
+		else{
+			ts.updQ() = s.getQ();
+			system.realize(ts, Stage::Position);
+		}
+	}
+
+	int nfree = _freeUs.size();
+	double damping = 1e-3;
+	Matrix jacobian;
+	Vector du(nfree), fullDu(ts.getNU(), 0.0), dq(ts.getNQ());
+	Vector trialResiduals;
+	_numLeastSquaresIterations = 0;
+	while(_numLeastSquaresIterations < MaxIterations && nfree > 0){
+		++_numLeastSquaresIterations;
+		calcLeastSquaresJacobian(ts, jacobian);
+		Matrix normal = ~jacobian*jacobian;
+		Vector gradient = ~jacobian*residuals;
+		double maxDiagonal = 0;
+		for(int i=0; i<nfree; ++i)
+			maxDiagonal = std::max(maxDiagonal, normal(i,i));
+		// A free mobility that no goal depends on still gets some damping
+		double minDiagonal = 1e-12*(maxDiagonal > 0 ? maxDiagonal : 1.0);
+
+		const Vector q0 = ts.getQ();
+		bool improved = false;
+		while(!improved && damping < MaxDamping){
+			Matrix damped = normal;
+			for(int i=0; i<nfree; ++i)
+				damped(i,i) += damping*std::max(normal(i,i), minDiagonal);
+			FactorLU lu(damped);
+			lu.solve(Vector(-gradient), du);
+
+			for(int i=0; i<nfree; ++i)
+				fullDu[_freeUs[i]] = du[i];
+			matter.multiplyByN(ts, false, fullDu, dq);
+			Vector trialQ = q0 + dq;
+			clampLeastSquaresQ(trialQ);
+			ts.updQ() = trialQ;
+			double trialCost = calcLeastSquaresResiduals(ts, trialResiduals);
+			if(trialCost <= cost){
+				cost = trialCost;
+				residuals = trialResiduals;
+				damping = std::max(0.1*damping, 1e-12);
+				improved = true;
+			}
+			else{
+				ts.updQ() = q0;
+				system.realize(ts, Stage::Position);
+				damping *= 10;
+			}
+		}
+		if(!improved || max(abs(du)) <= _accuracy)
+			break;
+	}
+
+	s.updQ() = ts.getQ();
+	_trackedByLeastSquares = true;
+
+	if(_numPreviousFrames == 2){
+		_previousTimes[0] = _previousTimes[1];
+		_previousQs[0] = _previousQs[1];
+		_numPreviousFrames = 1;
+	}
+	_previousTimes[_numPreviousFrames] = time;
+	_previousQs[_numPreviousFrames] = ts.getQ();
+	_numPreviousFrames++;
+}
+
+//______________________________________________________________________________
+/**
+ * Residuals are ordered: three per marker, then one per coordinate goal.
+ * Markers with no observation (NaN) have zero residuals.
+ */
+double InverseKinematicsSolver::calcLeastSquaresResiduals(SimTK::State &s, SimTK::Vector &residuals) const
+{
+	const SimbodyMatterSubsystem &matter = getModel().getMatterSubsystem();
+	getModel().getMultibodySystem().realize(s, Stage::Position);
+
+	int nm = _markerBodies.size();
+	residuals.resize(3*nm + _goalQs.size());
+	double totalWeight = 0;
+	for(int i=0; i<nm; ++i)
+		if(_markerValues[_markerObservations[i]].isFinite())
+			totalWeight += _markerWeights[i];
+
+	for(int i=0; i<nm; ++i){
+		const Vec3 &observed = _markerValues[_markerObservations[i]];
+		Vec3 error(0);
+		if(totalWeight > 0 && observed.isFinite()){
+			Vec3 location = matter.getMobilizedBody(_markerBodies[i]).
+				findStationLocationInGround(s, _markerStations[i]);
+			error = sqrt(_markerWeights[i]/totalWeight)*(location - observed);
+		}
+		for(int k=0; k<3; ++k)
+			residuals[3*i+k] = error[k];
+	}
+	const Vector &q = s.getQ();
+	for(unsigned int j=0; j<_goalQs.size(); ++j)
+		residuals[3*nm+j] = sqrt(_goalWeights[j])*(q[_goalQs[j]] - _goalValues[j]);
+
+	return residuals.normSqr();
+}
+
+//______________________________________________________________________________
+/**
+ * Marker rows are the markers' station Jacobians; coordinate goal rows are the
+ * rows of N, since qdot = N u. Only the columns of free mobilities are kept.
+ */
+void InverseKinematicsSolver::calcLeastSquaresJacobian(const SimTK::State &s, SimTK::Matrix &jacobian) const
+{
+	const SimbodyMatterSubsystem &matter = getModel().getMatterSubsystem();
+	int nm = _markerBodies.size();
+	int nfree = _freeUs.size();
+	jacobian.resize(3*nm + _goalQs.size(), nfree);
+
+	double totalWeight = 0;
+	for(int i=0; i<nm; ++i)
+		if(_markerValues[_markerObservations[i]].isFinite())
+			totalWeight += _markerWeights[i];
+
+	Matrix stationJacobian;
+	matter.calcStationJacobian(s, _markerBodies, _markerStations, stationJacobian);
+	for(int i=0; i<nm; ++i){
+		bool observed = totalWeight > 0 && _markerValues[_markerObservations[i]].isFinite();
+		double scale = observed ? sqrt(_markerWeights[i]/totalWeight) : 0.0;
+		for(int k=0; k<3; ++k)
+			for(int c=0; c<nfree; ++c)
+				jacobian(3*i+k, c) = scale*stationJacobian(3*i+k, _freeUs[c]);
+	}
+
+	Vector unitQ(s.getNQ(), 0.0), rowOfN(s.getNU());
+	for(unsigned int j=0; j<_goalQs.size(); ++j){
+		unitQ[_goalQs[j]] = 1;
+		matter.multiplyByN(s, true, unitQ, rowOfN);
+		unitQ[_goalQs[j]] = 0;
+		double scale = sqrt(_goalWeights[j]);
+		for(int c=0; c<nfree; ++c)
+			jacobian(3*nm+j, c) = scale*rowOfN[_freeUs[c]];
+	}
+}
+
+void InverseKinematicsSolver::clampLeastSquaresQ(SimTK::Vector &q) const
+{
+	for(unsigned int i=0; i<_clampedQs.size(); ++i)
+		q[_clampedQs[i]] = clamp(_clampedRanges[i][0], q[_clampedQs[i]], _clampedRanges[i][1]);
+}
+
+//______________________________________________________________________________
+/**
+ * Marker locations and errors of the last solution, which is held by the
+ * Assembler unless the last frame was tracked by least squares.
+ */
+SimTK::Vec3 InverseKinematicsSolver::findCurrentMarkerLocation(int markerIndex) const
+{
+	if(!_trackedByLeastSquares)
+		return _markerAssemblyCondition->findCurrentMarkerLocation(SimTK::Markers::MarkerIx(markerIndex));
+	return getModel().getMatterSubsystem().getMobilizedBody(_markerBodies[markerIndex]).
+		findStationLocationInGround(_trackingState, _markerStations[markerIndex]);
+}
+
+double InverseKinematicsSolver::findCurrentMarkerErrorSquared(int markerIndex) const
+{
+	if(!_trackedByLeastSquares)
+		return _markerAssemblyCondition->findCurrentMarkerErrorSquared(SimTK::Markers::MarkerIx(markerIndex));
+	const Vec3 &observed = _markerValues[_markerObservations[markerIndex]];
+	if(!observed.isFinite())
+		return 0;
+	return (findCurrentMarkerLocation(markerIndex) - observed).normSqr();
+}
+
 } // end of namespace OpenSim
\ No newline at end of file
@@ -97,6 +97,28 @@ public:
 		to track a desired trajectory of coordinate values. */
 	//virtual void track(SimTK::State &s);
 
+	/** Obtain the model configuration for the next frame. Unless least-squares
+	    tracking is in use (see setUseLeastSquaresTracking()), this is the
+		Assembler's track() of the base AssemblySolver. */
+	virtual void track(SimTK::State &s);
+
+	/** Track frames with a dedicated damped Gauss-Newton (Levenberg-Marquardt)
+	    solver rather than the general SimTK::Assembler. It minimizes the same
+		objective as the Assembler using the analytic station Jacobians of the
+		markers, starts each frame from the pose extrapolated from the previous
+		two frames, and stops once the step is within the accuracy. It applies
+		only to models whose only enabled constraints lock coordinates and that
+		have no quaternions, and to coordinate goals with finite weights;
+		otherwise track() keeps using the Assembler. 
+		assemble() always uses the Assembler. Default is false. */
+	void setUseLeastSquaresTracking(bool useLeastSquares) {_useLeastSquaresTracking = useLeastSquares; }
+	bool getUseLeastSquaresTracking() const {return _useLeastSquaresTracking; }
+	/** Whether the last call to track() was solved by least-squares tracking. */
+	bool getTrackedByLeastSquares() const {return _trackedByLeastSquares; }
+	/** Number of Gauss-Newton iterations taken by the last call to track()
+	    solved by least-squares tracking. */
+	int getNumLeastSquaresIterations() const {return _numLeastSquaresIterations; }
+
 	/** Change the weighting of a marker to take affect when assemble or track is called next. 
 		Update a marker's weight by name. */
 	void updateMarkerWeight(const std::string &markerName, double value);
@@ -141,9 +163,46 @@ protected:
 	virtual void updateGoals(const SimTK::State &s);
 
 private:
+	/** Solve the frame at the time of s by damped Gauss-Newton iterations. */
+	void trackByLeastSquares(SimTK::State &s);
+	/** Weighted residuals of the goals at the configuration of the state,
+	    which is realized to Position. Returns the objective, their sum of
+		squares. */
+	double calcLeastSquaresResiduals(SimTK::State &s, SimTK::Vector &residuals) const;
+	/** Jacobian of the weighted residuals with respect to the free mobilities. */
+	void calcLeastSquaresJacobian(const SimTK::State &s, SimTK::Matrix &jacobian) const;
+	/** Keep the clamped coordinates in q within their ranges. */
+	void clampLeastSquaresQ(SimTK::Vector &q) const;
+
+	SimTK::Vec3 findCurrentMarkerLocation(int markerIndex) const;
+	double findCurrentMarkerErrorSquared(int markerIndex) const;
+
 	// Non-accessible cache of the marker values to be matched at a given state
 	SimTK::Array_<SimTK::Vec3> _markerValues;
 
+	// Least-squares tracking. The markers are in the order they were added to
+	// the Markers condition, with the index of their observation; coordinate
+	// goals are in the order of the coordinate references.
+	bool _useLeastSquaresTracking;
+	bool _canTrackByLeastSquares;
+	bool _trackedByLeastSquares;
+	int _numLeastSquaresIterations;
+	SimTK::State _trackingState;
+	SimTK::Array_<SimTK::MobilizedBodyIndex> _markerBodies;
+	SimTK::Array_<SimTK::Vec3> _markerStations;
+	SimTK::Array_<double> _markerWeights;
+	SimTK::Array_<int> _markerObservations;
+	SimTK::Array_<SimTK::QIndex> _goalQs;
+	SimTK::Array_<double> _goalValues;
+	SimTK::Array_<double> _goalWeights;
+	SimTK::Array_<SimTK::UIndex> _freeUs;
+	SimTK::Array_<SimTK::QIndex> _clampedQs;
+	SimTK::Array_<SimTK::Vec2> _clampedRanges;
+	// The last two solutions, from which the next frame is extrapolated
+	int _numPreviousFrames;
+	double _previousTimes[2];
+	SimTK::Vector _previousQs[2];
+
 
 //=============================================================================
 };	// END of class InverseKinematicsSolver
@@ -170,8 +170,8 @@ void Actuator::addToSystem(SimTK::MultibodySystem& system) const
 	addModelingOption("override_force", 1);
 
 	// Cache the computed force and speed of the scalar valued actuator
-	addCacheVariable<double>("force", 0.0, Stage::Velocity);
-	addCacheVariable<double>("speed", 0.0, Stage::Velocity);
+	_forceCV = addCacheVariable<double>("force", 0.0, Stage::Velocity);
+	_speedCV = addCacheVariable<double>("speed", 0.0, Stage::Velocity);
 
 	// Discrete state variable is the override force value if in override mode
 	addDiscreteVariable("override_force", Stage::Time);
@@ -182,6 +182,14 @@ double Actuator::getControl(const SimTK::State& s ) const
 	return getControls(s)[0];
 }
 
+void Actuator::addInControls(double aControl, Vector& modelControls) const
+{
+	SimTK_ASSERT(modelControls.size() == _model->getNumControls(), 
+	"Actuator::addInControls, output modelControls size does not match model.getNumControls().\n");
+
+	modelControls[_controlIndex] += aControl;
+}
+
 //_____________________________________________________________________________
 /**
  * getStress needs to be overridden by derived classes to be usable
@@ -202,22 +210,22 @@ double Actuator::getOptimalForce() const
 double Actuator::getForce(const State &s) const
 {
     if (isDisabled(s)) return 0.0;
-    return getCacheVariable<double>(s, "force");
+    return getCacheVariable(s, _forceCV);
 }
 
 void Actuator::setForce(const State& s, double aForce) const
 {
-    setCacheVariable<double>(s, "force", aForce);
+    setCacheVariable(s, _forceCV, aForce);
 }
 
 double Actuator::getSpeed(const State& s) const
 {
-    return getCacheVariable<double>(s, "speed");
+    return getCacheVariable(s, _speedCV);
 }
 
 void Actuator::setSpeed(const State &s, double speed) const
 {
-    setCacheVariable<double>(s, "speed", speed);
+    setCacheVariable(s, _speedCV, speed);
 }
 
 
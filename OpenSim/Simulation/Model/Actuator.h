@@ -162,6 +162,12 @@ public:
 	/** Convenience method to get control given scalar (double) valued control */
 	virtual double getControl(const SimTK::State& s ) const;
 
+	using Actuator_::addInControls;
+	/** Add a scalar control to the value already occupying this actuator's
+	slot in the system-wide model controls, without the temporary Vector
+	that the Vector form needs. */
+	void addInControls(double aControl, SimTK::Vector& modelControls) const;
+
 	//Model building
 	virtual int numControls() const {return 1;};
 
@@ -247,6 +253,10 @@ protected:
 private:
 	void constructProperties();
 
+	// handles to the force and speed cache variables, set in addToSystem()
+	mutable CacheVariableHandle<double> _forceCV;
+	mutable CacheVariableHandle<double> _speedCV;
+
 //=============================================================================
 };	// END of class Actuator
 //=============================================================================
@@ -38,6 +38,10 @@
 #include "Model.h"
 
 #include "ModelVisualizer.h"
+
+#include <atomic>
+#include <limits>
+
 //=============================================================================
 // STATICS
 //=============================================================================
@@ -48,6 +52,75 @@ using SimTK::Vec3;
 
 static const Vec3 DefaultDefaultColor(.5,.5,.5); // boring gray 
 
+//_____________________________________________________________________________
+/*
+ * Copies of the parts of a path that change with the state, kept in a cache
+ * variable so that the path itself is not modified by computePath(). The
+ * block is shared between copies of a State until one of them recomputes
+ * its path, which then makes its own copy.
+ */
+struct GeometryPath::PathPointCopies {
+    // The PathPointSet and PathWrapSet entries the copies were made from.
+    std::vector<const PathPoint*> sources;
+    std::vector<const PathWrap*> wraps;
+    // Copies of the moving path points, by index in the PathPointSet; NULL
+    // for the points whose locations do not depend on the state.
+    std::vector<std::unique_ptr<PathPoint> > movingPoints;
+    // The two wrap points of each PathWrap, by index in the PathWrapSet.
+    std::vector<std::unique_ptr<PathWrapPoint> > wrapPoints;
+    // The best wrap found last time for each PathWrap.
+    std::vector<WrapResult> previousWraps;
+
+    // Scratch for applyWrapObjects(), kept with the copies so that once its
+    // storage has grown to fit, recomputing the path does not allocate: the
+    // order in which the PathWraps are applied, what each of them did, and
+    // the wrap of the path segment being tried.
+    std::vector<int> wrapOrder;
+    std::vector<int> wrapActions;
+    WrapResult segmentWrap;
+
+    // The point that stands for entry i of the PathPointSet in the path.
+    PathPoint* updPoint(const PathPointSet& aSet, int i) const
+    {   return movingPoints[i] ? movingPoints[i].get() : &aSet.get(i); }
+};
+
+// Clear a wrap result to mean that no wrapping has happened yet.
+static void resetWrapResult(WrapResult& aWrapResult)
+{
+    aWrapResult.startPoint = -1;
+    aWrapResult.endPoint = -1;
+
+    aWrapResult.wrap_pts.setSize(0);
+    aWrapResult.wrap_path_length = 0.0;
+
+    for (int i = 0; i < 3; i++) {
+        aWrapResult.r1[i] = -std::numeric_limits<SimTK::Real>::infinity();
+        aWrapResult.r2[i] = -std::numeric_limits<SimTK::Real>::infinity();
+        aWrapResult.sv[i] = -std::numeric_limits<SimTK::Real>::infinity();
+    }
+
+    aWrapResult.factor = 1.0;
+    aWrapResult.params = SimTK::Vec2(SimTK::NaN);
+    aWrapResult.iterations = 0;
+}
+
+// Copy an array of points into the storage aTo already has, rather than
+// assigning it, which would reallocate that storage every time.
+static void copyPoints(const Array<SimTK::Vec3>& aFrom, 
+                       Array<SimTK::Vec3>& aTo)
+{
+    aTo.setSize(aFrom.getSize());
+    for (int i = 0; i < aFrom.getSize(); i++)
+        aTo[i] = aFrom[i];
+}
+
+static WrapResult makeNoWrapResult()
+{
+    WrapResult wr;
+    resetWrapResult(wr);
+    return wr;
+}
+
 //=============================================================================
 // CONSTRUCTOR(S) AND DESTRUCTOR
 //=============================================================================
@@ -121,6 +194,14 @@ void GeometryPath::connectToModel(Model& aModel) {
     }
 
     upd_display().setOwner(this);
+
+    if (hasSurrogate())
+        upd_surrogate().connectToModel(aModel);
+
+    // Create the moment-arm solver up front rather than on first use, so
+    // that computeMomentArm() does not modify the path.
+    delete _maSolver;
+    _maSolver = new MomentArmSolver(aModel);
 }
 
 //_____________________________________________________________________________
@@ -134,26 +215,37 @@ void GeometryPath::connectToModel(Model& aModel) {
     // Allocate cache entries to save the current length and speed(=d/dt length)
     // of the path in the cache. Length depends only on q's so will be valid
     // after Position stage, speed requires u's also so valid at Velocity stage.
-    addCacheVariable<double>("length", 0.0, SimTK::Stage::Position);
-    addCacheVariable<double>("speed", 0.0, SimTK::Stage::Velocity);
+    // The handles give computePath() and the accessors below direct access
+    // to the cache entries, since they run for every path at every
+    // realization.
+    _lengthCV = addCacheVariable<double>("length", 0.0, SimTK::Stage::Position);
+    _speedCV = addCacheVariable<double>("speed", 0.0, SimTK::Stage::Velocity);
     // Cache the set of points currently defining this path.
     Array<PathPoint *> pathPrototype;
-    addCacheVariable<Array<PathPoint *> >
+    _currentPathCV = addCacheVariable<Array<PathPoint *> >
         ("current_path", pathPrototype, SimTK::Stage::Position);
     // When displaying, cache the set of points to be used to draw the path.
-    addCacheVariable<Array<PathPoint *> >
+    _currentDisplayPathCV = addCacheVariable<Array<PathPoint *> >
         ("current_display_path", pathPrototype, SimTK::Stage::Position);
 
     // We consider this cache entry valid any time after it has been created
     // and first marked valid, and we won't ever invalidate it.
-    addCacheVariable<SimTK::Vec3>("color", get_default_color(), 
+    _colorCV = addCacheVariable<SimTK::Vec3>("color", get_default_color(), 
                                   SimTK::Stage::Topology);
+
+    // The state-dependent copies of path points and wrap results are made by
+    // computePath(); like the color they stay valid once created, so that the
+    // previous wrap carries over from one realization to the next.
+    _pathPointCopiesCV = addCacheVariable
+        ("path_point_copies", std::shared_ptr<PathPointCopies>(),
+         SimTK::Stage::Topology);
 }
 
 void GeometryPath::initStateFromProperties( SimTK::State& s) const
 {
     Super::initStateFromProperties(s);
-    markCacheVariableValid(s, "color"); // it is OK at its default value
+    markCacheVariableValid(s, _colorCV); // it is OK at its default value
+    markCacheVariableValid(s, _pathPointCopiesCV); // made when first needed
 }
 
 //------------------------------------------------------------------------------
@@ -232,6 +324,8 @@ void GeometryPath::constructProperties()
 
     Vec3 defaultColor = SimTK::White;
     constructProperty_default_color(defaultColor);
+
+    constructProperty_surrogate();
 }
 
 //_____________________________________________________________________________
@@ -265,7 +359,7 @@ const OpenSim::Array <PathPoint*> & GeometryPath::
 getCurrentPath(const SimTK::State& s)  const
 {
     computePath(s);   // compute checks if path needs to be recomputed
-    return getCacheVariable< Array<PathPoint*> >(s, "current_path");
+    return getCacheVariable(s, _currentPathCV);
 }
 
 // get the the path as PointForceDirections directions 
@@ -349,6 +443,21 @@ void GeometryPath::addInEquivalentForces(const SimTK::State& s,
     const SimTK::SimbodyMatterSubsystem& matter = 
                                         getModel().getMatterSubsystem();
 
+    if (useSurrogate(s)) {
+        // The generalized force of a tension is -tension*dL/dq on each of
+        // the coordinates of the polynomial.
+        const PolynomialPathSurrogate& surrogate = get_surrogate();
+        double dLdq[PolynomialPathSurrogate::MaxCoordinates];
+        surrogate.calcLength(s, dLdq);
+        for (int j = 0; j < surrogate.getNumCoordinates(); j++) {
+            const Coordinate& coord = surrogate.getCoordinate(j);
+            matter.getMobilizedBody(coord.getBodyIndex()).applyOneMobilityForce(
+                s, coord.getMobilizerQIndex(), -tension*dLdq[j], 
+                mobilityForces);
+        }
+        return;
+    }
+
     // start point, end point,  direction, and force vectors in ground
     Vec3 po(0), pf(0), dir(0), force(0);
 	// partial velocity of point in body expressed in ground 
@@ -444,7 +553,7 @@ getCurrentDisplayPath(const SimTK::State& s) const
 {
     // update the geometry to make sure the current display path is up to date.
     // updateGeometry(s);
-    return getCacheVariable<Array <PathPoint*> >(s, "current_display_path" );
+    return getCacheVariable(s, _currentDisplayPathCV);
 }
 
 //_____________________________________________________________________________
@@ -457,7 +566,7 @@ void GeometryPath::updateGeometrySize(const SimTK::State& s) const
 {
     const int numberOfSegments = get_display().countGeometry();
     const Array<PathPoint*>& currentDisplayPath = 
-        getCacheVariable<Array<PathPoint*> >(s, "current_display_path");
+        getCacheVariable(s, _currentDisplayPathCV);
 
     // Track whether we're creating geometry from scratch or
     // just updating
@@ -503,7 +612,7 @@ void GeometryPath::updateGeometryLocations(const SimTK::State& s) const
     SimTK::Vec3 globalLocation;
     SimTK::Vec3 previousPointGlobalLocation;
     const Array<PathPoint*>& currentDisplayPath = 
-        getCacheVariable<Array<PathPoint*> >(s, "current_display_path");
+        getCacheVariable(s, _currentDisplayPathCV);
 
     GeometryPath * mutableThis = const_cast<GeometryPath*>(this);
 
@@ -541,7 +650,7 @@ void GeometryPath::updateGeometry(const SimTK::State& s) const
     computePath(s);
 
     // If display path is current do not need to recompute it.
-    if (isCacheVariableValid(s, "current_display_path"))
+    if (isCacheVariableValid(s, _currentDisplayPathCV))
         return;
    
     // Updating the display path will also validate the current_display_path 
@@ -566,22 +675,22 @@ void GeometryPath::updateGeometry(const SimTK::State& s) const
 double GeometryPath::getLength( const SimTK::State& s) const
 {
     computePath(s);  // compute checks if path needs to be recomputed
-    return( getCacheVariable<double>(s, "length") );
+    return( getCacheVariable(s, _lengthCV) );
 }
 
 void GeometryPath::setLength( const SimTK::State& s, double length ) const
 {
-    setCacheVariable<double>(s, "length", length); 
+    setCacheVariable(s, _lengthCV, length); 
 }
 
 void GeometryPath::setColor(const SimTK::State& s, const SimTK::Vec3& color) const
 {
-    setCacheVariable<SimTK::Vec3>(s, "color", color);
+    setCacheVariable(s, _colorCV, color);
 }
 
 Vec3 GeometryPath::getColor(const SimTK::State& s) const
 {
-    return getCacheVariable<SimTK::Vec3>(s, "color");
+    return getCacheVariable(s, _colorCV);
 }
 
 
@@ -594,11 +703,11 @@ Vec3 GeometryPath::getColor(const SimTK::State& s) const
 double GeometryPath::getLengtheningSpeed( const SimTK::State& s) const
 {
     computeLengtheningSpeed(s);
-    return getCacheVariable<double>(s, "speed");
+    return getCacheVariable(s, _speedCV);
 }
 void GeometryPath::setLengtheningSpeed( const SimTK::State& s, double speed ) const
 {
-    setCacheVariable<double>(s, "speed", speed);    
+    setCacheVariable(s, _speedCV, speed);    
 }
 
 void GeometryPath::setPreScaleLength( const SimTK::State& s, double length ) {
@@ -967,38 +1076,145 @@ void GeometryPath::postScale(const SimTK::State& s, const ScaleSet& aScaleSet)
  */
 void GeometryPath::computePath(const SimTK::State& s) const
 {
-    const SimTK::Stage& sg = s.getSystemStage();
-    
-    if (isCacheVariableValid(s, "current_path"))  {
+    if (isCacheVariableValid(s, _currentPathCV))  {
         return;
     }
 
-    // Clear the current path.
+    // Clear the current path. It has room for every point and two wrap
+    // points per wrap object, so that filling it does not allocate.
     Array<PathPoint*>& currentPath = 
-        updCacheVariable<Array<PathPoint*> >(s, "current_path");
+        updCacheVariable(s, _currentPathCV);
     currentPath.setSize(0);
+    currentPath.ensureCapacity(get_PathPointSet().getSize()
+                               + 2*get_PathWrapSet().getSize() + 1);
 
-    // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-    // TODO: This is a bug. Here we are going to modify moving path point
-    // locations *in the property* which means they are out of sync with 
-    // the supplied state. These updates should be done in the state cache.
-    GeometryPath * mutableThis = const_cast<GeometryPath*>(this);
+    // Moving path points are located in copies held by the state, so the
+    // PathPointSet property is left untouched and the same path can be
+    // evaluated with several states at once.
+    PathPointCopies& copies = updPathPointCopies(s);
 
     // Add the active fixed and moving via points to the path.
     for (int i = 0; i < get_PathPointSet().getSize(); i++) {
-        // If this is a moving path point, update its location *in the
-        // PathPointSet property* (BAD).
-        mutableThis->upd_PathPointSet()[i].update(s);
-        if (get_PathPointSet()[i].isActive(s))
-            currentPath.append(&get_PathPointSet()[i]); // <--- !!!!BAD
+        PathPoint* point = copies.updPoint(get_PathPointSet(), i);
+        point->update(s);
+        if (point->isActive(s))
+            currentPath.append(point);
     }
   
-    // Use the current path so far to check for intersection with wrap objects, 
-    // which may add additional points to the path.
-    applyWrapObjects(s, currentPath);
-    calcLengthAfterPathComputation(s, currentPath);
+    if (useSurrogate(s)) {
+        // The polynomial gives the length; the path is not wrapped.
+        setLength(s, get_surrogate().calcLength(s));
+    } else {
+        // Use the current path so far to check for intersection with wrap
+        // objects, which may add additional points to the path.
+        applyWrapObjects(s, copies, currentPath);
+        calcLengthAfterPathComputation(s, currentPath);
+    }
+
+    markCacheVariableValid(s, _currentPathCV);
+}
 
-    markCacheVariableValid(s, "current_path");
+//_____________________________________________________________________________
+/*
+ * Whether the path has a surrogate and its coordinates are within the fitted
+ * ranges in the given state.
+ */
+bool GeometryPath::useSurrogate(const SimTK::State& s) const
+{
+    return hasSurrogate() && get_surrogate().isInRange(s);
+}
+
+//_____________________________________________________________________________
+/*
+ * Give the path a copy of a surrogate for its length.
+ */
+void GeometryPath::setSurrogate(const PolynomialPathSurrogate& aSurrogate)
+{
+    if (!aSurrogate.isFitted())
+        throw Exception("GeometryPath::setSurrogate: surrogate '" 
+            + aSurrogate.getName() + "' has not been fitted.", 
+            __FILE__, __LINE__);
+    updProperty_surrogate().clear();
+    updProperty_surrogate().adoptAndAppendValue(aSurrogate.clone());
+}
+
+//_____________________________________________________________________________
+/*
+ * Get the copies of the state-dependent points of the path in the given
+ * state, for writing. They are (re)made if the state has none yet, if they
+ * are still shared with another state, or if the points or wrap objects of
+ * the path have been added, removed or replaced since they were made.
+ */
+GeometryPath::PathPointCopies& GeometryPath::
+updPathPointCopies(const SimTK::State& s) const
+{
+    std::shared_ptr<PathPointCopies>& copies = 
+        updCacheVariable(s, _pathPointCopiesCV);
+    const PathPointSet& points = get_PathPointSet();
+    const PathWrapSet& wraps = get_PathWrapSet();
+
+    bool current = copies && copies.use_count() == 1
+        && (int)copies->sources.size() == points.getSize()
+        && (int)copies->wraps.size() == wraps.getSize();
+    for (int i = 0; current && i < points.getSize(); i++)
+        current = copies->sources[i] == &points.get(i);
+    for (int i = 0; current && i < wraps.getSize(); i++)
+        current = copies->wraps[i] == &wraps.get(i);
+    if (current) {
+        // Another state may have just released the block; see its writes.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return *copies;
+    }
+
+    std::shared_ptr<PathPointCopies> fresh(new PathPointCopies());
+    for (int i = 0; i < points.getSize(); i++) {
+        const PathPoint& point = points.get(i);
+        fresh->sources.push_back(&point);
+        fresh->movingPoints.push_back(std::unique_ptr<PathPoint>(
+            dynamic_cast<const MovingPathPoint*>(&point) ? point.clone() 
+                                                         : NULL));
+    }
+    for (int i = 0; i < wraps.getSize(); i++) {
+        PathWrap& ws = wraps.get(i);
+        fresh->wraps.push_back(&ws);
+        for (int k = 0; k < 2; k++)
+            fresh->wrapPoints.push_back(std::unique_ptr<PathWrapPoint>(
+                ws.getWrapPoint(k).clone()));
+
+        // Keep the previous wrap of a wrap object that was already there.
+        WrapResult previous;
+        resetWrapResult(previous);
+        for (int j = 0; copies && j < (int)copies->wraps.size(); j++)
+            if (copies->wraps[j] == &ws)
+                previous = copies->previousWraps[j];
+        fresh->previousWraps.push_back(previous);
+    }
+    fresh->wrapOrder.resize(wraps.getSize());
+    fresh->wrapActions.resize(wraps.getSize());
+    resetWrapResult(fresh->segmentWrap);
+
+    copies = fresh;
+    markCacheVariableValid(s, _pathPointCopiesCV);
+    return *copies;
+}
+
+//_____________________________________________________________________________
+/*
+ * Get the best wrap found over the wrap object of aPathWrap the last time the
+ * path was computed in this state.
+ */
+const WrapResult& GeometryPath::
+getPreviousWrap(const SimTK::State& s, const PathWrap& aPathWrap) const
+{
+    static const WrapResult noWrap = makeNoWrapResult();
+
+    const std::shared_ptr<PathPointCopies>& copies = 
+        getCacheVariable(s, _pathPointCopiesCV);
+    const int index = get_PathWrapSet().getIndex(&aPathWrap);
+    if (!copies || index < 0 || index >= (int)copies->previousWraps.size()
+        || copies->wraps[index] != &aPathWrap)
+        return noWrap;
+    return copies->previousWraps[index];
 }
 
 //_____________________________________________________________________________
@@ -1007,9 +1223,21 @@ void GeometryPath::computePath(const SimTK::State& s) const
  */
 void GeometryPath::computeLengtheningSpeed(const SimTK::State& s) const
 {
-    if (isCacheVariableValid(s, "speed"))
+    if (isCacheVariableValid(s, _speedCV))
         return;
 
+    if (useSurrogate(s)) {
+        // The chain rule through the polynomial: sum of dL/dq * qdot.
+        const PolynomialPathSurrogate& surrogate = get_surrogate();
+        double dLdq[PolynomialPathSurrogate::MaxCoordinates];
+        surrogate.calcLength(s, dLdq);
+        double speed = 0.0;
+        for (int j = 0; j < surrogate.getNumCoordinates(); j++)
+            speed += dLdq[j]*surrogate.getCoordinate(j).getSpeedValue(s);
+        setLengtheningSpeed(s, speed);
+        return;
+    }
+
     SimTK::Vec3 posRelative, velRelative;
     SimTK::Vec3 posStartInertial, posEndInertial, 
                 velStartInertial, velEndInertial;
@@ -1068,16 +1296,16 @@ void GeometryPath::computeLengtheningSpeed(const SimTK::State& s) const
  * Apply the wrap objects to the current path.
  */
 void GeometryPath::
-applyWrapObjects(const SimTK::State& s, Array<PathPoint*>& path) const 
+applyWrapObjects(const SimTK::State& s, PathPointCopies& copies, 
+                 Array<PathPoint*>& path) const 
 {
     if (get_PathWrapSet().getSize() < 1)
         return;
 
-    WrapResult best_wrap;
-    Array<int> result, order;
-
-    result.setSize(get_PathWrapSet().getSize());
-    order.setSize(get_PathWrapSet().getSize());
+    // Work in the scratch kept with the copies rather than in local arrays.
+    std::vector<int>& result = copies.wrapActions;
+    std::vector<int>& order = copies.wrapOrder;
+    WrapResult& wr = copies.segmentWrap;
 
     // Set the initial order to be the order they are listed in the path.
     for (int i = 0; i < get_PathWrapSet().getSize(); i++)
@@ -1094,14 +1322,20 @@ applyWrapObjects(const SimTK::State& s, Array<PathPoint*>& path) const
         for (int i = 0; i < get_PathWrapSet().getSize(); i++)
         {
             result[i] = 0;
-            PathWrap& ws = get_PathWrapSet().get(order[i]);
+            const PathWrap& ws = get_PathWrapSet().get(order[i]);
             const WrapObject* wo = ws.getWrapObject();
-            best_wrap.wrap_pts.setSize(0);
+            // The wrap points and previous wrap of ws in this state.
+            PathWrapPoint& wp0 = *copies.wrapPoints[2*order[i]];
+            PathWrapPoint& wp1 = *copies.wrapPoints[2*order[i]+1];
+            // The best wrap found is kept in previousWrap as it is found, so
+            // that it is not copied again once the search is done.
+            WrapResult& previousWrap = copies.previousWraps[order[i]];
+            bool found = false;
             double min_length_change = SimTK::Infinity;
 
             // First remove this object's wrapping points from the current path.
             for (int j = 0; j <path.getSize(); j++) {
-                if( path.get(j) == &ws.getWrapPoint(0)) {
+                if( path.get(j) == &wp0) {
                     path.remove(j); // remove the first wrap point
                     path.remove(j); // remove the second wrap point
                     break;
@@ -1138,7 +1372,8 @@ applyWrapObjects(const SimTK::State& s, Array<PathPoint*>& path) const
                         break;
                 if (jfwd > wrapEnd) // there are no active points in the path
                     return;
-                const PathPoint* const smp = &get_PathPointSet().get(jfwd);
+                const PathPoint* const smp = 
+                    copies.updPoint(get_PathPointSet(), jfwd);
 
                 // 3. Scan backwards from wrapEnd in get_PathPointSet() to find 
                 // the last point that is active. Store a pointer to it (emp).
@@ -1148,7 +1383,8 @@ applyWrapObjects(const SimTK::State& s, Array<PathPoint*>& path) const
                         break;
                 if (jrev < wrapStart) // there are no active points in the path
                     return;
-                const PathPoint* const emp = &get_PathPointSet().get(jrev);
+                const PathPoint* const emp = 
+                    copies.updPoint(get_PathPointSet(), jrev);
 
                 // 4. Now find the indices of smp and emp in _currentPath.
                 int start=-1, end=-1;
@@ -1178,7 +1414,7 @@ applyWrapObjects(const SimTK::State& s, Array<PathPoint*>& path) const
                         || (   path.get(pt1)->getWrapObject() 
                             != path.get(pt2)->getWrapObject()))
                     {
-                        WrapResult wr;
+                        resetWrapResult(wr);
                         wr.startPoint = pt1;
                         wr.endPoint   = pt2;
 
@@ -1192,10 +1428,10 @@ applyWrapObjects(const SimTK::State& s, Array<PathPoint*>& path) const
                             // that intersects the object, the first one is
                             // taken as the mandatory wrap (this is considered 
                             // an ill-conditioned case).
-                            best_wrap = wr;
-                            // Store the best wrap in the pathWrap for possible 
+                            // Store the best wrap in the state for possible 
                             // use next time.
-                            ws.setPreviousWrap(wr);
+                            previousWrap = wr;
+                            found = true;
                             break;
                         }  else if (result[i] == WrapObject::wrapped) {
                             // "wrapped" means the path segment was wrapped over
@@ -1206,16 +1442,11 @@ applyWrapObjects(const SimTK::State& s, Array<PathPoint*>& path) const
                                 calcPathLengthChange(s, *wo, wr, path);
                             if (path_length_change < min_length_change)
                             {
-                                best_wrap = wr;
-                                // Store the best wrap in the pathWrap for 
+                                // Store the best wrap in the state for 
                                 // possible use next time
-                                ws.setPreviousWrap(wr);
+                                previousWrap = wr;
+                                found = true;
                                 min_length_change = path_length_change;
-                            } else {
-                                // The wrap was not shorter than the current 
-                                // minimum, so just free the wrap points that 
-                                // were allocated.
-                                wr.wrap_pts.setSize(0);
                             }
                         } else {
                             // Nothing to do.
@@ -1223,18 +1454,18 @@ applyWrapObjects(const SimTK::State& s, Array<PathPoint*>& path) const
                     }
                 }
 
-                // Deallocate previous wrapping points if necessary.
-                ws.getWrapPoint(1).getWrapPath().setSize(0);
+                // Clear the previous wrapping points, keeping their storage.
+                wp1.getWrapPath().setSize(0);
 
-                if (best_wrap.wrap_pts.getSize() == 0) {
-                    ws.resetPreviousWrap();
-                    ws.getWrapPoint(1).getWrapPath().setSize(0);
+                if (!found || previousWrap.wrap_pts.getSize() == 0) {
+                    resetWrapResult(previousWrap);
                 } else {
                     // If wrapping did occur, copy wrap info into the PathStruct.
-                    ws.getWrapPoint(0).getWrapPath().setSize(0);
+                    const WrapResult& best_wrap = previousWrap;
+                    wp0.getWrapPath().setSize(0);
 
-                    Array<SimTK::Vec3>& wrapPath = ws.getWrapPoint(1).getWrapPath();
-                    wrapPath = best_wrap.wrap_pts;
+                    Array<SimTK::Vec3>& wrapPath = wp1.getWrapPath();
+                    copyPoints(best_wrap.wrap_pts, wrapPath);
 
                     // In OpenSim, all conversion to/from the wrap object's 
                     // reference frame will be performed inside 
@@ -1246,17 +1477,17 @@ applyWrapObjects(const SimTK::State& s, Array<PathPoint*>& path) const
                     //            ms->ground_segment);
                     // }
 
-                    ws.getWrapPoint(0).setWrapLength(0.0);
-                    ws.getWrapPoint(1).setWrapLength(best_wrap.wrap_path_length);
-                    ws.getWrapPoint(0).setBody(wo->getBody());
-                    ws.getWrapPoint(1).setBody(wo->getBody());
+                    wp0.setWrapLength(0.0);
+                    wp1.setWrapLength(best_wrap.wrap_path_length);
+                    wp0.setBody(wo->getBody());
+                    wp1.setBody(wo->getBody());
 
-                    ws.getWrapPoint(0).setLocation(s,best_wrap.r1);
-                    ws.getWrapPoint(1).setLocation(s,best_wrap.r2);
+                    wp0.setLocation(s,best_wrap.r1);
+                    wp1.setLocation(s,best_wrap.r2);
 
                     // Now insert the two new wrapping points into mp[] array.
-                    path.insert(best_wrap.endPoint, &ws.getWrapPoint(0));
-                    path.insert(best_wrap.endPoint + 1, &ws.getWrapPoint(1));
+                    path.insert(best_wrap.endPoint, &wp0);
+                    path.insert(best_wrap.endPoint + 1, &wp1);
                 }
             }
         }
@@ -1279,9 +1510,8 @@ applyWrapObjects(const SimTK::State& s, Array<PathPoint*>& path) const
                 order[1] = 0;
 
                 // remove wrap object 0 from the list of path points
-                PathWrap& ws = get_PathWrapSet().get(0);
                 for (int j = 0; j < path.getSize(); j++) {
-                    if (path.get(j) == &ws.getWrapPoint(0)) {
+                    if (path.get(j) == copies.wrapPoints[0].get()) {
                         path.remove(j); // remove the first wrap point
                         path.remove(j); // remove the second wrap point
                         break;
@@ -1367,7 +1597,20 @@ double GeometryPath::
 computeMomentArm(const SimTK::State& s, const Coordinate& aCoord) const
 {
 	if(!_maSolver)
-		_maSolver = new MomentArmSolver(*_model);
+		throw Exception("GeometryPath::computeMomentArm: path '" + getName()
+			+ "' is not connected to a model.", __FILE__, __LINE__);
+
+	// Without constraints to couple the coordinates, the moment-arm is the
+	// derivative of the polynomial. With constraints, the solver accounts
+	// for the coupling, taking its forces from the surrogate as well.
+	if(useSurrogate(s) && getModel().getConstraintSet().getSize()==0) {
+		const PolynomialPathSurrogate& surrogate = get_surrogate();
+		int index = surrogate.getCoordinateIndex(aCoord);
+		if(index < 0) return 0.0;
+		double dLdq[PolynomialPathSurrogate::MaxCoordinates];
+		surrogate.calcLength(s, dLdq);
+		return -dLdq[index];
+	}
 
     return  _maSolver->solve(s, aCoord,  *this);
 }
@@ -1384,7 +1627,7 @@ void GeometryPath::updateDisplayer(const SimTK::State& s) const
 void GeometryPath::updateDisplayPath(const SimTK::State& s) const
 {
     Array<PathPoint*>& currentDisplayPath = 
-        updCacheVariable<Array<PathPoint*> >(s, "current_display_path");
+        updCacheVariable(s, _currentDisplayPathCV);
     // Clear the current display path. Delete all path points
     // that have a NULL path pointer. This means that they were
     // created by an earlier call to updateDisplayPath() and are
@@ -1397,7 +1640,7 @@ void GeometryPath::updateDisplayPath(const SimTK::State& s) const
     currentDisplayPath.setSize(0);
 
     const Array<PathPoint*>& currentPath =  
-        getCacheVariable<Array<PathPoint*> >(s, "current_path");
+        getCacheVariable(s, _currentPathCV);
     for (int i=0; i<currentPath.getSize(); i++) {
         PathPoint* mp = currentPath.get(i);
         PathWrapPoint* mwp = dynamic_cast<PathWrapPoint*>(mp);
@@ -1419,5 +1662,5 @@ void GeometryPath::updateDisplayPath(const SimTK::State& s) const
         currentDisplayPath.append(mp);
     }
 
-    markCacheVariableValid(s, "current_display_path");
+    markCacheVariableValid(s, _currentDisplayPathCV);
 }
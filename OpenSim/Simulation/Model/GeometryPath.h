@@ -32,6 +32,7 @@
 #include "PathPointSet.h"
 #include <OpenSim/Simulation/Wrap/PathWrapSet.h>
 #include <OpenSim/Simulation/MomentArmSolver.h>
+#include "PolynomialPathSurrogate.h"
 
 
 #ifdef SWIG
@@ -46,6 +47,7 @@ namespace OpenSim {
 class Coordinate;
 class WrapResult;
 class WrapObject;
+class PathWrap;
 class PointForceDirection;
 
 //=============================================================================
@@ -71,6 +73,8 @@ private:
 	
 	OpenSim_DECLARE_OPTIONAL_PROPERTY(default_color, SimTK::Vec3, "Used to initialize the colour cache variable");
 
+	OpenSim_DECLARE_OPTIONAL_PROPERTY(surrogate, PolynomialPathSurrogate, "Polynomial of the coordinates used for the length of the path, in place of its geometry, within the fitted ranges of the coordinates");
+
 	// used for scaling tendon and fiber lengths
 	double _preScaleLength;
 
@@ -78,7 +82,22 @@ private:
 	SimTK::ReferencePtr<Object> _owner;
 
 	// solver used to compute moment-arms
-	mutable SimTK::ReferencePtr<MomentArmSolver> _maSolver;
+	SimTK::ReferencePtr<MomentArmSolver> _maSolver;
+
+	// The parts of the path that change with the state: copies of the moving
+	// path points and of the wrap points, the previous wrap results, and the
+	// scratch used to wrap the path without allocating.
+	struct PathPointCopies;
+
+	// handles to the cache variables; addToSystem() assigns them, and they
+	// can be used once the system has been realized to Topology
+	mutable CacheVariableHandle<double> _lengthCV;
+	mutable CacheVariableHandle<double> _speedCV;
+	mutable CacheVariableHandle< Array<PathPoint*> > _currentPathCV;
+	mutable CacheVariableHandle< Array<PathPoint*> > _currentDisplayPathCV;
+	mutable CacheVariableHandle<SimTK::Vec3> _colorCV;
+	mutable CacheVariableHandle< std::shared_ptr<PathPointCopies> >
+		_pathPointCopiesCV;
 	
 //=============================================================================
 // METHODS
@@ -150,6 +169,12 @@ public:
 	double getLengtheningSpeed(const SimTK::State& s) const;
 	void setLengtheningSpeed( const SimTK::State& s, double speed ) const;
 
+	/** Get the result of the last wrapping of this path over the wrap object
+	of aPathWrap in the given state, which seeds the next wrapping. Before
+	the path has wrapped the result has no tangent points (they are -Inf). **/
+	const WrapResult& getPreviousWrap(const SimTK::State& s,
+		const PathWrap& aPathWrap) const;
+
 	/** get the the path as PointForceDirections directions, which can be used
 	    to apply tension to bodies the points are connected to.*/
 	void getPointForceDirections(const SimTK::State& s, 
@@ -168,6 +193,23 @@ public:
 							   SimTK::Vector& mobilityForces) const;
 
 
+	//--------------------------------------------------------------------------
+	// SURROGATE
+	//--------------------------------------------------------------------------
+	/** Whether the path has a polynomial surrogate for its length. **/
+	bool hasSurrogate() const { return !getProperty_surrogate().empty(); }
+	/** Get the surrogate; check first with hasSurrogate(). **/
+	const PolynomialPathSurrogate& getSurrogate() const { return get_surrogate(); }
+	/** Give the path a copy of a fitted surrogate. While the coordinates of
+	the surrogate are within its fitted ranges, the length, lengthening speed,
+	moment arms and the forces of a tension along the path are computed from
+	the polynomial and the path is not wrapped; the current path then holds
+	only the active path points. Takes effect once the model is connected
+	again (e.g., by initSystem()). **/
+	void setSurrogate(const PolynomialPathSurrogate& aSurrogate);
+	/** Go back to computing the path from its geometry everywhere. **/
+	void clearSurrogate() { updProperty_surrogate().clear(); }
+
 	//--------------------------------------------------------------------------
 	// COMPUTATIONS
 	//--------------------------------------------------------------------------
@@ -210,8 +252,11 @@ protected:
 private:
 
 	void computePath(const SimTK::State& s ) const;
+	bool useSurrogate(const SimTK::State& s) const;
 	void computeLengtheningSpeed(const SimTK::State& s) const;
-	void applyWrapObjects(const SimTK::State& s, Array<PathPoint*>& path ) const;
+	PathPointCopies& updPathPointCopies(const SimTK::State& s) const;
+	void applyWrapObjects(const SimTK::State& s, PathPointCopies& copies,
+		Array<PathPoint*>& path ) const;
 	double calcPathLengthChange(const SimTK::State& s, const WrapObject& wo, 
                                 const WrapResult& wr, 
                                 const Array<PathPoint*>& path) const; 
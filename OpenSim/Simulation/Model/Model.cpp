@@ -46,11 +46,13 @@
 #include <OpenSim/Simulation/CoordinateReference.h>
 
 #include "SimTKcommon/internal/SystemGuts.h"
+#include "SimTKcommon/internal/ParallelExecutor.h"
 
 #include "Model.h"
 #include "ModelVisualizer.h"
 
 #include "Muscle.h"
+#include "PathActuator.h"
 #include "CoordinateSet.h"
 #include "BodySet.h"
 #include "AnalysisSet.h"
@@ -75,6 +77,47 @@ using namespace SimTK;
 //=============================================================================
 // STATICS
 //=============================================================================
+namespace {
+
+/**
+ * Computes the path, and for muscles the dynamics, of one PathActuator per
+ * index into the cache of the State. Nothing is summed here: the forces are
+ * applied afterwards, one at a time in the order of the ForceSet.
+ */
+class PathActuatorDynamicsTask : public SimTK::ParallelExecutor::Task {
+public:
+	PathActuatorDynamicsTask(const State &aState,
+		const Array_<const PathActuator*> &aActuators) :
+		_state(aState), _actuators(aActuators) {}
+
+	void execute(int aIndex) {
+		const PathActuator &act = *_actuators[aIndex];
+		try {
+			if(act.isDisabled(_state) || act.isForceOverriden(_state))
+				return;
+			const Muscle *muscle = dynamic_cast<const Muscle*>(&act);
+			if(muscle)
+				muscle->getTendonForce(_state);
+			else
+				act.getLengtheningSpeed(_state);
+		}
+		catch(const OpenSim::Exception&) {
+			// Left for the actuator to fail on when its force is applied. A
+			// cache entry is only marked valid once it has been computed, so
+			// the actuator computes it again, on the calling thread, and
+			// throws the same error from there.
+		}
+		catch(const SimTK::Exception::Base&) {
+			// As above, for errors raised by Simbody.
+		}
+	}
+
+private:
+	const State &_state;
+	const Array_<const PathActuator*> &_actuators;
+};
+
+} // namespace
 
 
 //=============================================================================
@@ -213,6 +256,7 @@ Model::Model(const Model &aModel) :
 Model::~Model()
 {
 	delete _assemblySolver;
+	delete _pathActuatorExecutor;
     delete _modelViz;
 	delete _contactSubsystem;
 	delete _gravityForce;
@@ -326,6 +370,7 @@ void Model::copyData(const Model &aModel)
 
 	//Handle new style properties
 	copyProperty_assembly_accuracy(aModel);
+	copyProperty_num_threads(aModel);
 	copyProperty_BodySet(aModel);
 	copyProperty_JointSet(aModel);
 
@@ -356,6 +401,7 @@ void Model::setNull()
 
     _modelViz = NULL;
 	_assemblySolver = NULL;
+	_pathActuatorExecutor = NULL;
 
 	_validationLog="";
 
@@ -365,6 +411,7 @@ void Model::setNull()
 void Model::constructProperties()
 {
 	constructProperty_assembly_accuracy(1e-9);
+	constructProperty_num_threads(1);
 
 	BodySet bodies;
 	bodies.setName("Bodies");
@@ -638,6 +685,19 @@ void Model::createMultibodySystem()
 	_gravityForce = new SimTK::Force::Gravity(*_forceSubsystem, *_matter, direction, magnitude);
 
 	addToSystem(*_system);
+
+	// PathActuators to be computed in parallel in realizeDynamics().
+	_pathActuators.clear();
+	for (int i = 0; i < _forceSet.getSize(); ++i) {
+		const PathActuator* act = dynamic_cast<const PathActuator*>(&_forceSet.get(i));
+		if (act) _pathActuators.push_back(act);
+	}
+	delete _pathActuatorExecutor;
+	_pathActuatorExecutor = NULL;
+	int numThreads = get_num_threads() > 0 ? get_num_threads() :
+		SimTK::ParallelExecutor::getNumProcessors();
+	if (numThreads > 1 && _pathActuators.size() > 1)
+		_pathActuatorExecutor = new SimTK::ParallelExecutor(numThreads);
 }
 
 
@@ -1152,6 +1212,36 @@ void Model::initStateFromProperties(SimTK::State& state) const
 	*/
 }
 
+//_____________________________________________________________________________
+/**
+ * Compute the paths and dynamics of all the PathActuators on several threads,
+ * if num_threads allows. The Model is realized before the force subsystem, so
+ * when the forces are applied afterwards each finds its length, speed and
+ * muscle dynamics in the cache, and the forces are summed in the order of the
+ * ForceSet exactly as they are on one thread.
+ */
+void Model::realizeDynamics(const SimTK::State& state) const
+{
+	Super::realizeDynamics(state);
+
+	if(_pathActuatorExecutor == NULL)
+		return;
+
+	// If another thread is realizing this Model with the executor, the
+	// actuators compute their paths in sequence when their forces are applied.
+	std::unique_lock<std::mutex> lock(_pathActuatorExecutorMutex,
+		std::try_to_lock);
+	if(!lock.owns_lock())
+		return;
+
+	// Compute the controls here rather than have the first actuator to ask
+	// for its control do it on some thread.
+	getControls(state);
+
+	PathActuatorDynamicsTask task(state, _pathActuators);
+	_pathActuatorExecutor->execute(task, _pathActuators.size());
+}
+
 void Model::setPropertiesFromState(const SimTK::State& state)
 {
 	Super::setPropertiesFromState(state);
@@ -2043,12 +2133,12 @@ void Model::formStateStorage(const Storage& originalStorage, Storage& statesStor
 	int* mapColumns = new int[rStateNames.getSize()];
 	for(int i=0; i< rStateNames.getSize(); i++){
 		// the index is -1 if not found, >=1 otherwise since time has index 0 by defn.
-		int fix = originalStorage.getColumnLabels().findIndex(rStateNames[i]);
+		int fix = originalStorage.getColumnIndex(rStateNames[i]);
 		if (fix==-1){
 			// try removing the complete path name to identify the state_name in storage
 			string::size_type last = rStateNames[i].rfind("/");
 			string name = rStateNames[i].substr(last+1, rStateNames[i].length()-last);
-			fix = originalStorage.getColumnLabels().findIndex(name);
+			fix = originalStorage.getColumnIndex(name);
 			// still not found
 			if(fix == -1){
 				name = rStateNames[i];
@@ -2056,7 +2146,7 @@ void Model::formStateStorage(const Storage& originalStorage, Storage& statesStor
 				name.replace(last, 1, ".");
 				last = name.rfind("/");
 				name = name.substr(last+1, rStateNames[i].length()-last);
-				fix = originalStorage.getColumnLabels().findIndex(name);
+				fix = originalStorage.getColumnIndex(name);
 			}
 		}
 		mapColumns[i] = fix;
@@ -2067,13 +2157,14 @@ void Model::formStateStorage(const Storage& originalStorage, Storage& statesStor
 	// Now cycle thru and shuffle each
 
 	for (int row =0; row< originalStorage.getSize(); row++){
-		StateVector* originalVec = originalStorage.getStateVector(row);
-		StateVector* stateVec = new StateVector(originalVec->getTime());
+		double time = 0.0;
+		originalStorage.getTime(row, time);
+		StateVector* stateVec = new StateVector(time);
 		stateVec->getData().setSize(numStates);  // default value 0f 0.
 		for(int column=0; column< numStates; column++){
 			double valueInOriginalStorage=0.0;
 			if (mapColumns[column]!=-1)
-				originalVec->getDataValue(mapColumns[column]-1, valueInOriginalStorage);
+				originalStorage.getData(row, mapColumns[column]-1, valueInOriginalStorage);
 
 			stateVec->setDataValue(column, valueInOriginalStorage);
 
@@ -2101,7 +2192,7 @@ void Model::formQStorage(const Storage& originalStorage, Storage& qStorage) {
 	int* mapColumns = new int[qNames.getSize()];
 	for(int i=0; i< nq; i++){
 		// the index is -1 if not found, >=1 otherwise since time has index 0 by defn.
-		mapColumns[i] = originalStorage.getColumnLabels().findIndex(qNames[i]);
+		mapColumns[i] = originalStorage.getColumnIndex(qNames[i]);
 		if (mapColumns[i]==-1)
 			cout << "\n Column "<< qNames[i] << " not found in formQStorage, assuming 0.\n" << endl;
 	}
@@ -2109,13 +2200,14 @@ void Model::formQStorage(const Storage& originalStorage, Storage& qStorage) {
 
 	// Now cycle thru and shuffle each
 	for (int row =0; row< originalStorage.getSize(); row++){
-		StateVector* originalVec = originalStorage.getStateVector(row);
-		StateVector* stateVec = new StateVector(originalVec->getTime());
+		double time = 0.0;
+		originalStorage.getTime(row, time);
+		StateVector* stateVec = new StateVector(time);
 		stateVec->getData().setSize(nq);  // default value 0f 0.
 		for(int column=0; column< nq; column++){
 			double valueInOriginalStorage=0.0;
 			if (mapColumns[column]!=-1)
-				originalVec->getDataValue(mapColumns[column]-1, valueInOriginalStorage);
+				originalStorage.getData(row, mapColumns[column]-1, valueInOriginalStorage);
 
 			stateVec->setDataValue(column, valueInOriginalStorage);
 		}
@@ -25,6 +25,7 @@
 
 // INCLUDES
 #include <string>
+#include <mutex>
 #include <OpenSim/Simulation/osimSimulationDLL.h>
 #include <OpenSim/Common/Set.h>
 #include <OpenSim/Common/ArrayPtrs.h>
@@ -68,6 +69,7 @@ class ControllerSet;
 class ModelDisplayHints;
 class ModelVisualizer;
 class ComponentSet;
+class PathActuator;
 
 #ifdef SWIG
 	#ifdef OSIMSIMULATION_API
@@ -120,6 +122,13 @@ public:
 	"at locations measured to five significant digits while the model lacks dofs "
 	"to change stance width, in which case it cannot achieve 1e-9 accuracy." );
 
+	OpenSim_DECLARE_PROPERTY(num_threads, int,
+	"Number of threads used to compute the paths and muscle dynamics of all "
+	"the PathActuators (including muscles) before their forces are applied. "
+	"The default, 1, computes each of them as its force is applied; "
+	"0 or less uses all the processors. Forces are summed in the same order "
+	"either way, so the results do not depend on the number of threads." );
+
 	OpenSim_DECLARE_UNNAMED_PROPERTY(BodySet,
 	    "List of bodies that make up this model.");
 
@@ -862,6 +871,11 @@ public:
     //--------------------------------------------------------------------------
 
 
+protected:
+	/** Compute the paths and dynamics of the PathActuators on several
+	threads, when num_threads allows, before their forces are applied. **/
+	void realizeDynamics(const SimTK::State& state) const override;
+
 private:
 	// Set the values of all data members to an appropriate "null" value.
 	void setNull();
@@ -1022,6 +1036,17 @@ private:
 	// Default values pooled from Actuators upon system creation.
 	mutable SimTK::Vector _defaultControls;
 
+	// Executor computing the paths and dynamics of the PathActuators in
+	// realizeDynamics() when num_threads allows more than one thread, 
+	// otherwise NULL. Owned by the Model and must be destructed.
+	SimTK::ParallelExecutor* _pathActuatorExecutor;
+	// Held while the executor runs. A const Model may be realized on several
+	// threads at once, and an executor runs one task at a time, so the
+	// realizations that find it busy compute their actuators in sequence.
+	mutable std::mutex _pathActuatorExecutorMutex;
+	// The PathActuators of the ForceSet, found when the system is created.
+	SimTK::Array_<const PathActuator*> _pathActuators;
+
 
     //                          VISUALIZATION
     // Anyone generating display geometry from this Model should consult this
@@ -107,6 +107,11 @@ void MovingPathPoint::copyData(const MovingPathPoint &aPoint)
 	_yCoordinateName = aPoint._yCoordinateName;
 	_zLocation = (Function*)Object::SafeCopy(aPoint._zLocation);
 	_zCoordinateName = aPoint._zCoordinateName;
+	// Keep the connections so that a copy made by the owning path can be
+	// updated without connecting it to the model again.
+	_xCoordinate = aPoint._xCoordinate;
+	_yCoordinate = aPoint._yCoordinate;
+	_zCoordinate = aPoint._zCoordinate;
 }
 
 //_____________________________________________________________________________
@@ -320,6 +325,7 @@ connectToModelAndPath(const Model& aModel, GeometryPath& aPath)
 
 	// Look up the coordinates by name in the dynamics engine and
 	// store pointers to them.
+	setNull();
     if (aModel.getCoordinateSet().contains(_xCoordinateName))
         _xCoordinate = &aModel.getCoordinateSet().get(_xCoordinateName);
     if (aModel.getCoordinateSet().contains(_yCoordinateName))
@@ -375,25 +381,25 @@ void MovingPathPoint::update(const SimTK::State& s)
         const double xval = SimTK::clamp(_xCoordinate->getRangeMin(),
                                          _xCoordinate->getValue(s),
                                          _xCoordinate->getRangeMax());
-		_location[0] = _xLocation->calcValue(SimTK::Vector(1, xval));
+		_location[0] = _xLocation->calcValue(xval);
     } else // type == Constant
-		_location[0] = _xLocation->calcValue(SimTK::Vector(1, 0.0));
+		_location[0] = _xLocation->calcValue(0.0);
 
 	if (_yCoordinate) {
         const double yval = SimTK::clamp(_yCoordinate->getRangeMin(),
                                          _yCoordinate->getValue(s),
                                          _yCoordinate->getRangeMax());
-		_location[1] = _yLocation->calcValue(SimTK::Vector(1, yval));
+		_location[1] = _yLocation->calcValue(yval);
     } else // type == Constant
-		_location[1] = _yLocation->calcValue(SimTK::Vector(1, 0.0));
+		_location[1] = _yLocation->calcValue(0.0);
 
 	if (_zCoordinate) {
         const double zval = SimTK::clamp(_zCoordinate->getRangeMin(),
                                          _zCoordinate->getValue(s),
                                          _zCoordinate->getRangeMax());
-		_location[2] = _zLocation->calcValue(SimTK::Vector(1, zval));
+		_location[2] = _zLocation->calcValue(zval);
     } else // type == Constant
-		_location[2] = _zLocation->calcValue(SimTK::Vector(1, 0.0));
+		_location[2] = _zLocation->calcValue(0.0);
 }
 
 //_____________________________________________________________________________
@@ -405,12 +411,9 @@ void MovingPathPoint::update(const SimTK::State& s)
 
 void MovingPathPoint::getVelocity(const SimTK::State& s, SimTK::Vec3& aVelocity)
 {
-	std::vector<int> derivComponents;
-	derivComponents.push_back(0);
-
 	if (_xCoordinate){
 		//Multiply the partial (derivative of point coordinate w.r.t. gencoord) by genspeed
-		aVelocity[0] = _xLocation->calcDerivative(derivComponents, SimTK::Vector(1, _xCoordinate->getValue(s)))*
+		aVelocity[0] = _xLocation->calcDerivative(_xCoordinate->getValue(s), 1)*
 			_xCoordinate->getSpeedValue(s);
 	}
 	else
@@ -418,7 +421,7 @@ void MovingPathPoint::getVelocity(const SimTK::State& s, SimTK::Vec3& aVelocity)
 
 	if (_yCoordinate){
 		//Multiply the partial (derivative of point coordinate w.r.t. gencoord) by genspeed
-		aVelocity[1] = _yLocation->calcDerivative(derivComponents, SimTK::Vector(1, _yCoordinate->getValue(s)))*
+		aVelocity[1] = _yLocation->calcDerivative(_yCoordinate->getValue(s), 1)*
 			_yCoordinate->getSpeedValue(s);
 	}
 	else
@@ -426,7 +429,7 @@ void MovingPathPoint::getVelocity(const SimTK::State& s, SimTK::Vec3& aVelocity)
 
 	if (_zCoordinate){
 		//Multiply the partial (derivative of point coordinate w.r.t. gencoord) by genspeed
-		aVelocity[2] = _zLocation->calcDerivative(derivComponents, SimTK::Vector(1, _zCoordinate->getValue(s)))*
+		aVelocity[2] = _zLocation->calcDerivative(_zCoordinate->getValue(s), 1)*
 			_zCoordinate->getSpeedValue(s);
 	}
 	else
@@ -444,23 +447,20 @@ SimTK::Vec3 MovingPathPoint::getdPointdQ(const SimTK::State& s) const
 {
 	SimTK::Vec3 dPdq_B(0);
 
-	std::vector<int> derivComponents;
-	derivComponents.push_back(0);
-
 	if (_xCoordinate){
 		//Multiply the partial (derivative of point coordinate w.r.t. gencoord) by genspeed
-		dPdq_B[0] = _xLocation->calcDerivative(derivComponents, 
-			SimTK::Vector(1, _xCoordinate->getValue(s)));
+		dPdq_B[0] = _xLocation->calcDerivative(
+			_xCoordinate->getValue(s), 1);
 	}
 	if (_yCoordinate){
 		//Multiply the partial (derivative of point coordinate w.r.t. gencoord) by genspeed
-		dPdq_B[1] = _yLocation->calcDerivative(derivComponents, 
-			SimTK::Vector(1, _yCoordinate->getValue(s)));
+		dPdq_B[1] = _yLocation->calcDerivative(
+			_yCoordinate->getValue(s), 1);
 	}
 	if (_zCoordinate){
 		//Multiply the partial (derivative of point coordinate w.r.t. gencoord) by genspeed
-		dPdq_B[2] = _zLocation->calcDerivative(derivComponents, 
-			SimTK::Vector(1, _zCoordinate->getValue(s)));
+		dPdq_B[2] = _zLocation->calcDerivative(
+			_zCoordinate->getValue(s), 1);
 	}
 
 	return dPdq_B;
@@ -188,13 +188,13 @@ void Muscle::connectToModel(Model& aModel)
     //              both the position and velocity of the multibody system and
     //              the muscles path before solving for the fiber length and
     //              velocity in the reduced model.
-    addCacheVariable<Muscle::MuscleLengthInfo>
+    _lengthInfoCV = addCacheVariable<Muscle::MuscleLengthInfo>
        ("lengthInfo", MuscleLengthInfo(), SimTK::Stage::Velocity);
-	addCacheVariable<Muscle::FiberVelocityInfo>
+	_velInfoCV = addCacheVariable<Muscle::FiberVelocityInfo>
        ("velInfo", FiberVelocityInfo(), SimTK::Stage::Velocity);
-	addCacheVariable<Muscle::MuscleDynamicsInfo>
+	_dynamicsInfoCV = addCacheVariable<Muscle::MuscleDynamicsInfo>
        ("dynamicsInfo", MuscleDynamicsInfo(), SimTK::Stage::Dynamics);
-	addCacheVariable<Muscle::MusclePotentialEnergyInfo>
+	_potentialEnergyInfoCV = addCacheVariable<Muscle::MusclePotentialEnergyInfo>
        ("potentialEnergyInfo", MusclePotentialEnergyInfo(), SimTK::Stage::Velocity);
  }
 
@@ -475,79 +475,79 @@ void Muscle::setExcitation(SimTK::State& s, double excitation) const
 /* Access to muscle calculation data structures */
 const Muscle::MuscleLengthInfo& Muscle::getMuscleLengthInfo(const SimTK::State& s) const
 {
-	if(!isCacheVariableValid(s,"lengthInfo")){
+	if(!isCacheVariableValid(s,_lengthInfoCV)){
 		MuscleLengthInfo &umli = updMuscleLengthInfo(s);
 		calcMuscleLengthInfo(s, umli);
-		markCacheVariableValid(s,"lengthInfo");
+		markCacheVariableValid(s,_lengthInfoCV);
 		// don't bother fishing it out of the cache since 
 		// we just calculated it and still have a handle on it
 		return umli;
 	}
-	return getCacheVariable<MuscleLengthInfo>(s, "lengthInfo");
+	return getCacheVariable(s, _lengthInfoCV);
 }
 
 Muscle::MuscleLengthInfo& Muscle::updMuscleLengthInfo(const SimTK::State& s) const
 {
-	return updCacheVariable<MuscleLengthInfo>(s, "lengthInfo");
+	return updCacheVariable(s, _lengthInfoCV);
 }
 
 const Muscle::FiberVelocityInfo& Muscle::
 getFiberVelocityInfo(const SimTK::State& s) const
 {
-	if(!isCacheVariableValid(s,"velInfo")){
+	if(!isCacheVariableValid(s,_velInfoCV)){
 		FiberVelocityInfo& ufvi = updFiberVelocityInfo(s);
 		calcFiberVelocityInfo(s, ufvi);
-		markCacheVariableValid(s,"velInfo");
+		markCacheVariableValid(s,_velInfoCV);
 		// don't bother fishing it out of the cache since 
 		// we just calculated it and still have a handle on it
 		return ufvi;
 	}
-	return getCacheVariable<FiberVelocityInfo>(s, "velInfo");
+	return getCacheVariable(s, _velInfoCV);
 }
 
 Muscle::FiberVelocityInfo& Muscle::
 updFiberVelocityInfo(const SimTK::State& s) const
 {
-	return updCacheVariable<FiberVelocityInfo>(s, "velInfo");
+	return updCacheVariable(s, _velInfoCV);
 }
 
 const Muscle::MuscleDynamicsInfo& Muscle::
 getMuscleDynamicsInfo(const SimTK::State& s) const
 {
-	if(!isCacheVariableValid(s,"dynamicsInfo")){
+	if(!isCacheVariableValid(s,_dynamicsInfoCV)){
 		MuscleDynamicsInfo& umdi = updMuscleDynamicsInfo(s);
 		calcMuscleDynamicsInfo(s, umdi);
-		markCacheVariableValid(s,"dynamicsInfo");
+		markCacheVariableValid(s,_dynamicsInfoCV);
 		// don't bother fishing it out of the cache since 
 		// we just calculated it and still have a handle on it
 		return umdi;
 	}
-	return getCacheVariable<MuscleDynamicsInfo>(s, "dynamicsInfo");
+	return getCacheVariable(s, _dynamicsInfoCV);
 }
 Muscle::MuscleDynamicsInfo& Muscle::
 updMuscleDynamicsInfo(const SimTK::State& s) const
 {
-	return updCacheVariable<MuscleDynamicsInfo>(s, "dynamicsInfo");
+	return updCacheVariable(s, _dynamicsInfoCV);
 }
 
 const Muscle::MusclePotentialEnergyInfo& Muscle::
 getMusclePotentialEnergyInfo(const SimTK::State& s) const
 {
-	if(!isCacheVariableValid(s,"potentialEnergyInfo")){
+	if(!isCacheVariableValid(s,_potentialEnergyInfoCV)){
 		MusclePotentialEnergyInfo& umpei = updMusclePotentialEnergyInfo(s);
 		calcMusclePotentialEnergyInfo(s, umpei);
-		markCacheVariableValid(s,"potentialEnergyInfo");
+		markCacheVariableValid(s,_potentialEnergyInfoCV);
 		// don't bother fishing it out of the cache since 
 		// we just calculated it and still have a handle on it
 		return umpei;
 	}
-	return getCacheVariable<MusclePotentialEnergyInfo>(s, "potentialEnergyInfo");
+	return getCacheVariable(s, _potentialEnergyInfoCV);
 }
 
 Muscle::MusclePotentialEnergyInfo& Muscle::
 updMusclePotentialEnergyInfo(const SimTK::State& s) const
 {
-	return updCacheVariable<MusclePotentialEnergyInfo>(s, "potentialEnergyInfo");
+	return updCacheVariable(s, _potentialEnergyInfoCV);
 }
 
 
@@ -376,6 +376,14 @@ private:
 	void constructProperties();
 	void copyData(const Muscle &aMuscle);
 
+	// Handles to the muscle info cache variables. addToSystem() assigns them
+	// and they can be used once the system has been realized to Topology.
+	// The info accessors are called many times per muscle per realization.
+	mutable CacheVariableHandle<MuscleLengthInfo> _lengthInfoCV;
+	mutable CacheVariableHandle<FiberVelocityInfo> _velInfoCV;
+	mutable CacheVariableHandle<MuscleDynamicsInfo> _dynamicsInfoCV;
+	mutable CacheVariableHandle<MusclePotentialEnergyInfo> _potentialEnergyInfoCV;
+
 	//--------------------------------------------------------------------------
 	// Implement Object interface.
 	//--------------------------------------------------------------------------
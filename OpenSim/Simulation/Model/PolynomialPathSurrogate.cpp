@@ -0,0 +1,403 @@
+/* -------------------------------------------------------------------------- *
+ *                   OpenSim:  PolynomialPathSurrogate.cpp                    *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2012 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/SimbodyEngine/Coordinate.h>
+#include <SimTKmath.h>
+
+#include "PolynomialPathSurrogate.h"
+#include "GeometryPath.h"
+
+//=============================================================================
+// USING
+//=============================================================================
+using namespace std;
+using namespace OpenSim;
+using SimTK::State; using SimTK::Vector; using SimTK::Matrix;
+
+//=============================================================================
+// CONSTRUCTOR(S) AND DESTRUCTOR
+//=============================================================================
+//_____________________________________________________________________________
+// Default constructor.
+PolynomialPathSurrogate::PolynomialPathSurrogate()
+{
+	constructProperties();
+}
+
+//_____________________________________________________________________________
+// Constructor with coordinate names and degree.
+PolynomialPathSurrogate::
+PolynomialPathSurrogate(const Array<string>& coordinateNames, int degree)
+{
+	constructProperties();
+	set_coordinates(coordinateNames);
+	set_degree(degree);
+	updateExponents();
+}
+
+//=============================================================================
+// CONSTRUCTION METHODS
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Connect properties to local pointers.
+ */
+void PolynomialPathSurrogate::constructProperties()
+{
+	constructProperty_coordinates();
+	constructProperty_range_min();
+	constructProperty_range_max();
+	constructProperty_degree(3);
+	constructProperty_coefficients();
+}
+
+//_____________________________________________________________________________
+/**
+ * Throw if the surrogate has too many coordinates or too large a degree to
+ * be evaluated.
+ */
+void PolynomialPathSurrogate::checkSize() const
+{
+	if(getNumCoordinates()<1 || getNumCoordinates()>MaxCoordinates
+		|| get_degree()<1 || get_degree()>MaxDegree) {
+		throw Exception("PolynomialPathSurrogate "+getName()+": needs 1 to "
+			+to_string((long long)MaxCoordinates)+" coordinates and a degree "
+			"of 1 to "+to_string((long long)MaxDegree)+".",__FILE__,__LINE__);
+	}
+}
+
+//_____________________________________________________________________________
+/**
+ * List the exponents of the coordinates in each term, in graded
+ * lexicographic order: by total degree, then by decreasing exponent of the
+ * first coordinate, then of the second, and so on.
+ */
+void PolynomialPathSurrogate::updateExponents()
+{
+	checkSize();
+	int nc = getNumCoordinates();
+	_exponents.clear();
+
+	int e[MaxCoordinates];
+	for(int total=0; total<=get_degree(); total++) {
+		// First term of this degree: everything in the first coordinate.
+		for(int j=0; j<nc; j++) e[j] = 0;
+		e[0] = total;
+		for(;;) {
+			for(int j=0; j<nc; j++) _exponents.push_back(e[j]);
+
+			// Next term: move one power from the last coordinate with a
+			// nonzero exponent before the end to the one after it, and
+			// gather everything after that coordinate there.
+			int k = nc-2;
+			while(k>=0 && e[k]==0) k--;
+			if(k<0) break;
+			e[k]--;
+			int rest = e[nc-1];
+			e[nc-1] = 0;
+			e[k+1] += rest + 1;
+		}
+	}
+}
+
+//=============================================================================
+// GET
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Number of terms of total degree up to the degree, C(nc+degree, degree).
+ */
+int PolynomialPathSurrogate::getNumTerms() const
+{
+	int nc = getNumCoordinates();
+	int n = 1;
+	for(int k=1; k<=get_degree(); k++)
+		n = n*(nc+k)/k;
+	return n;
+}
+
+//_____________________________________________________________________________
+bool PolynomialPathSurrogate::isFitted() const
+{
+	int nc = getNumCoordinates();
+	return nc>0 && getProperty_range_min().size()==nc
+		&& getProperty_range_max().size()==nc
+		&& getProperty_coefficients().size()==getNumTerms();
+}
+
+//_____________________________________________________________________________
+/**
+ * Look up the coordinates of the surrogate in the model.
+ */
+void PolynomialPathSurrogate::connectToModel(const Model& aModel)
+{
+	updateExponents();
+
+	const CoordinateSet& coords = aModel.getCoordinateSet();
+	_coordinates.clear();
+	for(int i=0; i<getNumCoordinates(); i++) {
+		if(!coords.contains(get_coordinates(i)))
+			throw Exception("PolynomialPathSurrogate: coordinate "
+				+ get_coordinates(i) + " is not in the model.",
+				__FILE__,__LINE__);
+		_coordinates.push_back(SimTK::ReferencePtr<const Coordinate>(
+			&coords.get(get_coordinates(i))));
+	}
+}
+
+//_____________________________________________________________________________
+int PolynomialPathSurrogate::
+getCoordinateIndex(const Coordinate& aCoordinate) const
+{
+	for(int i=0; i<(int)_coordinates.size(); i++)
+		if(_coordinates[i].get()==&aCoordinate) return i;
+	return -1;
+}
+
+//_____________________________________________________________________________
+const Coordinate& PolynomialPathSurrogate::getCoordinate(int aIndex) const
+{
+	return *_coordinates[aIndex];
+}
+
+//=============================================================================
+// EVALUATION
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Whether the coordinates in the state are all within the fitted ranges.
+ */
+bool PolynomialPathSurrogate::isInRange(const State& s) const
+{
+	int nc = getNumCoordinates();
+	if((int)_coordinates.size()!=nc || !isFitted()) return false;
+	for(int i=0; i<nc; i++) {
+		double q = _coordinates[i]->getValue(s);
+		if(!(q>=get_range_min(i) && q<=get_range_max(i))) return false;
+	}
+	return true;
+}
+
+//_____________________________________________________________________________
+/**
+ * Value and gradient of the polynomial at the scaled coordinates x. The
+ * powers of each coordinate (and their derivatives) are tabulated once, so
+ * each term is a product of table entries.
+ */
+double PolynomialPathSurrogate::
+calcPolynomial(const double* x, double* rGradient) const
+{
+	int nc = getNumCoordinates();
+	int nd = get_degree();
+	int nt = getNumTerms();
+	if((int)_exponents.size()!=nt*nc)
+		throw Exception("PolynomialPathSurrogate: "+getName()
+			+" has not been connected or fitted.",__FILE__,__LINE__);
+
+	double p[MaxCoordinates][MaxDegree+1];
+	double dp[MaxCoordinates][MaxDegree+1];
+	for(int j=0; j<nc; j++) {
+		p[j][0] = 1.0;
+		dp[j][0] = 0.0;
+		for(int k=1; k<=nd; k++) {
+			p[j][k] = p[j][k-1]*x[j];
+			dp[j][k] = k*p[j][k-1];
+		}
+	}
+
+	if(rGradient)
+		for(int j=0; j<nc; j++) rGradient[j] = 0.0;
+
+	double value = 0.0;
+	const Property<double>& c = getProperty_coefficients();
+	for(int t=0; t<nt; t++) {
+		const int* e = &_exponents[t*nc];
+		double term = c[t];
+		for(int j=0; j<nc; j++) term *= p[j][e[j]];
+		value += term;
+		if(rGradient) {
+			for(int j=0; j<nc; j++) {
+				if(e[j]==0) continue;
+				double dterm = c[t]*dp[j][e[j]];
+				for(int i=0; i<nc; i++)
+					if(i!=j) dterm *= p[i][e[i]];
+				rGradient[j] += dterm;
+			}
+		}
+	}
+	return value;
+}
+
+//_____________________________________________________________________________
+/**
+ * Length at the coordinate values q, with its gradient with respect to q.
+ */
+double PolynomialPathSurrogate::
+calcLength(const double* q, double* rGradient) const
+{
+	int nc = getNumCoordinates();
+	double x[MaxCoordinates], scale[MaxCoordinates];
+	for(int j=0; j<nc; j++) {
+		double lo = get_range_min(j), hi = get_range_max(j);
+		scale[j] = 2.0/(hi-lo);
+		x[j] = (q[j]-lo)*scale[j] - 1.0;
+	}
+	double length = calcPolynomial(x, rGradient);
+	if(rGradient)
+		for(int j=0; j<nc; j++) rGradient[j] *= scale[j];
+	return length;
+}
+
+//_____________________________________________________________________________
+/**
+ * Length given by the polynomial at the coordinate values in the state.
+ */
+double PolynomialPathSurrogate::calcLength(const State& s, double* rGradient) const
+{
+	int nc = getNumCoordinates();
+	double q[MaxCoordinates];
+	for(int j=0; j<nc; j++)
+		q[j] = _coordinates[j]->getValue(s);
+	return calcLength(q, rGradient);
+}
+
+//=============================================================================
+// FITTING
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Fit the coefficients to the geometric length of a path by least squares
+ * over a grid of samples of the coordinates.
+ */
+void PolynomialPathSurrogate::
+fit(const GeometryPath& aPath, State& s, int aNumSamples)
+{
+	if(aPath.hasSurrogate())
+		throw Exception("PolynomialPathSurrogate::fit: path "+aPath.getName()
+			+" already has a surrogate; fit to a path without one.",
+			__FILE__,__LINE__);
+	if(aNumSamples<=get_degree())
+		throw Exception("PolynomialPathSurrogate::fit: need more samples per "
+			"coordinate than the degree.",__FILE__,__LINE__);
+
+	const Model& model = aPath.getModel();
+	connectToModel(model);
+	int nc = getNumCoordinates();
+	int nt = getNumTerms();
+
+	// Ranges of the coordinates, if not given.
+	if(getProperty_range_min().size()!=nc || getProperty_range_max().size()!=nc) {
+		updProperty_range_min().clear();
+		updProperty_range_max().clear();
+		for(int j=0; j<nc; j++) {
+			updProperty_range_min().appendValue(_coordinates[j]->getRangeMin());
+			updProperty_range_max().appendValue(_coordinates[j]->getRangeMax());
+		}
+	}
+
+	// Sample the path on the grid.
+	int ns = 1;
+	for(int j=0; j<nc; j++) ns *= aNumSamples;
+	Matrix A(ns, nt);
+	Vector b(ns);
+	Vector savedQ = s.getQ();
+	double q[MaxCoordinates], x[MaxCoordinates];
+	int sample[MaxCoordinates] = {0};
+	for(int i=0; i<ns; i++) {
+		for(int j=0; j<nc; j++) {
+			x[j] = 2.0*sample[j]/(aNumSamples-1) - 1.0;
+			q[j] = get_range_min(j)
+				+ 0.5*(x[j]+1.0)*(get_range_max(j)-get_range_min(j));
+			_coordinates[j]->setValue(s, q[j], false);
+		}
+		model.getMultibodySystem().realize(s, SimTK::Stage::Position);
+		b[i] = aPath.getLength(s);
+
+		for(int t=0; t<nt; t++) {
+			double term = 1.0;
+			for(int j=0; j<nc; j++)
+				for(int k=0; k<_exponents[t*nc+j]; k++) term *= x[j];
+			A(i,t) = term;
+		}
+
+		// Next sample on the grid.
+		for(int j=0; j<nc && ++sample[j]==aNumSamples; j++)
+			sample[j] = 0;
+	}
+	s.updQ() = savedQ;
+	model.getMultibodySystem().realize(s, SimTK::Stage::Position);
+
+	Vector c;
+	SimTK::FactorQTZ qtz(A);
+	qtz.solve(b, c);
+
+	updProperty_coefficients().clear();
+	for(int t=0; t<nt; t++)
+		updProperty_coefficients().appendValue(c[t]);
+}
+
+//_____________________________________________________________________________
+/**
+ * Compare the polynomial with the geometric length of a path at points drawn
+ * at random within the fitted ranges.
+ */
+void PolynomialPathSurrogate::
+calcFitError(const GeometryPath& aPath, State& s, int aNumSamples,
+			 double& rMaxError, double& rRMSError) const
+{
+	if(aPath.hasSurrogate())
+		throw Exception("PolynomialPathSurrogate::calcFitError: path "
+			+aPath.getName()+" has a surrogate; compare with a path without one.",
+			__FILE__,__LINE__);
+	if(!isFitted() || (int)_coordinates.size()!=getNumCoordinates())
+		throw Exception("PolynomialPathSurrogate::calcFitError: "+getName()
+			+" has not been fitted.",__FILE__,__LINE__);
+
+	const Model& model = aPath.getModel();
+	int nc = getNumCoordinates();
+	SimTK::Random::Uniform random(0.0, 1.0);
+	random.setSeed(0);
+
+	rMaxError = 0.0;
+	double sumSquares = 0.0;
+	Vector savedQ = s.getQ();
+	double q[MaxCoordinates];
+	for(int i=0; i<aNumSamples; i++) {
+		for(int j=0; j<nc; j++) {
+			q[j] = get_range_min(j)
+				+ random.getValue()*(get_range_max(j)-get_range_min(j));
+			_coordinates[j]->setValue(s, q[j], false);
+		}
+		model.getMultibodySystem().realize(s, SimTK::Stage::Position);
+		double error = fabs(calcLength(q, NULL) - aPath.getLength(s));
+		rMaxError = max(rMaxError, error);
+		sumSquares += error*error;
+	}
+	s.updQ() = savedQ;
+	model.getMultibodySystem().realize(s, SimTK::Stage::Position);
+
+	rRMSError = aNumSamples>0 ? sqrt(sumSquares/aNumSamples) : 0.0;
+}
@@ -0,0 +1,178 @@
+#ifndef OPENSIM_POLYNOMIAL_PATH_SURROGATE_H_
+#define OPENSIM_POLYNOMIAL_PATH_SURROGATE_H_
+/* -------------------------------------------------------------------------- *
+ *                    OpenSim:  PolynomialPathSurrogate.h                     *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2012 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDE
+#include <OpenSim/Simulation/osimSimulationDLL.h>
+#include <OpenSim/Common/Object.h>
+#include <OpenSim/Common/Array.h>
+
+namespace OpenSim {
+
+class Model;
+class Coordinate;
+class GeometryPath;
+
+//==============================================================================
+//                         POLYNOMIAL PATH SURROGATE
+//==============================================================================
+/**
+ * A multivariate polynomial of the coordinates spanned by a GeometryPath that
+ * stands in for the length of the path. When a path has a surrogate and the
+ * coordinates are within the fitted ranges, the length, the lengthening
+ * speed and the forces of the path's tension are computed from the polynomial
+ * and its exact derivatives, and the path is not wrapped. Outside the fitted
+ * ranges the path is computed from its geometry.
+ *
+ * The polynomial is written in the coordinates scaled to [-1, 1] over their
+ * fitted ranges, and holds every term of total degree up to "degree", in
+ * graded lexicographic order of the exponents: 1, x0, x1, ..., x0^2, x0 x1,
+ * ... The coordinates are treated as independent; to represent a path
+ * crossing coordinates coupled by a constraint, list each of them.
+ *
+ * A surrogate is made by fit() from the geometric path, and its accuracy can
+ * be checked with calcFitError(), before it is given to the path with
+ * GeometryPath::setSurrogate():
+ * @code
+ * PolynomialPathSurrogate surrogate(coordinateNames, 4);
+ * surrogate.fit(muscle.getGeometryPath(), state, 9);
+ * surrogate.calcFitError(muscle.getGeometryPath(), state, 200, maxError, rmsError);
+ * muscle.updGeometryPath().setSurrogate(surrogate);
+ * model.initSystem();
+ * @endcode
+ * Only paths whose owner applies its tension with
+ * GeometryPath::addInEquivalentForces() (PathActuators, including muscles)
+ * have their forces follow the surrogate.
+ */
+class OSIMSIMULATION_API PolynomialPathSurrogate : public Object {
+OpenSim_DECLARE_CONCRETE_OBJECT(PolynomialPathSurrogate, Object);
+public:
+//==============================================================================
+// PROPERTIES
+//==============================================================================
+    /** @name Property declarations
+    These are the serializable properties associated with this class. **/
+    /**@{**/
+    OpenSim_DECLARE_LIST_PROPERTY(coordinates, std::string,
+        "Names of the coordinates spanned by the path, which are the variables "
+        "of the polynomial.");
+    OpenSim_DECLARE_LIST_PROPERTY(range_min, double,
+        "Lower end of the fitted range of each coordinate.");
+    OpenSim_DECLARE_LIST_PROPERTY(range_max, double,
+        "Upper end of the fitted range of each coordinate.");
+    OpenSim_DECLARE_PROPERTY(degree, int,
+        "Largest total degree of the terms of the polynomial.");
+    OpenSim_DECLARE_LIST_PROPERTY(coefficients, double,
+        "Coefficients of the terms, in graded lexicographic order of the "
+        "exponents of the coordinates scaled to [-1, 1] over their ranges.");
+    /**@}**/
+
+    /** Most coordinates and largest degree a surrogate can have. */
+    enum { MaxCoordinates = 6, MaxDegree = 8 };
+
+//==============================================================================
+// PUBLIC METHODS
+//==============================================================================
+    PolynomialPathSurrogate();
+    PolynomialPathSurrogate(const Array<std::string>& coordinateNames,
+                            int degree);
+
+    // Uses default (compiler-generated) destructor, copy constructor, and copy
+    // assignment operator.
+
+    int getNumCoordinates() const { return getProperty_coordinates().size(); }
+    /** Number of terms of a polynomial of the surrogate's degree in its
+    number of coordinates. */
+    int getNumTerms() const;
+    /** Whether there is a coefficient for every term and a range for every
+    coordinate. */
+    bool isFitted() const;
+
+    /** Look up the coordinates in the model. Called by the GeometryPath that
+    owns the surrogate when it is connected to its model. */
+    void connectToModel(const Model& aModel);
+
+    /** Index of aCoordinate among the surrogate's coordinates, or -1. */
+    int getCoordinateIndex(const Coordinate& aCoordinate) const;
+    /** The surrogate's coordinate with index aIndex, once connected. */
+    const Coordinate& getCoordinate(int aIndex) const;
+
+    /** Whether the surrogate is connected and fitted, and the values of all
+    its coordinates in the state are within their fitted ranges. */
+    bool isInRange(const SimTK::State& s) const;
+
+    /** Length of the path given by the polynomial in the state.
+    @param s            state holding the values of the coordinates
+    @param rGradient    if not NULL, set to the derivatives of the length with
+                        respect to each coordinate, in the order of the
+                        coordinates property. */
+    double calcLength(const SimTK::State& s, double* rGradient = NULL) const;
+
+    /** Fit the coefficients to the geometric length of a path. The path is
+    sampled on a grid of aNumSamples values of each coordinate, spread evenly
+    over its range, with the other coordinates at their values in the state,
+    and the coefficients are found by linear least squares. Coordinates
+    without a range are given the range of the Coordinate. The state is
+    restored when done.
+    @param aPath        the path, without a surrogate of its own
+    @param s            a state of the path's model
+    @param aNumSamples  samples per coordinate; more than the degree */
+    void fit(const GeometryPath& aPath, SimTK::State& s, int aNumSamples);
+
+    /** Compare the polynomial with the geometric length of a path at
+    aNumSamples points drawn at random within the fitted ranges. The state is
+    restored when done.
+    @param aPath        the path, without a surrogate of its own
+    @param s            a state of the path's model
+    @param aNumSamples  number of points to compare
+    @param rMaxError    largest absolute difference of the lengths
+    @param rRMSError    root mean square difference of the lengths */
+    void calcFitError(const GeometryPath& aPath, SimTK::State& s,
+                      int aNumSamples, double& rMaxError,
+                      double& rRMSError) const;
+
+private:
+    void constructProperties();
+    void updateExponents();
+    void checkSize() const;
+    // Value (and gradient) of the polynomial at scaled coordinates x.
+    double calcPolynomial(const double* x, double* rGradient) const;
+    // Length given by the polynomial at the coordinate values q.
+    double calcLength(const double* q, double* rGradient) const;
+
+    // Exponents of each coordinate in each term, one row of
+    // getNumCoordinates() per term.
+    SimTK::Array_<int> _exponents;
+
+    // The coordinates, looked up in the model by connectToModel(); copies
+    // must be connected again.
+    SimTK::Array_< SimTK::ReferencePtr<const Coordinate> > _coordinates;
+
+//==============================================================================
+};  // END of class PolynomialPathSurrogate
+//==============================================================================
+//==============================================================================
+
+} // end of namespace OpenSim
+
+#endif // OPENSIM_POLYNOMIAL_PATH_SURROGATE_H_
@@ -32,6 +32,54 @@ using namespace SimTK;
 
 namespace OpenSim {
 
+//______________________________________________________________________________
+/**
+ * Takes a workspace from the pool of a solver, or makes a new one, and
+ * returns it to the pool when it goes out of scope. The workspace state is
+ * (re)initialized as a copy of the state being solved whenever it was made
+ * for a different system topology.
+ */
+class MomentArmSolver::WorkspaceLease {
+public:
+	WorkspaceLease(const MomentArmSolver& solver, const State& state) :
+		_solver(solver)
+	{
+		{
+			std::lock_guard<std::mutex> lock(_solver._poolMutex);
+			if (!_solver._pool.empty()) {
+				_workspace = std::move(_solver._pool.back());
+				_solver._pool.pop_back();
+			}
+		}
+		if (!_workspace)
+			_workspace.reset(new Workspace());
+
+		State& s_ma = _workspace->state;
+		if (s_ma.getSystemStage() < SimTK::Stage::Model ||
+			s_ma.getSystemTopologyStageVersion() != 
+				state.getSystemTopologyStageVersion() ||
+			s_ma.getNQ() != state.getNQ() || s_ma.getNU() != state.getNU()) {
+			s_ma = state;
+			// Get the body forces equivalent of the point forces of the path
+			_workspace->bodyForces.resize(_solver.getModel().getNumBodies());
+			// get the right size coupling vector
+			_workspace->coupling.resize(s_ma.getNU());
+		}
+	}
+
+	~WorkspaceLease()
+	{
+		std::lock_guard<std::mutex> lock(_solver._poolMutex);
+		_solver._pool.push_back(std::move(_workspace));
+	}
+
+	Workspace& upd() { return *_workspace; }
+
+private:
+	const MomentArmSolver& _solver;
+	std::unique_ptr<Workspace> _workspace;
+};
+
 //______________________________________________________________________________
 /**
  * An implementation of the MomentArmSolver 
@@ -40,12 +88,18 @@ namespace OpenSim {
 MomentArmSolver::MomentArmSolver(const Model &model) : Solver(model)
 {
 	setAuthors("Ajay Seth");
-	_stateCopy = model.getWorkingState();
+}
 
-	// Get the body forces equivalent of the point forces of the path
-	_bodyForces = Vector_<SpatialVec>(getModel().getNumBodies(), SpatialVec(0));
-	// get the right size coupling vector
-	_coupling = _stateCopy.getU();
+MomentArmSolver::MomentArmSolver(const MomentArmSolver& aSolver) :
+	Solver(aSolver)
+{
+}
+
+MomentArmSolver& MomentArmSolver::operator=(const MomentArmSolver& aSolver)
+{
+	// The workspaces belong to the system of this solver's model; keep them.
+	Solver::operator=(aSolver);
+	return *this;
 }
 
 /*********************************************************************************
@@ -62,36 +116,41 @@ Refer to Moment-arm Theory document by Michael Sherman for details.
 double MomentArmSolver::solve(const State &state, const Coordinate &aCoord,
 							  const GeometryPath &path) const
 {
+	WorkspaceLease lease(*this, state);
+	Workspace& ws = lease.upd();
+
 	//Local modifiable copy of the state
-	State& s_ma = _stateCopy;
+	State& s_ma = ws.state;
 	s_ma.updQ() = state.getQ();
 
 	// compute the coupling between coordinates due to constraints
-	_coupling = computeCouplingVector(s_ma, aCoord);
+	computeCouplingVector(s_ma, aCoord, ws.coupling);
 
 	// set speeds to zero
 	s_ma.updU() = 0;
 
 	// zero out all the forces
-	_bodyForces *= 0;
-	_generalizedForces = 0;
+	ws.bodyForces = SpatialVec(Vec3(0), Vec3(0));
+	ws.generalizedForces = 0;
 
 	// apply a tension of unity to the bodies of the path
 	Vector pathDependentMobilityForces(s_ma.getNU(), 0.0);
-	path.addInEquivalentForces(s_ma, 1.0, _bodyForces, pathDependentMobilityForces);
+	path.addInEquivalentForces(s_ma, 1.0, ws.bodyForces, 
+		pathDependentMobilityForces);
 
 	//_bodyForces.dump("bodyForces from addInEquivalentForcesOnBodies");
 
 	// Convert body spatial forces F to equivalent mobility forces f based on 
     // geometry (no dynamics required): f = ~J(q) * F.
 	getModel().getMultibodySystem().getMatterSubsystem()
-        .multiplyBySystemJacobianTranspose(s_ma, _bodyForces, _generalizedForces);
+        .multiplyBySystemJacobianTranspose(s_ma, ws.bodyForces, 
+			ws.generalizedForces);
 
-	_generalizedForces += pathDependentMobilityForces;
+	ws.generalizedForces += pathDependentMobilityForces;
 	// Moment-arm is the effective torque (since tension is 1) at the 
     // coordinate of interest taking into account the generalized forces also 
     // acting on other coordinates that are coupled via constraint.
-	return ~_coupling*_generalizedForces;
+	return ~ws.coupling*ws.generalizedForces;
 }
 
 
@@ -100,24 +159,29 @@ double MomentArmSolver::solve(const State &state, const Coordinate &aCoord,
 							  const Array<PointForceDirection *> &pfds) const
 {
 	//const clock_t start = clock();
+	WorkspaceLease lease(*this, state);
+	Workspace& ws = lease.upd();
 
 	//Local modifiable copy of the state
-	State& s_ma = _stateCopy;
+	State& s_ma = ws.state;
 	s_ma.updQ() = state.getQ();
 
 	// compute the coupling between coordinates due to constraints
-	_coupling = computeCouplingVector(s_ma, aCoord);
+	computeCouplingVector(s_ma, aCoord, ws.coupling);
 
 	// set speeds to zero
 	s_ma.updU() = 0;
 
+	// zero out the forces left over from the previous solve
+	ws.bodyForces = SpatialVec(Vec3(0), Vec3(0));
+
 	int n = pfds.getSize();
 	// Apply body forces along the geometry described by pfds due to a tension of 1N
 	for(int i=0; i<n; i++) {
 		getModel().getMatterSubsystem().
 			addInStationForce(s_ma, 
 				SimTK::MobilizedBodyIndex(pfds[i]->body().getIndex()), 
-				pfds[i]->point(), pfds[i]->direction(), _bodyForces);
+				pfds[i]->point(), pfds[i]->direction(), ws.bodyForces);
 	}
 
 	//_bodyForces.dump("bodyForces from PointForceDirections");
@@ -125,16 +189,78 @@ double MomentArmSolver::solve(const State &state, const Coordinate &aCoord,
 	// Convert body spatial forces F to equivalent mobility forces f based on 
     // geometry (no dynamics required): f = ~J(q) * F.
 	getModel().getMultibodySystem().getMatterSubsystem()
-        .multiplyBySystemJacobianTranspose(s_ma, _bodyForces, _generalizedForces);
+        .multiplyBySystemJacobianTranspose(s_ma, ws.bodyForces, 
+			ws.generalizedForces);
 
 	// Moment-arm is the effective torque (since tension is 1) at the 
     // coordinate of interest taking into account the generalized forces also 
     // acting on other coordinates that are coupled via constraint.
-	return ~_coupling*_generalizedForces;
+	return ~ws.coupling*ws.generalizedForces;
+}
+
+void MomentArmSolver::solve(const State &state,
+		const SimTK::Array_<const Coordinate*> &coordinates,
+		const SimTK::Array_<const GeometryPath*> &paths,
+		SimTK::Matrix &momentArms) const
+{
+	int nc = coordinates.size();
+	int np = paths.size();
+	momentArms.resize(np, nc);
+	if(nc == 0 || np == 0) return;
+
+	WorkspaceLease lease(*this, state);
+	Workspace& ws = lease.upd();
+
+	//Local modifiable copy of the state
+	State& s_ma = ws.state;
+	s_ma.updQ() = state.getQ();
+	int nu = s_ma.getNU();
+
+	// unlock all the coordinates first so that each coupling vector sees
+	// the same constraints, whatever the order of the coordinates
+	getModel().getMultibodySystem().realize(s_ma, SimTK::Stage::Instance);
+	for(int j=0; j<nc; j++)
+		coordinates[j]->setLocked(s_ma, false);
+
+	// compute the coupling between coordinates due to constraints, once per
+	// coordinate: one column per coordinate
+	Matrix coupling(nu, nc);
+	for(int j=0; j<nc; j++) {
+		computeCouplingVector(s_ma, *coordinates[j], ws.coupling);
+		coupling(j) = ws.coupling;
+	}
+
+	// set speeds to zero
+	s_ma.updU() = 0;
+
+	// generalized forces due to a tension of unity along each path: one row
+	// per path
+	Matrix pathForces(np, nu);
+	Vector pathDependentMobilityForces(nu);
+	for(int i=0; i<np; i++) {
+		// zero out the forces left over from the previous path
+		ws.bodyForces = SpatialVec(Vec3(0), Vec3(0));
+		pathDependentMobilityForces = 0;
+
+		paths[i]->addInEquivalentForces(s_ma, 1.0, ws.bodyForces, 
+			pathDependentMobilityForces);
+
+		// f = ~J(q) * F, as in solve() for a single path
+		getModel().getMultibodySystem().getMatterSubsystem()
+			.multiplyBySystemJacobianTranspose(s_ma, ws.bodyForces, 
+				ws.generalizedForces);
+
+		ws.generalizedForces += pathDependentMobilityForces;
+		pathForces[i] = ~ws.generalizedForces;
+	}
+
+	// the moment-arm of path i about coordinate j is the effective torque of
+	// its unit tension taking into account the coupling of coordinate j
+	momentArms = pathForces*coupling;
 }
 
-SimTK::Vector MomentArmSolver::computeCouplingVector(SimTK::State &state, 
-		const Coordinate &coordinate) const
+void MomentArmSolver::computeCouplingVector(SimTK::State &state, 
+		const Coordinate &coordinate, SimTK::Vector& coupling) const
 {
 	// make sure copy of the state is realized to at least instance
 	getModel().getMultibodySystem().realize(state, SimTK::Stage::Instance);
@@ -155,7 +281,7 @@ SimTK::Vector MomentArmSolver::computeCouplingVector(SimTK::State &state,
 	
 	// Now calculate C. by checking how speeds of other coordinates change
 	// normalized by how much the speed of the coordinate of interest changed 
-    return state.getU() / coordinate.getSpeedValue(state);
+    coupling = state.getU() / coordinate.getSpeedValue(state);
 }
 
 } // end of namespace OpenSim
\ No newline at end of file
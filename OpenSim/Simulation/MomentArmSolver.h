@@ -24,6 +24,9 @@
  * -------------------------------------------------------------------------- */
 
 #include "Solver.h"
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace OpenSim {
 
@@ -59,8 +62,14 @@ private:
 	//--------------------------------------------------------------------------
 public:
 	explicit MomentArmSolver(const Model& model);
+	/** Copies share the model but not the workspaces. */
+	MomentArmSolver(const MomentArmSolver& aSolver);
 	virtual ~MomentArmSolver() {}
 
+#ifndef SWIG
+	MomentArmSolver& operator=(const MomentArmSolver& aSolver);
+#endif
+
 	/** Solve for the effective moment-arm about the all coordinates (q) based 
         on the geometric distribution of forces described by a GeometryPath. 
 	@param  state			    current state of the model
@@ -82,22 +91,44 @@ public:
 	double solve(const SimTK::State& state, const Coordinate &coordinate, 
 		const Array<PointForceDirection *> &pfds) const;
 
-private:
-	// Internal state of the solver initialized as a copy of the default state
-	mutable SimTK::State _stateCopy;
-
-	// Keep preallocated vector of the generalized forces
-	mutable SimTK::Vector _generalizedForces;
+	/** Solve for the moment-arms of several GeometryPaths about several
+		coordinates at once. The coupling of each coordinate to the others
+		through constraints is computed once per coordinate and the
+		generalized forces of each path once per path, so the cost grows
+		with the number of paths plus the number of coordinates rather than
+		with their product. Every coordinate is unlocked in the solver's copy
+		of the state before any coupling is computed.
+	@param  state			    current state of the model
+	@param  coordinates			Coordinates about which we want the moment-arms
+	@param  paths	            GeometryPaths for which to calculate moment-arms
+	@param  momentArms			resulting moment-arms, one row per path and one
+								column per coordinate
+	*/
+	void solve(const SimTK::State& state,
+		const SimTK::Array_<const Coordinate*> &coordinates,
+		const SimTK::Array_<const GeometryPath*> &paths,
+		SimTK::Matrix &momentArms) const;
 
-	// Keep preallocated vector of the Body_Forces
-	mutable SimTK::Vector_<SimTK::SpatialVec> _bodyForces;
+private:
+	// Scratch storage for one solve: a modifiable copy of the state and
+	// preallocated generalized forces, body forces and coupling factors.
+	struct Workspace {
+		SimTK::State state;
+		SimTK::Vector generalizedForces;
+		SimTK::Vector_<SimTK::SpatialVec> bodyForces;
+		SimTK::Vector coupling;
+	};
+	class WorkspaceLease;
 
-	// Keep preallocated vector of the coupling constraint factors
-	mutable SimTK::Vector _coupling;
+	// Workspaces not in use by a solve. Each solve takes one from the pool
+	// (or makes one) and returns it when done, so that solve() can be called
+	// on the same solver from several threads at once.
+	mutable std::mutex _poolMutex;
+	mutable std::vector<std::unique_ptr<Workspace> > _pool;
 
 	// compute vector of constraint coupling factors
-	SimTK::Vector computeCouplingVector(SimTK::State &state, 
-		const Coordinate &coordinate) const;
+	void computeCouplingVector(SimTK::State &state, 
+		const Coordinate &coordinate, SimTK::Vector& coupling) const;
 //=============================================================================
 };	// END of class MomentArmSolver
 //=============================================================================
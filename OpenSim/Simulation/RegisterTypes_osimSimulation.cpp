@@ -50,6 +50,7 @@
 #include "Model/ConditionalPathPoint.h"
 #include "Model/MovingPathPoint.h"
 #include "Model/GeometryPath.h"
+#include "Model/PolynomialPathSurrogate.h"
 #include "Model/PrescribedForce.h"
 #include "Model/ExternalForce.h"
 #include "Model/PointToPointSpring.h"
@@ -146,6 +147,7 @@ OSIMSIMULATION_API void RegisterTypes_osimSimulation()
     Object::registerType( ConditionalPathPoint() );
     Object::registerType( MovingPathPoint() );
     Object::registerType( GeometryPath() );
+    Object::registerType( PolynomialPathSurrogate() );
 
     Object::registerType( ControlSet() );
     Object::registerType( ControlConstant() );
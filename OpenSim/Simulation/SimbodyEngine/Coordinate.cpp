@@ -648,6 +648,17 @@ void Coordinate::CoordinateStateVariable::
 	((Coordinate *)&getOwner())->setValue(state, value);
 }
 
+SimTK::SystemYIndex Coordinate::CoordinateStateVariable::
+	calcSystemYIndex(const SimTK::State& state) const
+{
+	const Coordinate& owner = *((Coordinate *)&getOwner());
+	const MobilizedBody& mb = owner.getModel().getMatterSubsystem()
+								.getMobilizedBody(owner.getBodyIndex());
+	return SimTK::SystemYIndex(state.getQStart()
+		+ state.getQStart(getSubsysIndex()) + mb.getFirstQIndex(state)
+		+ owner.getMobilizerQIndex());
+}
+
 double Coordinate::CoordinateStateVariable::
 	getDerivative(const SimTK::State& state) const
 {
@@ -682,6 +693,17 @@ void Coordinate::SpeedStateVariable::
 	((Coordinate *)&getOwner())->setSpeedValue(state, deriv);
 }
 
+SimTK::SystemYIndex Coordinate::SpeedStateVariable::
+	calcSystemYIndex(const SimTK::State& state) const
+{
+	const Coordinate& owner = *((Coordinate *)&getOwner());
+	const MobilizedBody& mb = owner.getModel().getMatterSubsystem()
+								.getMobilizedBody(owner.getBodyIndex());
+	return SimTK::SystemYIndex(state.getUStart()
+		+ state.getUStart(getSubsysIndex()) + mb.getFirstUIndex(state)
+		+ owner.getMobilizerQIndex());
+}
+
 double Coordinate::SpeedStateVariable::
 	getDerivative(const SimTK::State& state) const
 {
@@ -254,6 +254,7 @@ private:
 		void setValue(SimTK::State& state, double value) const override;
 		double getDerivative(const SimTK::State& state) const override;
 		void setDerivative(const SimTK::State& state, double deriv) const override;
+		SimTK::SystemYIndex calcSystemYIndex(const SimTK::State& state) const override;
 	};
 
 	// Class for handling state variable added (allocated) by this Component
@@ -272,6 +273,7 @@ private:
 		void setValue(SimTK::State& state, double value) const override;
 		double getDerivative(const SimTK::State& state) const override;
 		void setDerivative(const SimTK::State& state, double deriv) const override;
+		SimTK::SystemYIndex calcSystemYIndex(const SimTK::State& state) const override;
 	};
 
 	// All coordinates (Simbody mobility) have associated constraints that
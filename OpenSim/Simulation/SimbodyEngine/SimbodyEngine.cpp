@@ -819,24 +819,20 @@ formCompleteStorages( const SimTK::State& s, const OpenSim::Storage &aQIn,
 
 	// Extract Coordinates
 	double time;
-	Array<double> data(0.0);
 	Array<double> q(0.0,nq);
 	Storage *qStore = new Storage();
 	qStore->setInDegrees(aQIn.isInDegrees());
 	qStore->setName("GeneralizedCoordinates");
 	qStore->setColumnLabels(columnLabels);
 	int size = aQIn.getSize();
-	StateVector *vector;
 	int j;
 	for(i=0;i<size;i++) {
-		vector = aQIn.getStateVector(i);
-		data = vector->getData();
-		time = vector->getTime();
+		aQIn.getTime(i,time);
 
 		for(j=0;j<nq;j++) {
 			q[j] = 0.0;
 			if(index[j]<0) continue;
-			q[j] = data[index[j]];
+			aQIn.getData(i,index[j],q[j]);
 		}
 
 		qStore->append(time,nq,&q[0]);
@@ -0,0 +1,161 @@
+/* -------------------------------------------------------------------------- *
+ *                       OpenSim:  testCacheVariables.cpp                     *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2012 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//============================================================================
+//	testCacheVariables checks that cache variables reached through a
+//  Component::CacheVariableHandle and through their names are the same
+//  entries, and times the cache accesses a realization of a 90-muscle model
+//  makes through either API.
+//============================================================================
+#include <OpenSim/Simulation/osimSimulation.h>
+#include <OpenSim/Actuators/Thelen2003Muscle.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace SimTK;
+using namespace std;
+
+// A chain of three pin-jointed links with muscles crossing one or more
+// joints, enough to exercise the per-muscle cache traffic of a full model.
+static Model* createModel(int aNumMuscles)
+{
+	Model* model = new Model();
+	model->setName("ninety_muscles");
+	model->setGravity(Vec3(0));
+
+	Body* parent = &model->updGroundBody();
+	Body* links[3];
+	for(int i=0; i<3; ++i) {
+		char name[16];
+		sprintf(name, "link%d", i);
+		links[i] = new OpenSim::Body(name, 1.0, Vec3(0),
+			Inertia::cylinderAlongY(0.05, 0.2));
+		PinJoint* pin = new PinJoint(string(name)+"_pin", *parent,
+			Vec3(0, (i==0) ? 0.0 : -0.4, 0), Vec3(0), *links[i],
+			Vec3(0), Vec3(0));
+		pin->upd_CoordinateSet()[0].setName(string(name)+"_q");
+		model->addBody(links[i]);
+		model->addJoint(pin);
+		parent = links[i];
+	}
+
+	for(int m=0; m<aNumMuscles; ++m) {
+		char name[16];
+		sprintf(name, "muscle%d", m);
+		Thelen2003Muscle* muscle = new Thelen2003Muscle(name, 500.0, 0.1,
+			0.2, 0.0);
+		double side = (m%2) ? 1.0 : -1.0;
+		Body& origin = (m%3==0) ? model->updGroundBody() : *links[m%3-1];
+		muscle->addNewPathPoint(string(name)+"_o", origin,
+			Vec3(0.04*side, -0.1-0.002*m, 0.01*(m%5)));
+		muscle->addNewPathPoint(string(name)+"_i", *links[2],
+			Vec3(0.03*side, -0.05-0.001*m, -0.01*(m%5)));
+		model->addForce(muscle);
+	}
+	return model;
+}
+
+// Read the cache variables a realization reads for every muscle.
+static double readByName(const Model& model, const State& s)
+{
+	double sum = 0;
+	const Set<Muscle>& muscles = model.getMuscles();
+	for(int i=0; i<muscles.getSize(); ++i) {
+		const GeometryPath& path = muscles[i].getGeometryPath();
+		if(path.isCacheVariableValid(s, "length"))
+			sum += path.getCacheVariable<double>(s, "length");
+		sum += path.getCacheVariable<Array<PathPoint*> >(s, "current_path")
+			.getSize();
+		if(muscles[i].isCacheVariableValid(s, "lengthInfo"))
+			sum += muscles[i].getCacheVariable<Muscle::MuscleLengthInfo>(
+				s, "lengthInfo").fiberLength;
+		sum += muscles[i].getCacheVariable<double>(s, "force");
+	}
+	return sum;
+}
+
+static double readByHandle(const Model& model, const State& s)
+{
+	double sum = 0;
+	const Set<Muscle>& muscles = model.getMuscles();
+	for(int i=0; i<muscles.getSize(); ++i) {
+		const GeometryPath& path = muscles[i].getGeometryPath();
+		sum += path.getLength(s);
+		sum += path.getCurrentPath(s).getSize();
+		sum += muscles[i].getFiberLength(s);
+		sum += muscles[i].getForce(s);
+	}
+	return sum;
+}
+
+int main()
+{
+	try {
+		Model* model = createModel(90);
+		State& s = model->initSystem();
+		model->equilibrateMuscles(s);
+		model->getMultibodySystem().realize(s, Stage::Dynamics);
+
+		// Both APIs read the same entries.
+		double byName = readByName(*model, s);
+		double byHandle = readByHandle(*model, s);
+		ASSERT_EQUAL(byName, byHandle, 1e-12*fabs(byName));
+
+		// A handle keeps working after the system is rebuilt.
+		State& s2 = model->initSystem();
+		model->getMultibodySystem().realize(s2, Stage::Dynamics);
+		ASSERT_EQUAL(readByName(*model, s2), readByHandle(*model, s2),
+			1e-12*fabs(byName));
+
+		// Cache traffic of one realization, repeated.
+		const int n = 20000;
+		double sum = 0, start = realTime();
+		for(int i=0; i<n; ++i) sum += readByName(*model, s2);
+		double nameTime = realTime() - start;
+		start = realTime();
+		for(int i=0; i<n; ++i) sum += readByHandle(*model, s2);
+		double handleTime = realTime() - start;
+		cout << "Cache reads of " << model->getMuscles().getSize()
+			<< " muscles per realization: by name " << 1e6*nameTime/n
+			<< "us, by handle " << 1e6*handleTime/n << "us (" << sum << ")"
+			<< endl;
+
+		// Realizations in which every cache entry is recomputed.
+		start = realTime();
+		for(int i=0; i<2000; ++i) {
+			s2.updQ()[0] = 0.001*(i%100);
+			model->getMultibodySystem().realize(s2, Stage::Dynamics);
+			for(int m=0; m<model->getMuscles().getSize(); ++m)
+				sum += model->getMuscles()[m].getFiberLength(s2);
+		}
+		cout << "Realization to Dynamics with fiber lengths: "
+			<< 1e6*(realTime()-start)/2000 << "us" << endl;
+
+		delete model;
+	}
+	catch (const Exception& e) {
+		e.print(cerr);
+		return 1;
+	}
+	cout << "Done" << endl;
+	return 0;
+}
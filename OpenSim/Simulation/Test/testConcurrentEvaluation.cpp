@@ -0,0 +1,234 @@
+/* -------------------------------------------------------------------------- *
+ *                   OpenSim:  testConcurrentEvaluation.cpp                   *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2012 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//============================================================================
+//	testConcurrentEvaluation evaluates one const Model with many States from
+//  several threads at once: path lengths, lengthening speeds, moment arms
+//  and muscle forces, for a model with wrapping (arm26) and one with moving
+//  path points (gait2354). The results must match those of evaluating the
+//  same States one at a time on a single thread. Then it checks that a Model
+//  computing its muscles on several threads within each realization
+//  (num_threads) gives exactly the results of one that does not.
+//============================================================================
+#include <OpenSim/Simulation/osimSimulation.h>
+#include <OpenSim/Common/LoadOpenSimLibrary.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+#include <thread>
+
+using namespace OpenSim;
+using namespace SimTK;
+using namespace std;
+
+static const int NumStates = 12;
+static const int NumThreads = 4;
+static const int NumRounds = 3;
+
+// Everything computed for one state, in a fixed order.
+static Vector evaluate(const Model& model, const State& defaultState,
+	const Vector& q, const Vector& u)
+{
+	State s(defaultState);
+	s.updQ() = q;
+	s.updU() = u;
+	model.getMultibodySystem().realize(s, Stage::Dynamics);
+
+	const Set<Muscle>& muscles = model.getMuscles();
+	const CoordinateSet& coords = model.getCoordinateSet();
+	Vector values(muscles.getSize()*(3 + coords.getSize()));
+	int k = 0;
+	for(int i=0; i<muscles.getSize(); ++i) {
+		const GeometryPath& path = muscles[i].getGeometryPath();
+		values[k++] = path.getLength(s);
+		values[k++] = path.getLengtheningSpeed(s);
+		values[k++] = muscles[i].getForce(s);
+		for(int j=0; j<coords.getSize(); ++j)
+			values[k++] = path.computeMomentArm(s, coords[j]);
+	}
+	return values;
+}
+
+static void testConcurrentEvaluation(const string& modelFile)
+{
+	cout << "Evaluating " << modelFile << " from " << NumThreads
+		<< " threads" << endl;
+
+	Model model(modelFile);
+	State& defaultState = model.initSystem();
+	model.getMultibodySystem().realize(defaultState, Stage::Position);
+	const Model& constModel = model;
+
+	// States spread over the ranges of the coordinates.
+	Random::Uniform random(0, 1);
+	random.setSeed(12345);
+	vector<Vector> qs, us;
+	for(int n=0; n<NumStates; ++n) {
+		State s(defaultState);
+		const CoordinateSet& coords = model.getCoordinateSet();
+		for(int j=0; j<coords.getSize(); ++j) {
+			const Coordinate& c = coords[j];
+			if(c.getLocked(s)) continue;
+			c.setValue(s, c.getRangeMin()
+				+ random.getValue()*(c.getRangeMax()-c.getRangeMin()), false);
+			c.setSpeedValue(s, 2*random.getValue() - 1);
+		}
+		qs.push_back(s.getQ());
+		us.push_back(s.getU());
+	}
+
+	// Single-threaded reference.
+	double start = realTime();
+	vector<Vector> reference;
+	for(int n=0; n<NumStates; ++n)
+		reference.push_back(evaluate(constModel, defaultState, qs[n], us[n]));
+	double serialTime = realTime() - start;
+
+	// Every thread evaluates every state, each starting at a different one.
+	vector< vector<Vector> > results(NumThreads,
+		vector<Vector>(NumRounds*NumStates));
+	vector<string> errors(NumThreads);
+	vector<std::thread> threads;
+	start = realTime();
+	for(int t=0; t<NumThreads; ++t) {
+		threads.push_back(std::thread([&, t]() {
+			try {
+				for(int r=0; r<NumRounds*NumStates; ++r) {
+					int n = (r + 5*t) % NumStates;
+					results[t][r] = evaluate(constModel, defaultState,
+						qs[n], us[n]);
+				}
+			}
+			catch (const std::exception& e) {
+				errors[t] = e.what();
+			}
+		}));
+	}
+	for(int t=0; t<NumThreads; ++t)
+		threads[t].join();
+	double threadedTime = realTime() - start;
+
+	cout << "  " << NumStates << " states on one thread: " << serialTime
+		<< "s; " << NumThreads*NumRounds*NumStates << " on " << NumThreads
+		<< " threads: " << threadedTime << "s" << endl;
+
+	for(int t=0; t<NumThreads; ++t) {
+		if(!errors[t].empty())
+			throw Exception("Thread failed: " + errors[t], __FILE__, __LINE__);
+		for(int r=0; r<NumRounds*NumStates; ++r) {
+			const Vector& expected = reference[(r + 5*t) % NumStates];
+			const Vector& actual = results[t][r];
+			ASSERT(actual.size() == expected.size());
+			for(int i=0; i<expected.size(); ++i) {
+				if(isNaN(expected[i])) {
+					ASSERT(isNaN(actual[i]));
+					continue;
+				}
+				// Wrapping starts from the previous wrap in the state, so
+				// iterative wrap solutions may differ slightly.
+				ASSERT_EQUAL(expected[i], actual[i],
+					1e-6*(1 + fabs(expected[i])), __FILE__, __LINE__,
+					"Threaded evaluation differs from serial evaluation.");
+			}
+		}
+	}
+}
+
+// Accelerations and muscle forces of one state.
+static Vector evaluateDynamics(const Model& model, const State& defaultState,
+	const Vector& q, const Vector& u)
+{
+	State s(defaultState);
+	s.updQ() = q;
+	s.updU() = u;
+	model.getMultibodySystem().realize(s, Stage::Acceleration);
+
+	const Set<Muscle>& muscles = model.getMuscles();
+	Vector values(s.getNU() + muscles.getSize());
+	values(0, s.getNU()) = s.getUDot();
+	for(int i=0; i<muscles.getSize(); ++i)
+		values[s.getNU() + i] = muscles[i].getForce(s);
+	return values;
+}
+
+static void testParallelMuscleEvaluation(const string& modelFile)
+{
+	cout << "Computing the muscles of " << modelFile << " on " << NumThreads
+		<< " threads within each realization" << endl;
+
+	Model serialModel(modelFile);
+	State& serialState = serialModel.initSystem();
+	Model parallelModel(modelFile);
+	parallelModel.set_num_threads(NumThreads);
+	State& parallelState = parallelModel.initSystem();
+
+	Random::Uniform random(0, 1);
+	random.setSeed(54321);
+	double serialTime = 0, parallelTime = 0;
+	for(int n=0; n<NumStates; ++n) {
+		State s(serialState);
+		const CoordinateSet& coords = serialModel.getCoordinateSet();
+		for(int j=0; j<coords.getSize(); ++j) {
+			const Coordinate& c = coords[j];
+			if(c.getLocked(s)) continue;
+			c.setValue(s, c.getRangeMin()
+				+ random.getValue()*(c.getRangeMax()-c.getRangeMin()), false);
+			c.setSpeedValue(s, 2*random.getValue() - 1);
+		}
+
+		double start = realTime();
+		Vector expected = evaluateDynamics(serialModel, serialState,
+			s.getQ(), s.getU());
+		serialTime += realTime() - start;
+
+		start = realTime();
+		Vector actual = evaluateDynamics(parallelModel, parallelState,
+			s.getQ(), s.getU());
+		parallelTime += realTime() - start;
+
+		// Forces are summed in the same order, so the results are identical.
+		ASSERT(actual.size() == expected.size());
+		for(int i=0; i<expected.size(); ++i)
+			ASSERT(actual[i] == expected[i]
+				|| (isNaN(actual[i]) && isNaN(expected[i])), __FILE__, __LINE__,
+				"Parallel muscle evaluation differs from serial evaluation.");
+	}
+
+	cout << "  " << NumStates << " states on one thread: " << serialTime
+		<< "s; on " << NumThreads << " threads: " << parallelTime << "s"
+		<< endl;
+}
+
+int main()
+{
+	try {
+		LoadOpenSimLibrary("osimActuators");
+		testConcurrentEvaluation("arm26.osim");
+		testConcurrentEvaluation("gait2354_simbody.osim");
+		testParallelMuscleEvaluation("arm26.osim");
+		testParallelMuscleEvaluation("gait2354_simbody.osim");
+	}
+	catch (const Exception& e) {
+		e.print(cerr);
+		return 1;
+	}
+	cout << "Done" << endl;
+	return 0;
+}
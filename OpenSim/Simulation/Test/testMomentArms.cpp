@@ -50,6 +50,8 @@ void testMomentArmDefinitionForModel(const string &filename,
 									 SimTK::Vec2 rom = SimTK::Vec2(-SimTK::Pi/2,0),
 									 double mass = -1.0, string errorMessage = "");
 
+void testMomentArmMatrixForModel(const string &filename);
+
 int main()
 {
 	clock_t startTime = clock();
@@ -118,6 +120,12 @@ int main()
 
 		testMomentArmDefinitionForModel("CoupledCoordinatesMPPsMomentArmTest.osim", "foot_angle", "vas_int_r", SimTK::Vec2(-2*SimTK::Pi/3, SimTK::Pi/18), -1.0, "Multiple moving path points: FAILED");
 		cout << "Multiple moving path points coupled coordinates test: PASSED\n" << endl;
+
+		testMomentArmMatrixForModel("gait2354_simbody.osim");
+		cout << "Moment-arm matrix of gait2354: PASSED\n" << endl;
+
+		testMomentArmMatrixForModel("testMomentArmsConstraintB.osim");
+		cout << "Moment-arm matrix with patella constraints: PASSED\n" << endl;
 	}
 	catch (const Exception& e) {
         e.print(cerr);
@@ -405,3 +413,45 @@ void testMomentArmDefinitionForModel(const string &filename, const string &coord
 	// dL/dTheta definition or is at least dynamically consistent, in which dL/dTheta is not
 	ASSERT(passesDefinition || passesDynamicConsistency, __FILE__, __LINE__, errorMessage);
 }
+
+//==========================================================================================================
+// The moment-arm matrix solved in one pass must match solving one path and coordinate at a time
+//==========================================================================================================
+void testMomentArmMatrixForModel(const string &filename)
+{
+	Model osimModel(filename);
+	SimTK::State &s = osimModel.initSystem();
+
+	const CoordinateSet &coords = osimModel.getCoordinateSet();
+	const Set<Muscle> &muscles = osimModel.getMuscles();
+
+	// Move every unlocked coordinate away from its default
+	SimTK::Array_<const Coordinate*> coordinates;
+	for(int i=0; i<coords.getSize(); i++) {
+		if(coords[i].getLocked(s)) continue;
+		coords[i].setValue(s, coords[i].getDefaultValue() + 0.1*(i%3+1), false);
+		coordinates.push_back(&coords[i]);
+	}
+	osimModel.assemble(s);
+	osimModel.getMultibodySystem().realize(s, SimTK::Stage::Velocity);
+	SimTK::Array_<const GeometryPath*> paths;
+	for(int i=0; i<muscles.getSize(); i++)
+		paths.push_back(&muscles[i].getGeometryPath());
+
+	MomentArmSolver matrixSolver(osimModel);
+	SimTK::Matrix momentArms;
+	matrixSolver.solve(s, coordinates, paths, momentArms);
+	ASSERT(momentArms.nrow() == (int)paths.size() && 
+		momentArms.ncol() == (int)coordinates.size(), __FILE__, __LINE__,
+		"Moment-arm matrix has the wrong size.");
+
+	MomentArmSolver maSolver(osimModel);
+	for(unsigned int j=0; j<coordinates.size(); j++) {
+		for(unsigned int i=0; i<paths.size(); i++) {
+			double ma = maSolver.solve(s, *coordinates[j], *paths[i]);
+			ASSERT_EQUAL(ma, momentArms(i,j), 1.0e-10, __FILE__, __LINE__,
+				"Moment-arm of " + muscles[i].getName() + " about " +
+				coordinates[j]->getName() + " differs from the matrix.");
+		}
+	}
+}
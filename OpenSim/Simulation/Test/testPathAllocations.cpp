@@ -0,0 +1,132 @@
+/* -------------------------------------------------------------------------- *
+ *                     OpenSim:  testPathAllocations.cpp                      *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2012 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//============================================================================
+//	testPathAllocations counts the heap allocations made while the muscle
+//  paths of a model are recomputed, for a model with wrapping (arm26) and
+//  one with moving and conditional path points (gait2354). The paths are
+//  evaluated over a sweep of poses once, so that the scratch kept in the
+//  state can grow to fit; evaluating the same sweep again must then not
+//  allocate at all.
+//============================================================================
+#include <OpenSim/Simulation/osimSimulation.h>
+#include <OpenSim/Common/LoadOpenSimLibrary.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+#include <cstdlib>
+#include <new>
+
+using namespace OpenSim;
+using namespace SimTK;
+using namespace std;
+
+// Global operator new is replaced so that the allocations made while
+// countAllocations is set are counted. Only this (single) thread sets it.
+static bool countAllocations = false;
+static long numAllocations = 0;
+
+void* operator new(std::size_t size)
+{
+	if (countAllocations) ++numAllocations;
+	void* p = std::malloc(size ? size : 1);
+	if (!p) throw std::bad_alloc();
+	return p;
+}
+
+void operator delete(void* p) throw()
+{
+	std::free(p);
+}
+
+static const int NumPoses = 50;
+
+// Set every unlocked coordinate to pose k of a sweep through its range.
+static void setPose(const Model& model, State& s, int k)
+{
+	const CoordinateSet& coords = model.getCoordinateSet();
+	for (int c = 0; c < coords.getSize(); ++c) {
+		const Coordinate& coord = coords[c];
+		if (coord.getLocked(s)) continue;
+		const double phase = 2*Pi*k/NumPoses + c;
+		const double mid = 0.5*(coord.getRangeMin() + coord.getRangeMax());
+		const double half = 0.5*(coord.getRangeMax() - coord.getRangeMin());
+		coord.setValue(s, mid + half*std::sin(phase), false);
+		coord.setSpeedValue(s, half*std::cos(phase));
+	}
+	model.getMultibodySystem().realize(s, Stage::Velocity);
+}
+
+// Evaluate the lengths and lengthening speeds of all the muscle paths over
+// the sweep, and return the allocations made by the paths.
+static long evaluatePaths(const Model& model, State& s, double& rTotal)
+{
+	const Set<Muscle>& muscles = model.getMuscles();
+	long count = 0;
+	rTotal = 0.0;
+	for (int k = 0; k < NumPoses; ++k) {
+		setPose(model, s, k);
+
+		numAllocations = 0;
+		countAllocations = true;
+		for (int i = 0; i < muscles.getSize(); ++i) {
+			const GeometryPath& path = muscles[i].getGeometryPath();
+			rTotal += path.getLength(s);
+			rTotal += path.getLengtheningSpeed(s);
+		}
+		countAllocations = false;
+		count += numAllocations;
+	}
+	return count;
+}
+
+void testPathAllocations(const string& modelFile)
+{
+	Model model(modelFile);
+	State& s = model.initSystem();
+
+	// The first sweep makes the state's copies of the paths and grows their
+	// scratch to fit the largest wraps.
+	double firstTotal, secondTotal;
+	long first = evaluatePaths(model, s, firstTotal);
+	long second = evaluatePaths(model, s, secondTotal);
+	cout << modelFile << ": " << first << " allocations in the first sweep, "
+		<< second << " in the second." << endl;
+
+	ASSERT_EQUAL(firstTotal, secondTotal, 1.0e-6*std::abs(firstTotal),
+		__FILE__, __LINE__, "Paths differ between sweeps over the same poses.");
+	ASSERT(second == 0, __FILE__, __LINE__,
+		"Recomputing the paths allocated memory.");
+}
+
+int main()
+{
+	try {
+		LoadOpenSimLibrary("osimActuators");
+		testPathAllocations("arm26.osim");
+		testPathAllocations("gait2354_simbody.osim");
+	}
+	catch (const Exception& e) {
+		e.print(cerr);
+		return 1;
+	}
+	cout << "Done" << endl;
+	return 0;
+}
@@ -0,0 +1,151 @@
+/* -------------------------------------------------------------------------- *
+ *                 OpenSim:  testPolynomialPathSurrogate.cpp                  *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2012 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//============================================================================
+//	testPolynomialPathSurrogate fits a polynomial surrogate to the length of
+//  a wrapping muscle path of arm26 and checks that, within the fitted
+//  ranges, the path's length follows the geometry to within the fit error,
+//  and its lengthening speed and moment arms are the exact derivatives of
+//  the polynomial. Outside the ranges the geometric path must be used.
+//============================================================================
+#include <OpenSim/Simulation/osimSimulation.h>
+#include <OpenSim/Common/LoadOpenSimLibrary.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace SimTK;
+using namespace std;
+
+static const string MuscleName = "TRIlong";
+
+// Set the two coordinates of arm26 and realize to Velocity.
+static void setPose(const Model& model, State& s, double shoulder,
+	double elbow, double shoulderSpeed, double elbowSpeed)
+{
+	const CoordinateSet& coords = model.getCoordinateSet();
+	coords.get("r_shoulder_elev").setValue(s, shoulder, false);
+	coords.get("r_elbow_flex").setValue(s, elbow, false);
+	coords.get("r_shoulder_elev").setSpeedValue(s, shoulderSpeed);
+	coords.get("r_elbow_flex").setSpeedValue(s, elbowSpeed);
+	model.getMultibodySystem().realize(s, Stage::Velocity);
+}
+
+void testPolynomialPathSurrogate()
+{
+	// The geometric model, used to fit the surrogate and for reference.
+	Model geometric("arm26.osim");
+	State& sg = geometric.initSystem();
+	const GeometryPath& geometricPath =
+		geometric.getMuscles().get(MuscleName).getGeometryPath();
+
+	Array<string> coordNames;
+	coordNames.append("r_shoulder_elev");
+	coordNames.append("r_elbow_flex");
+	PolynomialPathSurrogate surrogate(coordNames, 5);
+	surrogate.updProperty_range_min().appendValue(0.0);
+	surrogate.updProperty_range_min().appendValue(0.2);
+	surrogate.updProperty_range_max().appendValue(1.2);
+	surrogate.updProperty_range_max().appendValue(2.0);
+	surrogate.fit(geometricPath, sg, 11);
+	ASSERT(surrogate.isFitted(), __FILE__, __LINE__, "Surrogate was not fitted.");
+	ASSERT(surrogate.getProperty_coefficients().size() == 21, __FILE__, __LINE__,
+		"Degree 5 in 2 coordinates should have 21 terms.");
+
+	double maxError, rmsError;
+	surrogate.calcFitError(geometricPath, sg, 200, maxError, rmsError);
+	cout << MuscleName << " surrogate fit error: max = " << maxError
+		<< " rms = " << rmsError << endl;
+	ASSERT(maxError < 5.0e-3, __FILE__, __LINE__,
+		"Surrogate does not fit the path length.");
+	ASSERT(rmsError <= maxError, __FILE__, __LINE__);
+
+	// The model with the surrogate.
+	Model model("arm26.osim");
+	model.updMuscles().get(MuscleName).updGeometryPath().setSurrogate(surrogate);
+	State& s = model.initSystem();
+	const GeometryPath& path = model.getMuscles().get(MuscleName).getGeometryPath();
+	const Coordinate& shoulder = model.getCoordinateSet().get("r_shoulder_elev");
+	const Coordinate& elbow = model.getCoordinateSet().get("r_elbow_flex");
+	MomentArmSolver maSolver(model);
+
+	const double poses[][2] = { {0.3, 0.5}, {0.9, 1.1}, {0.1, 1.9} };
+	const double dq = 1.0e-6;
+	for (int p = 0; p < 3; ++p) {
+		setPose(model, s, poses[p][0], poses[p][1], 0.7, -1.3);
+		setPose(geometric, sg, poses[p][0], poses[p][1], 0.7, -1.3);
+
+		// Length follows the geometry to within the fit error.
+		double length = path.getLength(s);
+		ASSERT_EQUAL(geometricPath.getLength(sg), length, maxError,
+			__FILE__, __LINE__, "Surrogate length differs from the path.");
+
+		// Speed and moment arms are the derivatives of the polynomial.
+		State sp(s), sm(s);
+		setPose(model, sp, poses[p][0]+0.7*dq, poses[p][1]-1.3*dq, 0, 0);
+		setPose(model, sm, poses[p][0]-0.7*dq, poses[p][1]+1.3*dq, 0, 0);
+		double speed = (path.getLength(sp) - path.getLength(sm))/(2*dq);
+		ASSERT_EQUAL(speed, path.getLengtheningSpeed(s), 1.0e-6,
+			__FILE__, __LINE__, "Surrogate speed is not dL/dt.");
+
+		setPose(model, sp, poses[p][0], poses[p][1]+dq, 0, 0);
+		setPose(model, sm, poses[p][0], poses[p][1]-dq, 0, 0);
+		double momentArm = -(path.getLength(sp) - path.getLength(sm))/(2*dq);
+		ASSERT_EQUAL(momentArm, path.computeMomentArm(s, elbow), 1.0e-6,
+			__FILE__, __LINE__, "Surrogate moment arm is not -dL/dq.");
+
+		// The forces of the path's tension agree with the moment arms.
+		ASSERT_EQUAL(path.computeMomentArm(s, shoulder),
+			maSolver.solve(s, shoulder, path), 1.0e-10, __FILE__, __LINE__,
+			"Surrogate forces do not agree with its moment arm.");
+	}
+
+	// Outside the fitted range the path is computed from its geometry.
+	setPose(model, s, 1.5, 1.0, 0.7, -1.3);
+	setPose(geometric, sg, 1.5, 1.0, 0.7, -1.3);
+	ASSERT_EQUAL(geometricPath.getLength(sg), path.getLength(s), 1.0e-12,
+		__FILE__, __LINE__, "Path out of range did not use its geometry.");
+	ASSERT_EQUAL(geometricPath.getLengtheningSpeed(sg),
+		path.getLengtheningSpeed(s), 1.0e-12, __FILE__, __LINE__,
+		"Path out of range did not use its geometry.");
+
+	// The surrogate is kept with the model.
+	model.print("arm26_surrogate.osim");
+	Model reloaded("arm26_surrogate.osim");
+	const GeometryPath& reloadedPath =
+		reloaded.getMuscles().get(MuscleName).getGeometryPath();
+	ASSERT(reloadedPath.hasSurrogate() && reloadedPath.getSurrogate().isFitted(),
+		__FILE__, __LINE__, "Surrogate was not serialized.");
+}
+
+int main()
+{
+	try {
+		LoadOpenSimLibrary("osimActuators");
+		testPolynomialPathSurrogate();
+	}
+	catch (const Exception& e) {
+		e.print(cerr);
+		return 1;
+	}
+	cout << "Done" << endl;
+	return 0;
+}
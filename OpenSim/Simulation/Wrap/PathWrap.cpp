@@ -89,8 +89,6 @@ PathWrap::PathWrap(const PathWrap& aPathWrap) :
 void PathWrap::setNull()
 {
 	_method = hybrid;
-
-	resetPreviousWrap();
 }
 
 //_____________________________________________________________________________
@@ -172,7 +170,6 @@ void PathWrap::copyData(const PathWrap& aPathWrap)
 	_method = aPathWrap._method;
 	_range = aPathWrap._range;
 	_wrapObject = aPathWrap._wrapObject;
-	_previousWrap = aPathWrap._previousWrap;
 
 	_wrapPoints[0] = aPathWrap._wrapPoints[0];
 	_wrapPoints[1] = aPathWrap._wrapPoints[1];
@@ -226,25 +223,9 @@ void PathWrap::setEndPoint( const SimTK::State& s, int aIndex)
 	}
 }
 
-void PathWrap::resetPreviousWrap()
-{
-	_previousWrap.startPoint = -1;
-	_previousWrap.endPoint = -1;
-
-	_previousWrap.wrap_pts.setSize(0);
-	_previousWrap.wrap_path_length = 0.0;
-
-	int i;
-	for (i = 0; i < 3; i++) {
-		_previousWrap.r1[i] = -std::numeric_limits<SimTK::Real>::infinity();
-		_previousWrap.r2[i] = -std::numeric_limits<SimTK::Real>::infinity();
-		_previousWrap.sv[i] = -std::numeric_limits<SimTK::Real>::infinity();
-	}
-}
-
-void PathWrap::setPreviousWrap(const WrapResult& aWrapResult)
+const WrapResult& PathWrap::getPreviousWrap(const SimTK::State& s) const
 {
-	_previousWrap = aWrapResult;
+	return _path->getPreviousWrap(s, *this);
 }
 
 void PathWrap::setWrapObject(WrapObject& aWrapObject)
@@ -86,9 +86,9 @@ protected:
 	const WrapObject* _wrapObject;
 	GeometryPath* _path;
 
-	WrapResult _previousWrap;  // results from previous wrapping
-
-    PathWrapPoint _wrapPoints[2]; // the two muscle points created when the muscle wraps
+    // The two muscle points created when the muscle wraps. GeometryPath
+    // copies them into each State, where the wrapping results are stored.
+    PathWrapPoint _wrapPoints[2];
 
 //=============================================================================
 // METHODS
@@ -119,9 +119,9 @@ public:
 	const std::string& getMethodName() const { return _methodName; }
 	GeometryPath* getPath() const { return _path; }
 
-	const WrapResult& getPreviousWrap() const { return _previousWrap; }
-	void setPreviousWrap(const WrapResult& aWrapResult);
-	void resetPreviousWrap();
+	/** Results of the last wrapping of the path over the wrap object in
+	this State, used to start the next wrapping calculation. */
+	const WrapResult& getPreviousWrap(const SimTK::State& s) const;
 
 protected:
 	void setupProperties();
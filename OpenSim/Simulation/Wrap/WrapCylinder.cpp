@@ -264,7 +264,7 @@ int WrapCylinder::wrapLine(const SimTK::State& s, SimTK::Vec3& aPoint1, SimTK::V
 	// In case you need any variables from the previous wrap, copy them from
 	// the PathWrap into the WrapResult, re-normalizing the ones that were
 	// un-normalized at the end of the previous wrap calculation.
-	const WrapResult& previousWrap = aPathWrap.getPreviousWrap();
+	const WrapResult& previousWrap = aPathWrap.getPreviousWrap(s);
 	aWrapResult.factor = previousWrap.factor;
 	for (i = 0; i < 3; i++)
 	{
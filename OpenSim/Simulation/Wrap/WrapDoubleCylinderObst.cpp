@@ -31,6 +31,7 @@
 #include <OpenSim/Common/SimmMacros.h>
 #include <OpenSim/Common/Mtx.h>
 #include <sstream>
+#include <vector>
 
 //=============================================================================
 // STATICS
@@ -406,19 +407,16 @@ static int load_Rxyz(double q[3],double Rxyz[9]) {
 /*====== SOLVE THE SYSTEM OF LINEAR EQUATIONS:  A(NxN)*X(Nx1)=B(Nx1) ========*/
 /*===========================================================================*/
 static int quick_solve_linear(int N,double A[],double X[],double B[]) {
-	static double *MTX=NULL,**Mtx=NULL;
-	static int mtxsize=0;
 	double **Mr,*Mrj,*Mij,*Xr,*Br,d;
 	int r,i,j,n;
 
 	/*====================================================================*/
 	/*======= ALLOCATE STORAGE FOR DUPLICATE OF A AND ROW POINTERS =======*/
 	/*====================================================================*/
-	if(mtxsize<N*(N+1)) {	mtxsize=N*(N+1);
-		MTX=(double *)  malloc(mtxsize*sizeof(double));
-		Mtx=(double **) malloc(N*sizeof(double *));
-		if(Mtx==NULL) { fprintf(stderr,"\nOut of memory.\n\n"); exit(0); }
-	}
+	// Local rather than static so that paths can be wrapped concurrently.
+	std::vector<double> mtxStorage(N*(N+1));
+	std::vector<double*> rowStorage(N);
+	double *MTX=&mtxStorage[0],**Mtx=&rowStorage[0];
 	/*====================================================================*/
 
 	/*====================================================================*/
@@ -263,7 +263,7 @@ int WrapEllipsoid::wrapLine(const SimTK::State& s, SimTK::Vec3& aPoint1, SimTK::
 	// In case you need any variables from the previous wrap, copy them from
 	// the PathWrap into the WrapResult, re-normalizing the ones that were
 	// un-normalized at the end of the previous wrap calculation.
-	const WrapResult& previousWrap = aPathWrap.getPreviousWrap();
+	const WrapResult& previousWrap = aPathWrap.getPreviousWrap(s);
 	aWrapResult.factor = previousWrap.factor;
 	for (i = 0; i < 3; i++)
 	{
@@ -601,9 +601,41 @@ int WrapEllipsoid::wrapLine(const SimTK::State& s, SimTK::Vec3& aPoint1, SimTK::
 
 	vs4 = - Mtx::DotProduct(3, vs, aWrapResult.c1);
 
-	// find r1 & r2 by starting at c1 moving toward p1 & p2
-	calcTangentPoint(p1e, aWrapResult.r1, p1, m, a, vs, vs4);
-	calcTangentPoint(p2e, aWrapResult.r2, p2, m, a, vs, vs4);
+	// find r1 & r2 by starting at c1 moving toward p1 & p2. If the same path
+	// segment wrapped over the ellipsoid the last time in this state, first
+	// try starting from the tangent points found then. Such a point is kept
+	// only if it converged on c1's side of the line p1->p2, because from the
+	// far side it could settle on the other tangent point.
+	{
+		SimTK::Vec3* r[2] = { &aWrapResult.r1, &aWrapResult.r2 };
+		SimTK::Vec3* p[2] = { &p1, &p2 };
+		double pe[2] = { p1e, p2e };
+		SimTK::Vec3 previousR[2] = { previousWrap.r1, previousWrap.r2 };
+		bool warmStart = get_warm_start()
+			&& previousWrap.wrap_pts.getSize() > 0
+			&& previousWrap.startPoint == aWrapResult.startPoint
+			&& previousWrap.endPoint == aWrapResult.endPoint;
+
+		aWrapResult.iterations = 0;
+		for (i = 0; i < 2; i++)
+		{
+			if (warmStart)
+			{
+				SimTK::Vec3 rw, p1rw, side;
+				rw = _pose.shiftBaseStationToFrame(previousR[i]) * aWrapResult.factor;
+				bool converged = calcTangentPoint(pe[i], rw, *p[i], m, a, vs, vs4, aWrapResult.iterations);
+
+				MAKE_3DVECTOR21(p1, rw, p1rw);
+				Mtx::CrossProduct(p1p2, p1rw, side);
+				if (converged && Mtx::DotProduct(3, vs, side) > 0.0)
+				{
+					*r[i] = rw;
+					continue;
+				}
+			}
+			calcTangentPoint(pe[i], *r[i], *p[i], m, a, vs, vs4, aWrapResult.iterations);
+		}
+	}
 
 	// create a series of line segments connecting r1 & r2 along the
 	// surface of the ellipsoid.
@@ -672,10 +704,11 @@ calc_wrap_path:
  * @param a Ellipsoid axis
  * @param vs Plane vector
  * @param vs4 Plane coefficient
- * @return '1' if the point was adjusted, '0' otherwise
+ * @param rIterations Incremented by the number of iterations taken
+ * @return Whether the point converged
  */
-int WrapEllipsoid::calcTangentPoint(double p1e, SimTK::Vec3& r1, SimTK::Vec3& p1, SimTK::Vec3& m,
-												SimTK::Vec3& a, SimTK::Vec3& vs, double vs4) const
+bool WrapEllipsoid::calcTangentPoint(double p1e, SimTK::Vec3& r1, SimTK::Vec3& p1, SimTK::Vec3& m,
+												SimTK::Vec3& a, SimTK::Vec3& vs, double vs4, int& rIterations) const
 {
 	int i, j, k, nit, nit2, maxit=50, maxit2=1000;
 	Vec3 nr1, p1r1, p1m;
@@ -855,8 +888,12 @@ int WrapEllipsoid::calcTangentPoint(double p1e, SimTK::Vec3& r1, SimTK::Vec3& p1
 			ssq = SQR(ee[0]) + SQR(ee[1]) + SQR(ee[2]) + SQR(ee[3]);
 			ssqo = ssq;	    
 		}
+
+		rIterations += nit;
+		if (ssq > ELLIPSOID_TINY)
+			return false;
 	}   
-	return 1;
+	return true;
 
 }
 
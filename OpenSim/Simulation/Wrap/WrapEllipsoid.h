@@ -99,8 +99,8 @@ protected:
 
 private:
 	void setNull();
-	int calcTangentPoint(double p1e, SimTK::Vec3& r1, SimTK::Vec3& p1, SimTK::Vec3& m,
-												SimTK::Vec3& a, SimTK::Vec3& vs, double vs4) const;
+	bool calcTangentPoint(double p1e, SimTK::Vec3& r1, SimTK::Vec3& p1, SimTK::Vec3& m,
+												SimTK::Vec3& a, SimTK::Vec3& vs, double vs4, int& rIterations) const;
 	void CalcDistanceOnEllipsoid(SimTK::Vec3& r1, SimTK::Vec3& r2, SimTK::Vec3& m, SimTK::Vec3& a, 
 														  SimTK::Vec3& vs, double vs4, bool far_side_wrap,
 														  WrapResult& aWrapResult) const;
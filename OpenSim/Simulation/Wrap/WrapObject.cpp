@@ -141,6 +141,7 @@ void WrapObject::constructProperties()
 	defaultColor[0] = 0.0; 
 
     constructProperty_color(defaultColor);
+    constructProperty_warm_start(true);
 }
 
 //_____________________________________________________________________________
@@ -128,6 +128,12 @@ public:
     OpenSim_DECLARE_LIST_PROPERTY_SIZE(color, double, 3,
         "Display Color");
 
+    /** Whether wrap objects whose tangent points are found iteratively
+    (ellipsoids and tori) start from the solution of the previous wrap in
+    the State. **/
+    OpenSim_DECLARE_PROPERTY(warm_start, bool,
+        "Start the iterative wrapping solver from the previous solution.");
+
     WrapObject();
 	WrapObject(const WrapObject& aWrapObject);
 	virtual ~WrapObject();
@@ -39,7 +39,10 @@ using namespace OpenSim;
 /**
  * Default constructor.
  */
-WrapResult::WrapResult()
+WrapResult::WrapResult() :
+	factor(1.0),
+	params(SimTK::NaN),
+	iterations(0)
 {
 }
 
@@ -59,7 +62,10 @@ WrapResult::~WrapResult()
  */
 void WrapResult::copyData(const WrapResult& aWrapResult)
 {
-	wrap_pts = aWrapResult.wrap_pts;
+	// Copy the points into the storage already held, which only grows.
+	wrap_pts.setSize(aWrapResult.wrap_pts.getSize());
+	for (int j = 0; j < wrap_pts.getSize(); j++)
+		wrap_pts.updElt(j) = aWrapResult.wrap_pts.get(j);
 	wrap_path_length = aWrapResult.wrap_path_length;
 
 	startPoint = aWrapResult.startPoint;
@@ -72,6 +78,10 @@ void WrapResult::copyData(const WrapResult& aWrapResult)
 		c1[i] = aWrapResult.c1[i];
 		sv[i] = aWrapResult.sv[i];
 	}
+
+	factor = aWrapResult.factor;
+	params = aWrapResult.params;
+	iterations = aWrapResult.iterations;
 }
 
 //=============================================================================
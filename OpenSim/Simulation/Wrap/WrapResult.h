@@ -57,6 +57,8 @@ public:
 	SimTK::Vec3 c1;              // intermediate point used by some wrap objects
 	SimTK::Vec3 sv;              // intermediate point used by some wrap objects
 	double factor;             // scale factor used to normalize parameters
+	SimTK::Vec2 params;        // solver parameters used by some wrap objects
+	int iterations;            // iterations taken by iterative wrap objects
 
 //=============================================================================
 // METHODS
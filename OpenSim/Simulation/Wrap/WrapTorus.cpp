@@ -95,6 +95,17 @@ WrapTorus::WrapTorus(const WrapTorus& aWrapTorus) :
  */
 void WrapTorus::setNull()
 {
+	_cylinder.setLength(CYL_LENGTH);
+	_cylinder.setQuadrantName("+x");
+}
+
+//_____________________________________________________________________________
+/**
+ * Give the cylinder used by wrapLine() the inner radius of the torus.
+ */
+void WrapTorus::setupCylinder()
+{
+	_cylinder.setRadius(_innerRadius);
 }
 
 //_____________________________________________________________________________
@@ -144,6 +155,7 @@ void WrapTorus::scale(const SimTK::Vec3& aScaleFactors)
    double averageXYScale = (localScaleVector[0].norm() + localScaleVector[1].norm()) * 0.5;
    _innerRadius *= averageXYScale;
    _outerRadius *= averageXYScale;
+	setupCylinder();
 }
 
 //_____________________________________________________________________________
@@ -175,6 +187,7 @@ void WrapTorus::connectToModelAndBody(Model& aModel, OpenSim::Body& aBody)
 	AnalyticTorus* torus = new AnalyticTorus(_innerRadius, (_outerRadius-_innerRadius));
 	setGeometryQuadrants(torus);
 	_displayer.addGeometry(torus);
+	setupCylinder();
 }
 
 //_____________________________________________________________________________
@@ -190,6 +203,7 @@ void WrapTorus::copyData(const WrapTorus& aWrapTorus)
 
 	_innerRadius = aWrapTorus._innerRadius;
 	_outerRadius = aWrapTorus._outerRadius;
+	setupCylinder();
 }
 
 //_____________________________________________________________________________
@@ -278,17 +292,24 @@ int WrapTorus::wrapLine(const SimTK::State& s, SimTK::Vec3& aPoint1, SimTK::Vec3
 	bool far_side_wrap = false;
 	aFlag = true;
 
-	if (findClosestPoint(_outerRadius, &aPoint1[0], &aPoint2[0], &closestPt[0], &closestPt[1], &closestPt[2], _wrapSign, _wrapAxis) == 0)
+	// Start the searches for the closest point from where they ended the
+	// last time the same path segment wrapped over the torus in this state.
+	const WrapResult& previousWrap = aPathWrap.getPreviousWrap(s);
+	SimTK::Vec2 params(0.0);
+	int iterations = 0;
+	if (get_warm_start() && previousWrap.wrap_pts.getSize() > 0 &&
+		 previousWrap.startPoint == aWrapResult.startPoint &&
+		 previousWrap.endPoint == aWrapResult.endPoint &&
+		 !SimTK::isNaN(previousWrap.params[0]) && !SimTK::isNaN(previousWrap.params[1]))
+		params = previousWrap.params;
+
+	if (findClosestPoint(_outerRadius, &aPoint1[0], &aPoint2[0], &closestPt[0], &closestPt[1], &closestPt[2],
+		 _wrapSign, _wrapAxis, params, iterations) == 0)
 		return noWrap;
 
 	// Now put a cylinder at closestPt and call the cylinder wrap code.
-	WrapCylinder cyl;//(rot, trans, quadrant, body, radius, length);
 	SimTK::Vec3 cylXaxis, cylYaxis, cylZaxis; // cylinder axes in torus reference frame
 
-	cyl.setRadius(_innerRadius);
-	cyl.setLength(CYL_LENGTH);
-	cyl.setQuadrantName("+x");
-
 	closestPt *= -1;
 
 	cylXaxis = closestPt;
@@ -308,7 +329,9 @@ int WrapTorus::wrapLine(const SimTK::State& s, SimTK::Vec3& aPoint1, SimTK::Vec3
 	cylinderToTorus.setP(closestPtCyl);
 	Vec3 p1 = cylinderToTorus.shiftFrameStationToBase(aPoint1);
 	Vec3 p2 = cylinderToTorus.shiftFrameStationToBase(aPoint2);
-	int return_code = cyl.wrapLine(s, p1, p2, aPathWrap, aWrapResult, aFlag);
+	int return_code = _cylinder.wrapLine(s, p1, p2, aPathWrap, aWrapResult, aFlag);
+	aWrapResult.params = params;
+	aWrapResult.iterations = iterations;
    if (aFlag == true && return_code > 0) {
 		aWrapResult.r1 = cylinderToTorus.shiftBaseStationToFrame(aWrapResult.r1);
 		aWrapResult.r2 = cylinderToTorus.shiftBaseStationToFrame(aWrapResult.r2);
@@ -333,11 +356,15 @@ int WrapTorus::wrapLine(const SimTK::State& s, SimTK::Vec3& aPoint1, SimTK::Vec3
  * @param zc The Z coordinate of the closest point
  * @param wrap_sign If wrap is constrained to a quadrant, the sign of the relevant axis
  * @param wrap_axis If wrap is constrained to a quadrant, the relevant axis
+ * @param rParams The distances along the line, from p1 and from p2, at which
+ * to start the two searches; set to the distances found
+ * @param rIterations Incremented by the number of residual evaluations
  * @return '1' if a closest point was found, '0' if there was an error while trying to constrain the wrap
  */
 int WrapTorus::findClosestPoint(double radius, double p1[], double p2[],
 										  double* xc, double* yc, double* zc,
-										  int wrap_sign, int wrap_axis) const
+										  int wrap_sign, int wrap_axis, SimTK::Vec2& rParams,
+										  int& rIterations) const
 {
    int info;                  // output flag
    int num_func_calls;        // number of calls to func (nfev)
@@ -365,14 +392,15 @@ int WrapTorus::findClosestPoint(double radius, double p1[], double p2[],
    cb.p2[2] = p2[2];
    cb.r = radius;
 
-   q[0] = 0.0;
+   q[0] = rParams[0];
 
    lmdif_C(calcCircleResids, numResid, numQs, q, resid,
            ftol, xtol, gtol, max_iter, epsfcn, diag, mode, step_factor,
            nprint, &info, &num_func_calls, fjac, ldfjac, ipvt, qtf,
            wa1, wa2, wa3, wa4, (void*)&cb);
+   rIterations += num_func_calls;
 
-   u = q[0];
+   u = rParams[0] = q[0];
 
    mag = sqrt((p2[0]-p1[0])*(p2[0]-p1[0]) + (p2[1]-p1[1])*(p2[1]-p1[1]) + (p2[2]-p1[2])*(p2[2]-p1[2]));
 
@@ -400,14 +428,15 @@ int WrapTorus::findClosestPoint(double radius, double p1[], double p2[],
    cb.p2[2] = p1[2];
    cb.r = radius;
 
-   q[0] = 0.0;
+   q[0] = rParams[1];
 
    lmdif_C(calcCircleResids, numResid, numQs, q, resid,
            ftol, xtol, gtol, max_iter, epsfcn, diag, mode, step_factor,
            nprint, &info, &num_func_calls, fjac, ldfjac, ipvt, qtf,
            wa1, wa2, wa3, wa4, (void*)&cb);
+   rIterations += num_func_calls;
 
-   u = q[0];
+   u = rParams[1] = q[0];
 
    mag = sqrt((p2[0]-p1[0])*(p2[0]-p1[0]) + (p2[1]-p1[1])*(p2[1]-p1[1]) + (p2[2]-p1[2])*(p2[2]-p1[2]));
 
@@ -32,6 +32,7 @@
 #include <OpenSim/Common/VisibleObject.h>
 #include <OpenSim/Common/PropertyDbl.h>
 #include "WrapObject.h"
+#include "WrapCylinder.h"
 
 namespace OpenSim {
 
@@ -68,6 +69,10 @@ private:
 	PropertyDbl _outerRadiusProp;
 	double& _outerRadius;
 
+	// The cylinder the path is wrapped over at the point of the torus closest
+	// to the path, kept with the torus so that wrapLine() need not make one.
+	WrapCylinder _cylinder;
+
 //=============================================================================
 // METHODS
 //=============================================================================
@@ -99,9 +104,11 @@ protected:
 
 private:
 	void setNull();
+	void setupCylinder();
 	int findClosestPoint(double radius, double p1[], double p2[],
 		double* xc, double* yc, double* zc,
-		int wrap_sign, int wrap_axis) const;
+		int wrap_sign, int wrap_axis, SimTK::Vec2& rParams,
+		int& rIterations) const;
 	static void calcCircleResids(int numResid, int numQs, double q[],
 		double resid[], int *flag2, void *ptr);
 
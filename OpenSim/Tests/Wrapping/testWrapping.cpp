@@ -51,6 +51,7 @@ void simulateModelWithPassiveMuscles(const string &modelFile, double finalTime);
 void simulateModelWithoutMuscles(const string &modelFile, double finalTime);
 void simulateModelWithLigaments(const string &modelFile, double finalTime);
 void simulateModelWithCables(const string &modelFile, double finalTime);
+void benchmarkWrapSolvers(const string &modelFile, int numFrames);
 
 int main()
 {
@@ -62,6 +63,13 @@ int main()
         std::cout << "Exception: " << e.what() << std::endl;
         failures.push_back("TestShoulderModel (multiple wrap)"); }
 
+    try{// iterative ellipsoid and torus wrapping, warm and cold started
+        benchmarkWrapSolvers("TestShoulderModel.osim", 200);
+        benchmarkWrapSolvers("upper_limb.osim", 200);}
+    catch (const std::exception& e) {
+        std::cout << "Exception: " << e.what() << std::endl;
+        failures.push_back("Wrap solver benchmark"); }
+
     if (!failures.empty()) {
         cout << "Done, with failure(s): " << failures << endl;
         return 1;
@@ -528,7 +536,7 @@ void simulateModelWithCables(const string &modelFile, double finalTime)
             }
             else { // next two path points should be a wrap point
                 for (int k = 0; k < wrapSet.getSize(); ++k) {
-                    const Vec3& wrapStartPointLoc = wrapSet[k].getPreviousWrap().r1;
+                    const Vec3& wrapStartPointLoc = wrapSet[k].getPreviousWrap(si).r1;
                     if (!wrapStartPointLoc.isInf() && pp->getLocation().isNumericallyEqual(wrapStartPointLoc)) {
                         ObstacleInfo* obs = wrapObs[k];
                         obs->isActive = true;
@@ -573,7 +581,7 @@ void simulateModelWithCables(const string &modelFile, double finalTime)
 //            cout << "wrap object " << j << " name = " << wrapSet[j].getName() << endl;
 //            cout << "wrap point 0 = " << wrapSet[j].getWrapPoint(0).getLocation() << endl;
 //            cout << "wrap point 1 = " << wrapSet[j].getWrapPoint(1).getLocation() << endl;
-//            const WrapResult& wr = wrapSet[j].getPreviousWrap();
+//            const WrapResult& wr = wrapSet[j].getPreviousWrap(si);
 //            cout << "wrap result r1 = " << wr.r1 << endl;
 //            cout << "wrap result r2 = " << wr.r2 << endl;
 //            cout << "wrap result startpt = " << wr.startPoint << endl;
@@ -775,6 +783,71 @@ void simulateModelWithCables(const string &modelFile, double finalTime)
 
 
 
+// Compute the paths of all the muscles of a model over a smooth sweep of its
+// coordinates, once with the ellipsoid and torus wrap solvers started from
+// their solutions in the previous frame and once from scratch. Report the
+// solver iterations and the wall clock time of each, and check that the
+// lengths agree to within the tolerance of the solvers.
+void benchmarkWrapSolvers(const string &modelFile, int numFrames)
+{
+    Matrix lengths[2];
+    for (int warm = 0; warm < 2; ++warm) {
+        Model model(modelFile);
+        for (int i = 0; i < model.getBodySet().getSize(); ++i) {
+            WrapObjectSet& wraps = model.updBodySet()[i].upd_WrapObjectSet();
+            for (int j = 0; j < wraps.getSize(); ++j)
+                wraps[j].set_warm_start(warm == 1);
+        }
+        State& s = model.initSystem();
+
+        const CoordinateSet& coords = model.getCoordinateSet();
+        const Set<Muscle>& muscles = model.getMuscles();
+        lengths[warm].resize(numFrames, muscles.getSize());
+        long iterations = 0;
+        int numWraps = 0;
+
+        const double start = SimTK::realTime();
+        for (int f = 0; f < numFrames; ++f) {
+            const double phase = 2*SimTK::Pi*f/numFrames;
+            for (int j = 0; j < coords.getSize(); ++j) {
+                const Coordinate& c = coords[j];
+                if (c.getLocked(s)) continue;
+                double range = c.getRangeMax() - c.getRangeMin();
+                double q = c.getDefaultValue() + 0.25*range*std::sin(phase + j);
+                q = std::max(c.getRangeMin(), std::min(c.getRangeMax(), q));
+                c.setValue(s, q, false);
+            }
+            model.getMultibodySystem().realize(s, Stage::Position);
+
+            for (int m = 0; m < muscles.getSize(); ++m) {
+                const GeometryPath& path = muscles[m].getGeometryPath();
+                lengths[warm](f, m) = path.getLength(s);
+                for (int k = 0; k < path.getWrapSet().getSize(); ++k) {
+                    const WrapResult& wrap = 
+                        path.getPreviousWrap(s, path.getWrapSet()[k]);
+                    if (wrap.wrap_pts.getSize() == 0) continue;
+                    iterations += wrap.iterations;
+                    ++numWraps;
+                }
+            }
+        }
+        const double elapsed = SimTK::realTime() - start;
+
+        cout << modelFile << (warm ? " warm" : " cold") << " started: "
+             << numWraps << " wraps, " << iterations << " solver iterations, "
+             << elapsed << " s (wallclock time)" << endl;
+    }
+
+    double maxDiff = 0;
+    for (int f = 0; f < numFrames; ++f)
+        for (int m = 0; m < lengths[0].ncol(); ++m)
+            maxDiff = std::max(maxDiff, 
+                               std::abs(lengths[1](f, m) - lengths[0](f, m)));
+    cout << modelFile << " largest length difference = " << maxDiff << endl;
+    ASSERT(maxDiff < 1.0e-4, __FILE__, __LINE__,
+        "Warm started wrapping changed the muscle lengths.");
+}
+
 void simulate(Model& osimModel, State& si, double initialTime, double finalTime) {
     //  osimModel.printBasicInfo(cout);
 
@@ -613,6 +613,14 @@ void AnalyzeTool::run(SimTK::State& s, Model &aModel, int iInitial, int iFinal,
     SimTK::Vector stateData;
     stateData.resize(numOpenSimStates);
 
+	// Resolve where each column goes in the state once, rather than looking
+	// up every column by name in every frame.
+	// storage labels included time at index 0 so skip it
+	Array<std::string> stateNames;
+	for(int j=1; j<labels.getSize(); ++j) stateNames.append(labels[j]);
+	Model::StateVariableLayout layout =
+		aModel.getStateVariableLayout(s, stateNames);
+
 	for(int i=iInitial;i<=iFinal;i++) {
 		tPrev = t;
 		aStatesStore.getTime(i,s.updTime()); // time
@@ -620,14 +628,9 @@ void AnalyzeTool::run(SimTK::State& s, Model &aModel, int iInitial, int iFinal,
         aModel.setAllControllersEnabled(true);
 
 		aStatesStore.getData(i,numOpenSimStates,&stateData[0]); // states
-		// Get data into local Vector and assign to State using common utility
-		// to handle internal (non-OpenSim) states that may exist
-		Array<std::string> stateNames = aStatesStore.getColumnLabels();
-        for (int j=0; j<stateData.size(); ++j){
-			// storage labels included time at index 0 so +1 to skip
-            aModel.setStateVariable(s, stateNames[j+1], stateData[j]);
-		}
-       
+		// Scatter the row into the State; constraints are enforced below
+		aModel.setStateVariableValues(s, layout, stateData);
+
 		// Adjust configuration to match constraints and other goals
 		aModel.assemble(s);
 
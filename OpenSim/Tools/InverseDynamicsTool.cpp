@@ -26,6 +26,7 @@
 //=============================================================================
 #include "InverseDynamicsTool.h"
 #include <string>
+#include <vector>
 #include <iostream>
 #include <OpenSim/Simulation/Model/Model.h>
 #include <OpenSim/Simulation/SimbodyEngine/Body.h>
@@ -39,11 +40,91 @@
 #include <OpenSim/Common/GCVSplineSet.h>
 #include <OpenSim/Common/Constant.h>
 #include "AnalyzeTool.h"
+#include "SimTKcommon/internal/ParallelExecutor.h"
 
 using namespace OpenSim;
 using namespace std;
 using namespace SimTK;
 
+namespace {
+
+// Frames per thread below which the body forces are computed in sequence.
+const int MIN_FRAMES_PER_CHUNK = 10;
+
+/**
+ * Computes the equivalent body forces at the reported joints for a contiguous
+ * range of frames per chunk, each chunk with its own copy of the State.
+ * Coordinates and speeds come batch-evaluated, nq of each per frame. Results
+ * go into a preallocated Vector of 6 values per joint per frame.
+ */
+class BodyForcesTask : public SimTK::ParallelExecutor::Task {
+public:
+	BodyForcesTask(const State &aState, const vector<double> &aKinematics,
+		int aNumCoordinates, const JointSet &aJoints, const Array_<double> &aTimes,
+		const Array_<Vector> &aGenForceTrajectory, Array_<Vector> &rBodyForces,
+		int aNumChunks) :
+		_state(aState), _kinematics(aKinematics), _nq(aNumCoordinates),
+		_joints(aJoints), _times(aTimes),
+		_genForceTrajectory(aGenForceTrajectory), _bodyForces(rBodyForces),
+		_errors(aNumChunks) {}
+
+	void execute(int aChunk) {
+		int nt = _times.size();
+		int nc = _errors.size();
+		try {
+			State s(_state);
+			for(int i=(aChunk*nt)/nc; i<((aChunk+1)*nt)/nc; i++)
+				calcBodyForces(s, i);
+		}
+		catch(const std::exception &ex) {
+			_errors[aChunk] = ex.what();
+		}
+	}
+
+	/** Body forces of frame i: force then torque components per joint. */
+	void calcBodyForces(State &s, int i) {
+		s.updTime() = _times[i];
+		Vector &q = s.updQ();
+		Vector &u = s.updU();
+		const double *values = &_kinematics[2*i*_nq];
+		for(int j=0; j<_nq; ++j){
+			q[j] = values[j];
+			u[j] = values[_nq+j];
+		}
+
+		Vector &forces = _bodyForces[i];
+		for(int j=0; j<_joints.getSize(); ++j){
+			SpatialVec equivalentBodyForceAtJoint =
+				_joints[j].calcEquivalentSpatialForce(s, _genForceTrajectory[i]);
+			for(int k=0; k<3; ++k){
+				// body force components
+				forces[6*j+k] = equivalentBodyForceAtJoint[1][k];
+				// body torque components
+				forces[6*j+k+3] = equivalentBodyForceAtJoint[0][k];
+			}
+		}
+	}
+
+	/** The first error in any chunk, or an empty string. */
+	string getError() const {
+		for(unsigned int i=0; i<_errors.size(); i++)
+			if(!_errors[i].empty()) return _errors[i];
+		return "";
+	}
+
+private:
+	const State &_state;
+	const vector<double> &_kinematics;
+	int _nq;
+	const JointSet &_joints;
+	const Array_<double> &_times;
+	const Array_<Vector> &_genForceTrajectory;
+	Array_<Vector> &_bodyForces;
+	Array_<string> _errors;
+};
+
+} // namespace
+
 
 //=============================================================================
 // CONSTRUCTOR(S) AND DESTRUCTOR
@@ -67,7 +148,8 @@ InverseDynamicsTool::InverseDynamicsTool() : DynamicsTool(),
 	_lowpassCutoffFrequency(_lowpassCutoffFrequencyProp.getValueDbl()),
 	_outputGenForceFileName(_outputGenForceFileNameProp.getValueStr()),
 	_jointsForReportingBodyForces(_jointsForReportingBodyForcesProp.getValueStrArray()),
-	_outputBodyForcesAtJointsFileName(_outputBodyForcesAtJointsFileNameProp.getValueStr())
+	_outputBodyForcesAtJointsFileName(_outputBodyForcesAtJointsFileNameProp.getValueStr()),
+	_numThreads(_numThreadsProp.getValueInt())
 {
 	setNull();
 }
@@ -86,7 +168,8 @@ InverseDynamicsTool::InverseDynamicsTool(const string &aFileName, bool aLoadMode
 	_lowpassCutoffFrequency(_lowpassCutoffFrequencyProp.getValueDbl()),
 	_outputGenForceFileName(_outputGenForceFileNameProp.getValueStr()),
 	_jointsForReportingBodyForces(_jointsForReportingBodyForcesProp.getValueStrArray()),
-	_outputBodyForcesAtJointsFileName(_outputBodyForcesAtJointsFileNameProp.getValueStr())
+	_outputBodyForcesAtJointsFileName(_outputBodyForcesAtJointsFileNameProp.getValueStr()),
+	_numThreads(_numThreadsProp.getValueInt())
 {
 	setNull();
 	updateFromXMLDocument();
@@ -108,7 +191,8 @@ InverseDynamicsTool::InverseDynamicsTool(const InverseDynamicsTool &aTool) :
 	_lowpassCutoffFrequency(_lowpassCutoffFrequencyProp.getValueDbl()),
 	_outputGenForceFileName(_outputGenForceFileNameProp.getValueStr()),
 	_jointsForReportingBodyForces(_jointsForReportingBodyForcesProp.getValueStrArray()),
-	_outputBodyForcesAtJointsFileName(_outputBodyForcesAtJointsFileNameProp.getValueStr())
+	_outputBodyForcesAtJointsFileName(_outputBodyForcesAtJointsFileNameProp.getValueStr()),
+	_numThreads(_numThreadsProp.getValueInt())
 {
 	setNull();
 	*this = aTool;
@@ -155,6 +239,12 @@ void InverseDynamicsTool::setupProperties()
 	_outputBodyForcesAtJointsFileNameProp.setName("output_body_forces_file");
 	_outputBodyForcesAtJointsFileNameProp.setValue("body_forces_at_joints.sto");
 	_propertySet.append(&_outputBodyForcesAtJointsFileNameProp);
+
+	_numThreadsProp.setComment("Number of threads over which to divide the time frames. "
+		"A value of 1 solves them in sequence; 0 or less uses one thread per processor.");
+	_numThreadsProp.setName("num_threads");
+	_numThreadsProp.setValue(1);
+	_propertySet.append(&_numThreadsProp);
 }
 
 //_____________________________________________________________________________
@@ -186,6 +276,7 @@ operator=(const InverseDynamicsTool &aTool)
 	_lowpassCutoffFrequency = aTool._lowpassCutoffFrequency;
 	_outputGenForceFileName = aTool._outputGenForceFileName;
 	_outputBodyForcesAtJointsFileName = aTool._outputBodyForcesAtJointsFileName;
+	_numThreads = aTool._numThreads;
 	_coordinateValues = NULL;
 
 	return(*this);
@@ -319,6 +410,7 @@ bool InverseDynamicsTool::run()
 
 		// create the solver given the input data
 		InverseDynamicsSolver ivdSolver(*_model);
+		ivdSolver.setNumThreads(_numThreads);
 
 		const clock_t start = clock();
 
@@ -364,37 +456,36 @@ bool InverseDynamicsTool::run()
 
 		Storage genForceResults(nt);
 		Storage bodyForcesResults(nt);
-		SpatialVec equivalentBodyForceAtJoint;
 
 		for(int i=0; i<nt; i++){
 			StateVector genForceVec(times[i], nq, &((genForceTraj[i])[0]));
 			genForceResults.append(genForceVec);
+		}
 
-			// if there are joints requested for equivalent body forces then calculate them
-			if(nj>0){
-				Vector forces(6*nj, 0.0);
-				StateVector bodyForcesVec(times[i], 6*nj, &forces[0]);
-
-				s.updTime() = times[i];
-				Vector &q = s.updQ();
-				Vector &u = s.updU();
+		// if there are joints requested for equivalent body forces then calculate them
+		if(nj>0 && nt>0){
+			Array_<Vector> bodyForcesTraj(nt, Vector(6*nj, 0.0));
+			const int derivOrders[] = {0, 1};
+			vector<double> kinematics(2*nt*nq);
+			coordFunctions->evaluate(nt, &times[0], 2, derivOrders, &kinematics[0]);
+			int numThreads = _numThreads>0 ? _numThreads :
+				SimTK::ParallelExecutor::getNumProcessors();
+			int numChunks = max(1, min(numThreads, nt/MIN_FRAMES_PER_CHUNK));
+			BodyForcesTask task(s, kinematics, nq, jointsForEquivalentBodyForces,
+				times, genForceTraj, bodyForcesTraj, numChunks);
+			if(numChunks <= 1) {
+				task.execute(0);
+			} else {
+				SimTK::ParallelExecutor executor(numChunks);
+				executor.execute(task, numChunks);
+			}
+			string error = task.getError();
+			if(!error.empty())
+				throw Exception("InverseDynamicsTool: "+error, __FILE__, __LINE__);
 
-				for(int j=0; j<nq; ++j){
-					q[j] = coordFunctions->evaluate(j, 0, times[i]);
-					u[j] = coordFunctions->evaluate(j, 1, times[i]);
-				}
-			
-				for(int j=0; j<nj; ++j){
-					equivalentBodyForceAtJoint = jointsForEquivalentBodyForces[j].calcEquivalentSpatialForce(s, genForceTraj[i]);
-					for(int k=0; k<3; ++k){
-						// body force components
-						bodyForcesVec.setDataValue(6*j+k, equivalentBodyForceAtJoint[1][k]); 
-						// body torque components
-						bodyForcesVec.setDataValue(6*j+k+3, equivalentBodyForceAtJoint[0][k]);
-					}
-				}
+			for(int i=0; i<nt; i++){
+				StateVector bodyForcesVec(times[i], 6*nj, &((bodyForcesTraj[i])[0]));
 				bodyForcesResults.append(bodyForcesVec);
-
 			}
 		}
 
@@ -27,6 +27,7 @@
 #include <OpenSim/Common/Object.h>
 #include <OpenSim/Common/PropertyBool.h>
 #include <OpenSim/Common/PropertyDbl.h>
+#include <OpenSim/Common/PropertyInt.h>
 #include <OpenSim/Common/PropertyStr.h>
 #include <OpenSim/Common/PropertyDblArray.h>
 #include "DynamicsTool.h"
@@ -93,6 +94,11 @@ protected:
 	PropertyStr _outputBodyForcesAtJointsFileNameProp;
 	std::string &_outputBodyForcesAtJointsFileName;
 
+	/** Number of threads over which the time frames are divided; 1 solves
+	    them in sequence and 0 or less uses one thread per processor. */
+	PropertyInt _numThreadsProp;
+	int &_numThreads;
+
 //=============================================================================
 // METHODS
 //=============================================================================
@@ -151,6 +157,24 @@ public:
 	void setLowpassCutoffFrequency(double aFrequency) {
 		_lowpassCutoffFrequency = aFrequency;
 	}
+    /**
+     * get/set the joints at which equivalent body forces are reported (the
+     * keyword All reports all joints) and the file they are written to
+     */
+	const Array<std::string>& getJointsForReportingBodyForces() const {
+		return _jointsForReportingBodyForces;
+	}
+	void setJointsForReportingBodyForces(const Array<std::string>& aJointNames) {
+		_jointsForReportingBodyForces = aJointNames;
+	}
+	const std::string& getOutputBodyForcesAtJointsFileName() const {
+		return _outputBodyForcesAtJointsFileName;
+	}
+	void setOutputBodyForcesAtJointsFileName(const std::string& aFileName) {
+		_outputBodyForcesAtJointsFileName = aFileName;
+	}
+	int getNumThreads() const { return _numThreads; };
+	void setNumThreads(int aNumThreads) { _numThreads = aNumThreads; };
 	//--------------------------------------------------------------------------
 	// INTERFACE
 	//--------------------------------------------------------------------------
@@ -46,12 +46,139 @@
 #include "IKMarkerTask.h"
 
 #include "SimTKsimbody.h"
+#include "SimTKcommon/internal/ParallelExecutor.h"
+#include <memory>
 
 
 using namespace OpenSim;
 using namespace std;
 using namespace SimTK;
 
+//=============================================================================
+// CHUNKED TRACKING
+//=============================================================================
+namespace {
+
+// Trials are not split into chunks shorter than this; assembling a chunk's
+// first frame costs several tracked frames.
+const int MIN_FRAMES_PER_CHUNK = 20;
+
+/** What is kept of one tracked frame to be reported in order afterwards. */
+struct IKFrame {
+	Vector q;
+	SimTK::Array_<double> squaredMarkerErrors;
+	SimTK::Array_<Vec3> markerLocations;
+};
+
+/** A contiguous range of frames with the model and solver that track it. */
+struct IKChunk {
+	Model *model;
+	bool ownsModel;
+	SimTK::Array_<CoordinateReference> coordinateReferences;
+	InverseKinematicsSolver *solver;
+	State state;
+	int firstFrame;
+	int numFrames;
+	std::string error;
+
+	IKChunk() : model(NULL), ownsModel(false), solver(NULL),
+		firstFrame(0), numFrames(0) {}
+	~IKChunk() { delete solver; if(ownsModel) delete model; }
+};
+
+/** Record the solution of the chunk's current frame. */
+void recordFrame(IKChunk &aChunk, bool aErrors, bool aLocations, IKFrame &rFrame)
+{
+	rFrame.q = aChunk.state.getQ();
+	if(aErrors)
+		aChunk.solver->computeCurrentSquaredMarkerErrors(rFrame.squaredMarkerErrors);
+	if(aLocations)
+		aChunk.solver->computeCurrentMarkerLocations(rFrame.markerLocations);
+}
+
+/**
+ * Track frames [aFirst, aEnd) of a chunk in sequence, starting from the pose
+ * in the chunk's state.
+ */
+void trackFrames(IKChunk &aChunk, int aFirst, int aEnd, double aStartTime,
+	double aDt, bool aErrors, bool aLocations, vector<IKFrame> &rFrames)
+{
+	for(int i=aFirst; i<aEnd; i++) {
+		aChunk.state.updTime() = aStartTime + i*aDt;
+		aChunk.solver->track(aChunk.state);
+		recordFrame(aChunk, aErrors, aLocations, rFrames[i]);
+	}
+}
+
+/**
+ * Tracks each chunk independently: its first frame is assembled from the
+ * seed pose, the rest are tracked from the frame before, as in a sequential
+ * run. Chunks do not share anything that is written, so they can be executed
+ * on separate threads.
+ */
+class TrackChunkTask : public SimTK::ParallelExecutor::Task {
+public:
+	TrackChunkTask(vector< unique_ptr<IKChunk> > &aChunks, const Vector &aSeed,
+		double aStartTime, double aDt, bool aErrors, bool aLocations,
+		vector<IKFrame> &rFrames) :
+		_chunks(aChunks), _seed(aSeed), _startTime(aStartTime), _dt(aDt),
+		_errors(aErrors), _locations(aLocations), _frames(rFrames) {}
+
+	void execute(int aChunk) {
+		IKChunk &chunk = *_chunks[aChunk];
+		try {
+			chunk.state.updQ() = _seed;
+			chunk.state.updTime() = _startTime + chunk.firstFrame*_dt;
+			chunk.solver->assemble(chunk.state);
+			trackFrames(chunk, chunk.firstFrame, chunk.firstFrame+chunk.numFrames,
+				_startTime, _dt, _errors, _locations, _frames);
+		}
+		catch(const std::exception &ex) {
+			chunk.error = ex.what();
+		}
+	}
+
+private:
+	vector< unique_ptr<IKChunk> > &_chunks;
+	const Vector &_seed;
+	double _startTime;
+	double _dt;
+	bool _errors;
+	bool _locations;
+	vector<IKFrame> &_frames;
+};
+
+/**
+ * Make the chunks agree with a sequential run. In order, each chunk's first
+ * frame is tracked again from the last pose of the chunk before it; if that
+ * pose differs from the one assembled from the seed by more than the solver
+ * accuracy, the whole chunk is tracked again from there, as it would have
+ * been in sequence. Returns the number of chunks tracked again.
+ */
+int joinChunks(vector< unique_ptr<IKChunk> > &aChunks, double aStartTime, double aDt,
+	double aAccuracy, bool aErrors, bool aLocations, vector<IKFrame> &rFrames)
+{
+	int numRetracked = 0;
+	IKFrame first;
+	for(unsigned int k=1; k<aChunks.size(); k++) {
+		IKChunk &chunk = *aChunks[k];
+		int i = chunk.firstFrame;
+		chunk.state.updQ() = rFrames[i-1].q;
+		chunk.state.updTime() = aStartTime + i*aDt;
+		chunk.solver->track(chunk.state);
+		recordFrame(chunk, aErrors, aLocations, first);
+		if(max(abs(first.q - rFrames[i].q)) <= aAccuracy)
+			continue;
+		rFrames[i] = first;
+		trackFrames(chunk, i+1, i+chunk.numFrames, aStartTime, aDt,
+			aErrors, aLocations, rFrames);
+		numRetracked++;
+	}
+	return numRetracked;
+}
+
+} // namespace
+
 //=============================================================================
 // CONSTRUCTOR(S) AND DESTRUCTOR
 //=============================================================================
@@ -77,7 +204,9 @@ InverseKinematicsTool::InverseKinematicsTool() : Tool(),
 	_timeRange(_timeRangeProp.getValueDblArray()),
 	_reportErrors(_reportErrorsProp.getValueBool()),
 	_outputMotionFileName(_outputMotionFileNameProp.getValueStr()),
-	_reportMarkerLocations(_reportMarkerLocationsProp.getValueBool())
+	_reportMarkerLocations(_reportMarkerLocationsProp.getValueBool()),
+	_numThreads(_numThreadsProp.getValueInt()),
+	_useLeastSquaresTracking(_useLeastSquaresTrackingProp.getValueBool())
 {
 	setNull();
 }
@@ -102,7 +231,9 @@ InverseKinematicsTool::InverseKinematicsTool(const string &aFileName, bool aLoad
 	_timeRange(_timeRangeProp.getValueDblArray()),
 	_reportErrors(_reportErrorsProp.getValueBool()),
 	_outputMotionFileName(_outputMotionFileNameProp.getValueStr()),
-	_reportMarkerLocations(_reportMarkerLocationsProp.getValueBool())
+	_reportMarkerLocations(_reportMarkerLocationsProp.getValueBool()),
+	_numThreads(_numThreadsProp.getValueInt()),
+	_useLeastSquaresTracking(_useLeastSquaresTrackingProp.getValueBool())
 {
 	setNull();
 	updateFromXMLDocument();
@@ -130,7 +261,9 @@ InverseKinematicsTool::InverseKinematicsTool(const InverseKinematicsTool &aTool)
 	_timeRange(_timeRangeProp.getValueDblArray()),
 	_reportErrors(_reportErrorsProp.getValueBool()),
 	_outputMotionFileName(_outputMotionFileNameProp.getValueStr()),
-	_reportMarkerLocations(_reportMarkerLocationsProp.getValueBool())
+	_reportMarkerLocations(_reportMarkerLocationsProp.getValueBool()),
+	_numThreads(_numThreadsProp.getValueInt()),
+	_useLeastSquaresTracking(_useLeastSquaresTrackingProp.getValueBool())
 {
 	setNull();
 	*this = aTool;
@@ -202,6 +335,20 @@ void InverseKinematicsTool::setupProperties()
 	_reportMarkerLocationsProp.setValue(false);
 	_propertySet.append(&_reportMarkerLocationsProp);
 
+	_numThreadsProp.setComment("Number of threads over which to divide the frames. Each thread tracks "
+		"a contiguous chunk of frames with its own copy of the model. A value of 1 tracks all frames "
+		"in sequence; 0 or less uses one thread per processor.");
+	_numThreadsProp.setName("num_threads");
+	_numThreadsProp.setValue(1);
+	_propertySet.append(&_numThreadsProp);
+
+	_useLeastSquaresTrackingProp.setComment("Flag (true or false) indicating whether to track frames with a "
+		"dedicated Gauss-Newton solver using analytic marker Jacobians. It applies to models without "
+		"constraints other than locked coordinates; others are tracked with the general assembler.");
+	_useLeastSquaresTrackingProp.setName("use_least_squares_tracking");
+	_useLeastSquaresTrackingProp.setValue(false);
+	_propertySet.append(&_useLeastSquaresTrackingProp);
+
 }
 
 //_____________________________________________________________________________
@@ -239,6 +386,8 @@ operator=(const InverseKinematicsTool &aTool)
 	_reportErrors = aTool._reportErrors;
 	_outputMotionFileName = aTool._outputMotionFileName;
 	_reportMarkerLocations = aTool._reportMarkerLocations;
+	_numThreads = aTool._numThreads;
+	_useLeastSquaresTracking = aTool._useLeastSquaresTracking;
 
 	return(*this);
 }
@@ -268,7 +417,6 @@ bool InverseKinematicsTool::run()
 
 		_model->printBasicInfo(cout);
 
-
 		// Do the maneuver to change then restore working directory 
 		// so that the parsing code behaves properly if called from a different directory.
 		string saveWorkingDirectory = IO::getCwd();
@@ -357,6 +505,7 @@ bool InverseKinematicsTool::run()
 		// create the solver given the input data
 		InverseKinematicsSolver ikSolver(*_model, markersReference, coordinateReferences, _constraintWeight);
 		ikSolver.setAccuracy(_accuracy);
+		ikSolver.setUseLeastSquaresTracking(_useLeastSquaresTracking);
 		s.updTime() = start_time;
 		ikSolver.assemble(s);
 		kinematicsReporter.begin(s);
@@ -373,16 +522,78 @@ bool InverseKinematicsTool::run()
 		
 		Storage *modelMarkerLocations = _reportMarkerLocations ? new Storage(Nframes, "ModelMarkerLocations") : NULL;
 
+		// Track contiguous chunks of frames in parallel, one per thread, then
+		// report the frames in order below as if they had been tracked here.
+		int numThreads = _numThreads>0 ? _numThreads :
+			SimTK::ParallelExecutor::getNumProcessors();
+		int numChunks = min(numThreads, Nframes/MIN_FRAMES_PER_CHUNK);
+		vector<IKFrame> frames;
+		if(numChunks > 1) {
+			frames.resize(Nframes);
+			vector< unique_ptr<IKChunk> > chunks(numChunks);
+			for(int k=0; k<numChunks; k++) {
+				chunks[k].reset(new IKChunk());
+				IKChunk *chunk = chunks[k].get();
+				chunk->firstFrame = (k*Nframes)/numChunks;
+				chunk->numFrames = ((k+1)*Nframes)/numChunks - chunk->firstFrame;
+				if(k == 0) {
+					chunk->model = _model;
+					chunk->solver = new InverseKinematicsSolver(*_model, markersReference,
+						coordinateReferences, _constraintWeight);
+					chunk->state = s;
+				}
+				else {
+					// A copy of the model does not carry its analyses, so
+					// the reporter stays with the model of the first chunk.
+					chunk->model = new Model(*_model);
+					chunk->ownsModel = true;
+					chunk->state = chunk->model->initSystem();
+					chunk->coordinateReferences = coordinateReferences;
+					chunk->solver = new InverseKinematicsSolver(*chunk->model, markersReference,
+						chunk->coordinateReferences, _constraintWeight);
+				}
+				chunk->solver->setAccuracy(_accuracy);
+				chunk->solver->setUseLeastSquaresTracking(_useLeastSquaresTracking);
+			}
+
+			TrackChunkTask task(chunks, s.getQ(), start_time, dt,
+				_reportErrors, _reportMarkerLocations, frames);
+			SimTK::ParallelExecutor executor(numChunks);
+			executor.execute(task, numChunks);
+
+			string error;
+			for(int k=0; k<numChunks && error.empty(); k++)
+				error = chunks[k]->error;
+			int numRetracked = error.empty() ? joinChunks(chunks, start_time, dt,
+				_accuracy, _reportErrors, _reportMarkerLocations, frames) : 0;
+			if(!error.empty())
+				throw Exception("InverseKinematicsTool: "+error, __FILE__, __LINE__);
+
+			cout << "InverseKinematicsTool tracked " << Nframes << " frames in " << numChunks
+				<< " chunks; " << numRetracked << " chunk(s) tracked again to join the previous one." << endl;
+		}
+
 		for (int i = 0; i < Nframes; i++) {
 			s.updTime() = start_time + i*dt;
-			ikSolver.track(s);
+			if(frames.empty()) {
+				ikSolver.track(s);
+				if(_reportErrors)
+					ikSolver.computeCurrentSquaredMarkerErrors(squaredMarkerErrors);
+				if(_reportMarkerLocations)
+					ikSolver.computeCurrentMarkerLocations(markerLocations);
+			}
+			else {
+				s.updQ() = frames[i].q;
+				_model->getMultibodySystem().realize(s, SimTK::Stage::Velocity);
+				squaredMarkerErrors = frames[i].squaredMarkerErrors;
+				markerLocations = frames[i].markerLocations;
+			}
 			
 			if(_reportErrors){
 				double totalSquaredMarkerError = 0.0;
 				double maxSquaredMarkerError = 0.0;
 				int worst = -1;
 
-				ikSolver.computeCurrentSquaredMarkerErrors(squaredMarkerErrors);
 				for(int j=0; j<nm; ++j){
 					totalSquaredMarkerError += squaredMarkerErrors[j];
 					if(squaredMarkerErrors[j] > maxSquaredMarkerError){
@@ -397,7 +608,6 @@ bool InverseKinematicsTool::run()
 			}
 
 			if(_reportMarkerLocations){
-				ikSolver.computeCurrentMarkerLocations(markerLocations);
 				Array<double> locations(0.0, 3*nm);
 				for(int j=0; j<nm; ++j){
 					for(int k=0; k<3; ++k)
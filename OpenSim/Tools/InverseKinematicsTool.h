@@ -27,6 +27,7 @@
 #include <OpenSim/Common/Object.h>
 #include <OpenSim/Common/PropertyBool.h>
 #include <OpenSim/Common/PropertyDbl.h>
+#include <OpenSim/Common/PropertyInt.h>
 #include <OpenSim/Common/PropertyStr.h>
 #include <OpenSim/Common/PropertyDblArray.h>
 #include "Tool.h"
@@ -108,6 +109,16 @@ private:
 	PropertyBool _reportMarkerLocationsProp;
 	bool &_reportMarkerLocations;
 
+	// number of threads over which to divide the frames; 1 tracks them in
+	// sequence and 0 or less uses one thread per processor
+	PropertyInt _numThreadsProp;
+	int &_numThreads;
+
+	// flag to track frames with the dedicated least-squares solver of
+	// InverseKinematicsSolver instead of the general assembler
+	PropertyBool _useLeastSquaresTrackingProp;
+	bool &_useLeastSquaresTracking;
+
 //=============================================================================
 // METHODS
 //=============================================================================
@@ -138,6 +149,12 @@ public:
 
 	void setCoordinateFileName(const std::string& coordDataFileName) { _coordinateFileName=coordDataFileName;};
 	const std::string& getCoordinateFileName() const { return  _coordinateFileName;};
+
+	void setNumThreads(int aNumThreads) { _numThreads = aNumThreads; };
+	int getNumThreads() const { return _numThreads; };
+
+	void setUseLeastSquaresTracking(bool aUseLeastSquares) { _useLeastSquaresTracking = aUseLeastSquares; };
+	bool getUseLeastSquaresTracking() const { return _useLeastSquaresTracking; };
     
 	//const OpenSim::Storage& getOutputStorage() const;
 private: